@@ -0,0 +1,2 @@
+#include <lzma.h>
+int main () { return !lzma_version_number (); }
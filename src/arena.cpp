@@ -1,15 +1,32 @@
 #include "internal.hpp"
 
+#ifdef COMPACT
+#include <atomic>
+#include <mutex>
+#include <sys/mman.h>
+#endif
+
 namespace CaDiCaL {
 
-Arena::Arena (Internal *i) {
-  memset (this, 0, sizeof *this);
-  internal = i;
+#ifdef COMPACT
+static void adopt_free_lists (Arena::FreeLists &);
+static void orphan_free_lists (Arena::FreeLists &);
+#endif
+
+Arena::Arena (Internal *i) : internal (i) {
+  memset (&from, 0, sizeof from);
+  memset (&to, 0, sizeof to);
+#ifdef COMPACT
+  adopt_free_lists (free_lists);
+#endif
 }
 
 Arena::~Arena () {
   delete[] from.start;
   delete[] to.start;
+#ifdef COMPACT
+  orphan_free_lists (free_lists);
+#endif
 }
 
 void Arena::prepare (size_t bytes) {
@@ -17,6 +34,7 @@ void Arena::prepare (size_t bytes) {
   assert (!to.start);
   to.top = to.start = new char[bytes];
   to.end = to.start + bytes;
+  internal->advise (to.start, bytes);
 }
 
 void Arena::swap () {
@@ -27,4 +45,83 @@ void Arena::swap () {
   to.start = to.top = to.end = 0;
 }
 
+/*------------------------------------------------------------------------*/
+#ifdef COMPACT
+
+char *Arena::heap;
+
+static const size_t small_units = 1024;
+
+static std::once_flag heap_reserved;
+static std::atomic<size_t> heap_top (8); // Reference 0 is never allocated.
+
+static std::mutex orphans_lock;
+static std::vector<Arena::FreeLists> orphans; // Of deleted solvers.
+
+static void reserve_heap () {
+  std::call_once (heap_reserved, [] () {
+    void *p = mmap (0, Arena::heap_bytes, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (p == MAP_FAILED)
+      throw std::bad_alloc ();
+    Arena::heap = (char *) p;
+  });
+}
+
+static void adopt_free_lists (Arena::FreeLists &free_lists) {
+  std::lock_guard<std::mutex> guard (orphans_lock);
+  if (orphans.empty ())
+    return;
+  free_lists = std::move (orphans.back ());
+  orphans.pop_back ();
+}
+
+static void orphan_free_lists (Arena::FreeLists &free_lists) {
+  if (free_lists.small.empty () && free_lists.large.empty ())
+    return;
+  std::lock_guard<std::mutex> guard (orphans_lock);
+  orphans.push_back (std::move (free_lists));
+}
+
+uint32_t &Arena::free_list (size_t units) {
+  if (units < small_units) {
+    if (free_lists.small.empty ())
+      free_lists.small.resize (small_units);
+    return free_lists.small[units];
+  }
+  return free_lists.large[units];
+}
+
+char *Arena::allocate (size_t bytes) {
+  const size_t units = (bytes + 7) >> 3;
+  reserve_heap ();
+  uint32_t &head = free_list (units);
+  if (head) {
+    char *res = dereference (head);
+    head = *(uint32_t *) res;
+    return res;
+  }
+  const size_t top = heap_top.fetch_add (units << 3);
+  if (top + (units << 3) > heap_bytes)
+    throw std::bad_alloc ();
+  return heap + top;
+}
+
+void Arena::release (char *p, size_t bytes) {
+  const size_t units = (bytes + 7) >> 3;
+  uint32_t &head = free_list (units);
+  *(uint32_t *) p = head;
+  head = reference (p);
+}
+
+// Advising the whole region before it is used applies to all its pages.
+// As the heap is shared by all solvers it is not bound to a NUMA node.
+
+void Arena::advise_heap () {
+  reserve_heap ();
+  advise_memory (heap, heap_bytes, true, false);
+}
+
+#endif
+
 } // namespace CaDiCaL
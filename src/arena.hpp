@@ -1,6 +1,12 @@
 #ifndef _arena_hpp_INCLUDED
 #define _arena_hpp_INCLUDED
 
+#ifdef COMPACT
+#include <cstdint>
+#include <map>
+#include <vector>
+#endif
+
 namespace CaDiCaL {
 
 // This memory allocation arena provides fixed size pre-allocated memory for
@@ -51,6 +57,18 @@ namespace CaDiCaL {
 //
 // One has to be really careful with 'qi' references to arena memory.
 
+// If compiled with '-DCOMPACT' (see '--compact' of 'configure') all clauses
+// are allocated in one clause heap instead, which is a single region of
+// virtual memory reserved once per process.  Clauses are then referenced
+// in watches by 32-bit offsets into this region (in units of 8 bytes),
+// which halves the size of watches (see 'watch.hpp').  Deleted clauses are
+// put on free lists of their solver by their size and reused by new
+// clauses of the same size.  Thus only taking fresh memory from the heap
+// is shared between solvers (and done without locking).  The free lists of
+// a deleted solver are handed over to the next new solver.  As references
+// have to stay valid, the moving garbage collector above is not used in
+// this configuration.
+
 struct Internal;
 
 class Arena {
@@ -97,6 +115,46 @@ public:
   // explicitly copied to 'to' with 'copy' becomes invalid.
   //
   void swap ();
+
+#ifdef COMPACT
+  // Free blocks are linked through their first word (by reference) and
+  // kept in lists by their size in units of 8 bytes.  Sizes up to
+  // 'small_units' cover almost all clauses and have their list in a
+  // vector.
+  //
+  struct FreeLists {
+    std::vector<uint32_t> small;
+    std::map<size_t, uint32_t> large;
+  };
+
+private:
+  FreeLists free_lists;
+  uint32_t &free_list (size_t units);
+
+public:
+  // The clause heap shared by all solvers of the process.  The size of the
+  // reserved region is limited by the 31 bits of a reference (the last bit
+  // of a watch reference is the binary flag).
+  //
+  static const size_t heap_bytes = (size_t) 1 << 34;
+
+  static char *heap;
+
+  char *allocate (size_t bytes);
+  void release (char *p, size_t bytes);
+  static void advise_heap (); // Huge pages (see 'opts.hugepages').
+
+  static uint32_t reference (const void *p) {
+    const char *c = (const char *) p;
+    assert (heap <= c && c < heap + heap_bytes);
+    assert (!((c - heap) & 7));
+    return (c - heap) >> 3;
+  }
+
+  static char *dereference (uint32_t ref) {
+    return heap + ((size_t) ref << 3);
+  }
+#endif
 };
 
 } // namespace CaDiCaL
@@ -3,6 +3,11 @@
 // Do include 'internal.hpp' but try to minimize internal dependencies.
 
 #include "internal.hpp"
+#include "sha256/cache_file.hpp"
+#include "sha256/callback_trace.hpp"
+#include "sha256/kernel_trace.hpp"
+#include "sha256/generate.hpp"
+#include "sha256/shared_cache.hpp"
 #include "sha256/sha256.hpp"
 #include "signal.hpp" // Separate, only need for apps.
 
@@ -25,6 +30,7 @@ namespace CaDiCaL {
 class App : public Handler, public Terminator {
 
   Solver *solver; // Global solver.
+  SHA256::Propagator *propagator;
 
 #ifndef __WIN32
   // Command line options.
@@ -44,6 +50,7 @@ class App : public Handler, public Terminator {
   int force_strict_parsing;
 
   bool force_writing;
+  FILE *report_json_file; // '--report-json-fd=<fd>'
   static bool most_likely_existing_cnf_file (const char *path);
 
   // Internal variables.
@@ -147,6 +154,43 @@ void App::print_usage (bool all) {
         "\n"
         "  -o <output>    write simplified CNF in DIMACS format to file\n"
         "  -e <extend>    write reconstruction/extension stack to file\n"
+        "\n"
+        "  --sha256-generate=<steps>,<encoding>[,<characteristic>]\n"
+        "                 generate the SHA-256 encoding instead of "
+        "reading DIMACS\n"
+        "                 (a single file argument is then '<proof>')\n"
+        "  --sha256-cache=<path>\n"
+        "                 load the SHA-256 rule caches from the file and "
+        "save them at exit\n"
+        "  --sha256-shm-cache=<name>\n"
+        "                 share SHA-256 rules with the processes using the "
+        "same\n"
+        "                 POSIX shared memory object (remove it from "
+        "'/dev/shm')\n"
+        "  --sha256-record-kernels=<path>\n"
+        "                 record the calls to the SHA-256 propagation "
+        "kernels\n"
+        "                 for 'sha256-bench'\n"
+        "  --sha256-record-callbacks=<path>\n"
+        "                 record the callbacks to the SHA-256 propagator "
+        "for\n"
+        "                 'sha256-replay'\n"
+        "\n"
+        "  --checkpoint=<path>\n"
+        "                 periodically write the search state to the file "
+        "(and\n"
+        "                 the SHA-256 rule caches to '<path>.rules' "
+        "by default)\n"
+        "  --checkpoint-interval=<conflicts>\n"
+        "                 conflicts between checkpoints (default 1e5)\n"
+        "  --resume       resume from the checkpoint if it exists\n"
+        "\n"
+        "  --report-json=<path>\n"
+        "                 write a JSON line with search and SHA-256 "
+        "statistics\n"
+        "                 for each report line to the file\n"
+        "  --report-json-fd=<fd>\n"
+        "                 write these JSON lines to the file descriptor\n"
 #ifdef LOGGING
         "  -l             enable logging messages (same as '--log')\n"
 #endif
@@ -242,14 +286,14 @@ void App::print_usage (bool all) {
         "to  '<stdout>' and '<stdout>' is connected to a terminal.\n"
         "\n"
         "The input is assumed to be compressed if it is given explicitly\n"
-        "and has a '.gz', '.bz2', '.xz' or '.7z' suffix.  The same "
-        "applies\n"
-        "to the output file.  In order to use compression and "
-        "decompression\n"
-        "the corresponding utilities 'gzip', 'bzip', 'xz', and '7z' "
-        "(depending\n"
-        "on the format) are required and need to be installed on the "
-        "system.\n"
+        "and has a '.gz', '.bz2', '.xz', '.zst' or '.7z' suffix.  The "
+        "same\n"
+        "applies to the output file.  In order to use compression and\n"
+        "decompression the corresponding utilities 'gzip', 'bzip', 'xz',\n"
+        "'zstd' and '7z' (depending on the format) are required and need "
+        "to\n"
+        "be installed on the system, unless the solver was compiled with\n"
+        "'zlib', 'liblzma' or 'zstd', which then decompress the input.\n"
         "The solver checks file type signatures though and falls back to\n"
         "non-compressed file reading if the signature does not match.\n",
         stdout);
@@ -307,6 +351,8 @@ bool App::most_likely_existing_cnf_file (const char *path) {
     return true;
   if (has_suffix (path, ".dimacs.lzma"))
     return true;
+  if (has_suffix (path, ".dimacs.zst"))
+    return true;
 
   if (has_suffix (path, ".cnf"))
     return true;
@@ -320,6 +366,8 @@ bool App::most_likely_existing_cnf_file (const char *path) {
     return true;
   if (has_suffix (path, ".cnf.lzma"))
     return true;
+  if (has_suffix (path, ".cnf.zst"))
+    return true;
 
   return false;
 }
@@ -376,6 +424,13 @@ int App::main (int argc, char **argv) {
   const char *conflict_limit_specified = 0;
   const char *decision_limit_specified = 0;
   const char *localsearch_specified = 0;
+  const char *sha256_generate = 0, *sha256_cache = 0;
+  const char *sha256_shm_cache = 0, *sha256_record_kernels = 0;
+  const char *sha256_record_callbacks = 0;
+  const char *checkpoint_path = 0;
+  bool resume = false;
+  const char *report_json_path = 0;
+  int report_json_fd = -1;
 #ifndef __MINGW32__
   const char *time_limit_specified = 0;
 #endif
@@ -544,6 +599,72 @@ int App::main (int argc, char **argv) {
       if (localsearch < 0)
         APPERR ("invalid argument in '%s' (expected non-negative number)",
                 argv[i]);
+    } else if (has_prefix (argv[i], "--sha256-generate=")) {
+      if (sha256_generate)
+        APPERR ("multiple generation options '%s' and '%s'",
+                sha256_generate, argv[i]);
+      sha256_generate = argv[i];
+    } else if (has_prefix (argv[i], "--sha256-cache=")) {
+      if (sha256_cache)
+        APPERR ("multiple rule cache options '%s' and '%s'", sha256_cache,
+                argv[i]);
+      sha256_cache = argv[i] + strlen ("--sha256-cache=");
+      if (!*sha256_cache)
+        APPERR ("missing path in '%s'", argv[i]);
+    } else if (has_prefix (argv[i], "--sha256-shm-cache=")) {
+      if (sha256_shm_cache)
+        APPERR ("multiple shared cache options '%s' and '%s'",
+                sha256_shm_cache, argv[i]);
+      sha256_shm_cache = argv[i] + strlen ("--sha256-shm-cache=");
+      if (!*sha256_shm_cache)
+        APPERR ("missing name in '%s'", argv[i]);
+    } else if (has_prefix (argv[i], "--sha256-record-kernels=")) {
+      if (sha256_record_kernels)
+        APPERR ("multiple kernel recording options '%s' and '%s'",
+                sha256_record_kernels, argv[i]);
+      sha256_record_kernels =
+          argv[i] + strlen ("--sha256-record-kernels=");
+      if (!*sha256_record_kernels)
+        APPERR ("missing path in '%s'", argv[i]);
+    } else if (has_prefix (argv[i], "--sha256-record-callbacks=")) {
+      if (sha256_record_callbacks)
+        APPERR ("multiple callback recording options '%s' and '%s'",
+                sha256_record_callbacks, argv[i]);
+      sha256_record_callbacks =
+          argv[i] + strlen ("--sha256-record-callbacks=");
+      if (!*sha256_record_callbacks)
+        APPERR ("missing path in '%s'", argv[i]);
+    } else if (has_prefix (argv[i], "--checkpoint=")) {
+      if (checkpoint_path)
+        APPERR ("multiple checkpoint options '%s' and '%s'",
+                checkpoint_path, argv[i]);
+      checkpoint_path = argv[i] + strlen ("--checkpoint=");
+      if (!*checkpoint_path)
+        APPERR ("missing path in '%s'", argv[i]);
+    } else if (has_prefix (argv[i], "--checkpoint-interval=")) {
+      int interval;
+      if (!parse_int_str (argv[i] + strlen ("--checkpoint-interval="),
+                          interval) ||
+          interval < 1)
+        APPERR ("invalid argument in '%s' (expected positive number)",
+                argv[i]);
+      set ("checkpointint", interval);
+    } else if (!strcmp (argv[i], "--resume")) {
+      resume = true;
+    } else if (has_prefix (argv[i], "--report-json=")) {
+      if (report_json_path || report_json_fd >= 0)
+        APPERR ("multiple JSON report options");
+      report_json_path = argv[i] + strlen ("--report-json=");
+      if (!*report_json_path)
+        APPERR ("missing path in '%s'", argv[i]);
+    } else if (has_prefix (argv[i], "--report-json-fd=")) {
+      if (report_json_path || report_json_fd >= 0)
+        APPERR ("multiple JSON report options");
+      if (!parse_int_str (argv[i] + strlen ("--report-json-fd="),
+                          report_json_fd) ||
+          report_json_fd < 0)
+        APPERR ("invalid argument in '%s' (expected file descriptor)",
+                argv[i]);
     } else if (has_prefix (argv[i], "--") &&
                solver->is_valid_configuration (argv[i] + 2)) {
       solver->configure (argv[i] + 2);
@@ -567,14 +688,47 @@ int App::main (int argc, char **argv) {
 
   /*----------------------------------------------------------------------*/
 
+  // Without DIMACS input the only file argument is the proof.
+  if (sha256_generate && dimacs_specified && !proof_specified) {
+    proof_path = dimacs_path, proof_specified = true;
+    dimacs_path = 0, dimacs_specified = false;
+    if (proof_path && !force_writing &&
+        most_likely_existing_cnf_file (proof_path))
+      APPERR ("DRAT proof file '%s' most likely existing CNF (use '-f')",
+              proof_path);
+    else if (proof_path && !File::writable (proof_path))
+      APPERR ("DRAT proof file '%s' not writable", proof_path);
+  }
   if (dimacs_specified && dimacs_path && !File::exists (dimacs_path))
     APPERR ("DIMACS input file '%s' does not exist", dimacs_path);
+  if (sha256_generate && dimacs_specified)
+    APPERR ("can not combine '%s' with DIMACS input", sha256_generate);
   if (read_solution_path && !File::exists (read_solution_path))
     APPERR ("solution file '%s' does not exist", read_solution_path);
   if (dimacs_specified && dimacs_path && proof_specified && proof_path &&
       !strcmp (dimacs_path, proof_path) && strcmp (dimacs_path, "-"))
     APPERR ("DIMACS input file '%s' also specified as DRAT proof file",
             dimacs_path);
+  if (resume && !checkpoint_path)
+    APPERR ("'--resume' requires '--checkpoint'");
+  // Restored clauses would be traced as original clauses
+  if (resume && proof_specified)
+    APPERR ("can not combine '--resume' with writing a proof");
+  if (report_json_path && !solver->report_json (report_json_path))
+    APPERR ("can not write JSON reports to '%s'", report_json_path);
+  if (report_json_fd >= 0) {
+    report_json_file = fdopen (report_json_fd, "w");
+    if (!report_json_file)
+      APPERR ("can not write JSON reports to file descriptor %d",
+              report_json_fd);
+    solver->report_json (report_json_file);
+  }
+  string checkpoint_rules;
+  if (checkpoint_path && !sha256_cache) {
+    checkpoint_rules = checkpoint_path;
+    checkpoint_rules += ".rules";
+    sha256_cache = checkpoint_rules.c_str ();
+  }
 
   /*----------------------------------------------------------------------*/
   // The '--less' option is not fully functional yet (it is also not
@@ -674,27 +828,62 @@ int App::main (int argc, char **argv) {
                        tout.green_code (), proof_path, tout.normal_code ());
   } else
     solver->verbose (1, "will not generate nor write DRAT proof");
-  solver->section ("parsing input");
-  dimacs_name = dimacs_path ? dimacs_path : "<stdin>";
-  string help;
-  if (!dimacs_path) {
-    help += " ";
-    help += tout.magenta_code ();
-    help += "(use '-h' for a list of common options)";
-    help += tout.normal_code ();
+
+  // The random decisions of the propagator follow the seed of the solver
+  SHA256::branch_random = get ("seed");
+
+  // The recorder has to be connected before the variables are observed
+  FILE *callback_trace_file = 0;
+  SHA256::CallbackRecorder *callback_recorder = 0;
+  if (sha256_record_callbacks) {
+    solver->section ("recording callbacks");
+    callback_trace_file = fopen (sha256_record_callbacks, "w");
+    if (!callback_trace_file)
+      APPERR ("can not write callbacks to '%s'", sha256_record_callbacks);
+    callback_recorder =
+        new SHA256::CallbackRecorder (propagator, callback_trace_file,
+                                      get ("seed"));
+    solver->connect_external_propagator (callback_recorder);
+    solver->message ("recording callbacks to %s'%s'%s",
+                     tout.green_code (), sha256_record_callbacks,
+                     tout.normal_code ());
   }
-  solver->message ("reading DIMACS file from %s'%s'%s%s",
-                   tout.green_code (), dimacs_name, tout.normal_code (),
-                   help.c_str ());
+
+  solver->section ("parsing input");
   bool incremental;
   vector<int> cube_literals;
-  if (dimacs_path)
-    err = solver->read_dimacs (dimacs_path, max_var, force_strict_parsing,
-                               incremental, cube_literals);
-  else
-    err = solver->read_dimacs (stdin, dimacs_name, max_var,
-                               force_strict_parsing, incremental,
-                               cube_literals);
+  if (sha256_generate) {
+    // The clauses are added directly without going through DIMACS
+    dimacs_name = "<generated>";
+    solver->message ("generating SHA-256 encoding %s'%s'%s",
+                     tout.green_code (),
+                     sha256_generate + strlen ("--sha256-generate="),
+                     tout.normal_code ());
+    err = SHA256::generate_encoding (
+        solver, sha256_generate + strlen ("--sha256-generate="));
+    incremental = false;
+    max_var = solver->vars ();
+  } else {
+    dimacs_name = dimacs_path ? dimacs_path : "<stdin>";
+    string help;
+    if (!dimacs_path) {
+      help += " ";
+      help += tout.magenta_code ();
+      help += "(use '-h' for a list of common options)";
+      help += tout.normal_code ();
+    }
+    solver->message ("reading DIMACS file from %s'%s'%s%s",
+                     tout.green_code (), dimacs_name, tout.normal_code (),
+                     help.c_str ());
+    if (dimacs_path)
+      err = solver->read_dimacs (dimacs_path, max_var,
+                                 force_strict_parsing, incremental,
+                                 cube_literals);
+    else
+      err = solver->read_dimacs (stdin, dimacs_name, max_var,
+                                 force_strict_parsing, incremental,
+                                 cube_literals);
+  }
   if (err)
     APPERR ("%s", err);
   if (read_solution_path) {
@@ -704,6 +893,60 @@ int App::main (int argc, char **argv) {
       APPERR ("%s", err);
   }
 
+  if (sha256_shm_cache) {
+    solver->section ("attaching shared rule cache");
+    SHA256::shared_cache = SHA256::SharedCache::attach (
+        sha256_shm_cache, SHARED_CACHE_SLOTS, err);
+    if (!SHA256::shared_cache)
+      APPERR ("%s '%s'", err, sha256_shm_cache);
+    solver->message ("attached to %s'%s'%s with %d slots",
+                     tout.green_code (), sha256_shm_cache,
+                     tout.normal_code (), SHARED_CACHE_SLOTS);
+  }
+
+  SHA256::CacheFile *cache_file = 0;
+  if (sha256_cache) {
+    solver->section ("loading rule caches");
+    cache_file = new SHA256::CacheFile (sha256_cache);
+    if ((err = cache_file->load ()))
+      APPERR ("%s '%s'", err, sha256_cache);
+    solver->message ("loaded %" PRIu64 " rules from %s'%s'%s",
+                     cache_file->loaded, tout.green_code (), sha256_cache,
+                     tout.normal_code ());
+    if (checkpoint_path)
+      propagator->cache_file = cache_file;
+  }
+
+  if (checkpoint_path) {
+    solver->section ("checkpoints");
+    if (resume && File::exists (checkpoint_path)) {
+      if ((err = solver->resume (checkpoint_path)))
+        APPERR ("%s", err);
+      solver->message ("resumed from checkpoint %s'%s'%s",
+                       tout.green_code (), checkpoint_path,
+                       tout.normal_code ());
+    } else if (resume)
+      solver->message ("no checkpoint %s'%s'%s to resume from",
+                       tout.green_code (), checkpoint_path,
+                       tout.normal_code ());
+    solver->checkpoint (checkpoint_path);
+    solver->message ("writing checkpoints to %s'%s'%s every %d conflicts",
+                     tout.green_code (), checkpoint_path,
+                     tout.normal_code (), get ("checkpointint"));
+  }
+
+  FILE *kernel_trace_file = 0;
+  if (sha256_record_kernels) {
+    solver->section ("recording kernel calls");
+    kernel_trace_file = fopen (sha256_record_kernels, "w");
+    if (!kernel_trace_file)
+      APPERR ("can not write kernel calls to '%s'", sha256_record_kernels);
+    SHA256::kernel_trace = new SHA256::KernelTrace (kernel_trace_file);
+    solver->message ("recording at most %d calls to %s'%s'%s",
+                     KERNEL_TRACE_MAX_CALLS, tout.green_code (),
+                     sha256_record_kernels, tout.normal_code ());
+  }
+
   solver->section ("options");
   if (optimize > 0) {
     solver->optimize (optimize);
@@ -839,6 +1082,40 @@ int App::main (int argc, char **argv) {
     res = solver->solve ();
   }
 
+  if (cache_file) {
+    solver->section ("saving rule caches");
+    // Losing the caches is no reason to lose the result of the search
+    if ((err = cache_file->save ()))
+      solver->warning ("%s '%s'", err, sha256_cache);
+    else
+      solver->message ("saved %" PRIu64 " rules to %s'%s'%s",
+                       cache_file->saved, tout.green_code (), sha256_cache,
+                       tout.normal_code ());
+    propagator->cache_file = 0;
+    delete cache_file;
+  }
+
+  if (callback_recorder) {
+    solver->section ("closing callback trace");
+    solver->connect_external_propagator (propagator);
+    if (fclose (callback_trace_file))
+      solver->warning ("can not write callbacks to '%s'",
+                       sha256_record_callbacks);
+    else
+      solver->message ("recorded %" PRIu64 " callbacks to %s'%s'%s",
+                       callback_recorder->events, tout.green_code (),
+                       sha256_record_callbacks, tout.normal_code ());
+    delete callback_recorder;
+  }
+
+  if (kernel_trace_file) {
+    delete SHA256::kernel_trace;
+    SHA256::kernel_trace = 0;
+    if (fclose (kernel_trace_file))
+      solver->warning ("can not write kernel calls to '%s'",
+                       sha256_record_kernels);
+  }
+
   if (proof_specified) {
     solver->section ("closing proof");
     solver->close_proof_trace (true);
@@ -914,6 +1191,7 @@ void App::init () {
 #endif
   force_strict_parsing = 1;
   force_writing = false;
+  report_json_file = 0;
   max_var = 0;
   timesup = false;
 
@@ -925,7 +1203,7 @@ void App::init () {
 
   CaDiCaL::Options::reportdefault = 1;
   solver = new Solver ();
-  new SHA256::Propagator (solver);
+  propagator = new SHA256::Propagator (solver);
   Signal::set (this);
 }
 
@@ -938,6 +1216,8 @@ App::~App () {
     return; // Only partially initialized.
   Signal::reset ();
   delete solver;
+  if (report_json_file)
+    fclose (report_json_file);
 }
 
 /*------------------------------------------------------------------------*/
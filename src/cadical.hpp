@@ -753,6 +753,43 @@ public:
   //
   void close_proof_trace (bool print = false);
 
+  //------------------------------------------------------------------------
+  // Periodically (every 'checkpointint' conflicts) write the search state
+  // to the given file, i.e., irredundant and important learned clauses,
+  // root-level units, scores, the decision queue and phases.  The file is
+  // written in the background and atomically replaced.  A connected
+  // external propagator is notified through 'notify_checkpoint'.
+  //
+  //   require (VALID)
+  //   ensure (VALID)
+  //
+  void checkpoint (const char *path);
+
+  // Restore the search state of a checkpoint written for the same formula
+  // (all clauses have to be added before).  Returns zero if successful and
+  // otherwise an error message.  Restored clauses are traced as original
+  // clauses in proofs, thus proofs of resumed runs are only valid relative
+  // to the checkpoint.
+  //
+  //   require (READY)
+  //   ensure (UNKNOWN)
+  //
+  const char *resume (const char *path);
+
+  //------------------------------------------------------------------------
+  // Write a machine-readable line (a JSON object) for each progress report
+  // with the main search counters, their rates since the previous line,
+  // memory usage and the SHA-256 propagator statistics.  Lines are written
+  // independently of the 'report' and 'quiet' options but respect the
+  // verbosity level of the report.  The file is flushed after each line
+  // and only closed by the solver if opened through the path version.
+  //
+  //   require (VALID)
+  //   ensure (VALID)
+  //
+  void report_json (FILE *file);       // Write JSON reports to file.
+  bool report_json (const char *path); // Open & write JSON reports.
+
   //------------------------------------------------------------------------
 
   static void usage (); // print usage information for long options
@@ -971,6 +1008,8 @@ private:
   void message ();               // empty line - only prefix
   void error (const char *, ...) // produce error message
       CADICAL_ATTRIBUTE_FORMAT (2, 3);
+  void warning (const char *, ...) // produce warning message
+      CADICAL_ATTRIBUTE_FORMAT (2, 3);
 
   // Explicit verbose level ('section' and 'message' use '0').
   //
@@ -1084,6 +1123,13 @@ public:
   //
   virtual int cb_propagate () { return 0; };
 
+  // Ask the external propagator whether anything it observes changed since
+  // the last round of 'cb_propagate' and 'cb_has_external_clause' calls.
+  // If it returns false, the solver skips both callbacks for the current
+  // propagation round. The default keeps the eager behaviour.
+  //
+  virtual bool cb_is_dirty () { return true; };
+
   // Ask the external propagator for the reason clause of a previous
   // external propagation step (done by cb_propagate). The clause must be
   // added literal-by-literal closed with a 0. Further, the clause must
@@ -1118,6 +1164,11 @@ public:
   // The actual function called to add the external clause.
   //
   virtual int cb_add_external_clause_lit () = 0;
+
+  // Called after the solver wrote a checkpoint, such that the propagator
+  // can save its own state (e.g., caches) along with it.
+  //
+  virtual void notify_checkpoint () {};
 };
 
 /*------------------------------------------------------------------------*/
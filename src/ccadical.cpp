@@ -1,4 +1,5 @@
 #include "cadical.hpp"
+#include "sha256/search.hpp"
 
 #include <cstdlib>
 #include <cstring>
@@ -8,6 +9,8 @@ namespace CaDiCaL {
 struct Wrapper : Learner, Terminator {
 
   Solver *solver;
+  // Only created for generating a SHA-256 encoding
+  SHA256::CharacteristicSearch *search = 0;
   struct {
     void *state;
     int (*function) (void *);
@@ -57,6 +60,7 @@ struct Wrapper : Learner, Terminator {
     terminator.function = 0;
     if (learner.begin_clause)
       free (learner.begin_clause);
+    delete search;
     delete solver;
   }
 };
@@ -173,4 +177,19 @@ void ccadical_melt (CCaDiCaL *ptr, int lit) {
 int ccadical_frozen (CCaDiCaL *ptr, int lit) {
   return ((Wrapper *) ptr)->solver->frozen (lit);
 }
+
+const char *ccadical_sha256_generate (CCaDiCaL *ptr, const char *spec) {
+  Wrapper *wrapper = (Wrapper *) ptr;
+  if (!wrapper->search)
+    wrapper->search = new SHA256::CharacteristicSearch (wrapper->solver);
+  return wrapper->search->generate (spec);
+}
+
+int ccadical_sha256_condition (CCaDiCaL *ptr, int step, char word, int bit,
+                               char symbol) {
+  Wrapper *wrapper = (Wrapper *) ptr;
+  if (!wrapper->search)
+    return 0;
+  return wrapper->search->condition (step, word, bit, symbol);
+}
 }
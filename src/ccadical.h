@@ -48,6 +48,16 @@ int ccadical_frozen (CCaDiCaL *, int lit);
 void ccadical_melt (CCaDiCaL *, int lit);
 int ccadical_simplify (CCaDiCaL *);
 
+// Incremental SHA-256 characteristic search (see 'sha256/search.hpp').
+// The encoding is generated with the propagator connected (returning an
+// error message or 0) and each condition on a bit of a word is enforced
+// by assuming its literal, which 'ccadical_failed' (or 'ipasir_failed')
+// reports if it was needed for UNSAT. Returns 0 for invalid conditions.
+
+const char *ccadical_sha256_generate (CCaDiCaL *, const char *spec);
+int ccadical_sha256_condition (CCaDiCaL *, int step, char word, int bit,
+                               char symbol);
+
 /*------------------------------------------------------------------------*/
 
 // Support legacy names used before moving to more IPASIR conforming names.
@@ -0,0 +1,297 @@
+#include "internal.hpp"
+
+namespace CaDiCaL {
+
+/*------------------------------------------------------------------------*/
+
+// Long running searches (which might be preempted) can periodically write
+// a checkpoint of the search state, i.e., the irredundant clauses, the
+// learned clauses of the first two tiers, the root-level units, the
+// variable scores, the decision queue and the phases.  A new run on the
+// same formula restores them with 'resume'.  Everything is stored in terms
+// of external literals as the internal variables are renumbered.  The
+// hash of the original clauses identifies the formula, since for instance
+// all SHA-256 instances with the same number of steps have the same number
+// of variables, and resuming with the clauses of another formula is
+// unsound.
+
+// The checkpoint is serialized by the solver thread but written to a
+// temporary file by a background thread and then renamed, such that a
+// preempted run always leaves a complete checkpoint behind.  Forking a
+// child instead would copy the whole process including other threads
+// (e.g., the background proof writer) in an arbitrary state.
+
+static const char checkpoint_magic[8] = {'C', 'a', 'D', 'i',
+                                         'C', 'a', 'L', 'K'};
+
+#define CHECKPOINT_VERSION 2
+
+// FNV-1a (as for the SHA-256 rule cache file)
+static uint32_t checksum (const char *bytes, size_t size) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= uint8_t (bytes[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+template <class T> static void put (string &bytes, T value) {
+  bytes.append ((const char *) &value, sizeof (value));
+}
+
+// Reads values from the checkpoint and fails on the first read beyond it.
+//
+struct CheckpointReader {
+  const string &bytes;
+  size_t pos;
+  bool ok;
+  CheckpointReader (const string &b) : bytes (b), pos (0), ok (true) {}
+  template <class T> T get () {
+    T res = T ();
+    if (ok && bytes.size () - pos >= sizeof (res)) {
+      memcpy (&res, bytes.data () + pos, sizeof (res));
+      pos += sizeof (res);
+    } else
+      ok = false;
+    return res;
+  }
+};
+
+/*------------------------------------------------------------------------*/
+
+bool Internal::checkpointing () {
+  if (checkpoint_path.empty ())
+    return false;
+  return stats.conflicts >= lim.checkpoint;
+}
+
+void Internal::checkpoint () {
+  wait_for_checkpoint ();
+  stats.checkpoints++;
+
+  string &bytes = checkpoint_bytes;
+  bytes.assign (checkpoint_magic, sizeof (checkpoint_magic));
+  put<uint32_t> (bytes, CHECKPOINT_VERSION);
+  put<int32_t> (bytes, external->max_var);
+  put<uint64_t> (bytes, external->formula_hash);
+  put<int64_t> (bytes, stats.conflicts);
+  put<double> (bytes, score_inc);
+
+  // Phases, score and queue stamp of each external variable.
+  for (int eidx = 1; eidx <= external->max_var; eidx++) {
+    const int ilit = external->e2i[eidx];
+    put<int8_t> (bytes, ilit != 0);
+    if (!ilit)
+      continue;
+    const int idx = abs (ilit), sign = ilit < 0 ? -1 : 1;
+    put<int8_t> (bytes, sign * phases.saved[idx]);
+    put<int8_t> (bytes, sign * phases.target[idx]);
+    put<int8_t> (bytes, sign * phases.best[idx]);
+    put<double> (bytes, stab[idx]);
+    put<int64_t> (bytes, btab[idx]);
+  }
+
+  // Clauses with their glue (zero for irredundant clauses).
+  const size_t count_pos = bytes.size ();
+  put<uint64_t> (bytes, 0);
+  uint64_t count = 0;
+  for (const auto &idx : vars) {
+    const int tmp = fixed (idx);
+    if (!tmp)
+      continue;
+    put<int32_t> (bytes, 0);
+    put<int32_t> (bytes, 1);
+    put<int32_t> (bytes, externalize (tmp < 0 ? -idx : idx));
+    count++;
+  }
+  for (const auto &c : clauses) {
+    if (c->garbage)
+      continue;
+    if (c->redundant && c->glue > opts.reducetier2glue)
+      continue;
+    put<int32_t> (bytes, c->redundant ? max (c->glue, 1) : 0);
+    put<int32_t> (bytes, c->size);
+    for (const auto &lit : *c)
+      put<int32_t> (bytes, externalize (lit));
+    count++;
+  }
+  memcpy (&bytes[count_pos], &count, sizeof (count));
+  put<uint32_t> (bytes, checksum (bytes.data (), bytes.size ()));
+
+  PHASE ("checkpoint", stats.checkpoints,
+         "writing %" PRIu64 " clauses in %zu bytes to '%s'", count,
+         bytes.size (), checkpoint_path.c_str ());
+  checkpointer = new std::thread (&Internal::write_checkpoint, this);
+
+  if (external_prop)
+    external->propagator->notify_checkpoint ();
+
+  lim.checkpoint = stats.conflicts + opts.checkpointint;
+}
+
+// Runs in the background thread.
+
+void Internal::write_checkpoint () {
+  const string tmp = checkpoint_path + ".tmp";
+  FILE *file = fopen (tmp.c_str (), "wb");
+  bool ok = file != 0;
+  if (file) {
+    ok = fwrite (checkpoint_bytes.data (), 1, checkpoint_bytes.size (),
+                 file) == checkpoint_bytes.size ();
+    ok = !fflush (file) && !fsync (fileno (file)) && ok;
+    ok = !fclose (file) && ok;
+  }
+  if (!ok || rename (tmp.c_str (), checkpoint_path.c_str ()))
+    checkpoint_failed = true;
+}
+
+void Internal::wait_for_checkpoint () {
+  if (!checkpointer)
+    return;
+  checkpointer->join ();
+  delete checkpointer;
+  checkpointer = 0;
+  checkpoint_bytes.clear ();
+  if (checkpoint_failed) {
+    warning ("could not write checkpoint '%s'", checkpoint_path.c_str ());
+    checkpoint_failed = false;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+
+const char *Internal::resume (const char *path) {
+  string bytes;
+  FILE *file = fopen (path, "rb");
+  if (!file)
+    return error_message.init ("can not read checkpoint '%s'", path);
+  char buffer[1 << 16];
+  size_t n;
+  while ((n = fread (buffer, 1, sizeof buffer, file)))
+    bytes.append (buffer, n);
+  fclose (file);
+
+  CheckpointReader reader (bytes);
+  uint32_t expected = 0;
+  if (bytes.size () >= sizeof (expected)) {
+    memcpy (&expected, bytes.data () + bytes.size () - sizeof (expected),
+            sizeof (expected));
+    if (checksum (bytes.data (), bytes.size () - sizeof (expected)) !=
+        expected)
+      reader.ok = false;
+  }
+  for (const auto &ch : checkpoint_magic)
+    if (reader.get<char> () != ch)
+      reader.ok = false;
+  if (reader.get<uint32_t> () != CHECKPOINT_VERSION)
+    reader.ok = false;
+  if (!reader.ok)
+    return error_message.init ("invalid checkpoint '%s'", path);
+  const int max_var = reader.get<int32_t> ();
+  const uint64_t formula_hash = reader.get<uint64_t> ();
+  if (max_var != external->max_var ||
+      formula_hash != external->formula_hash)
+    return error_message.init (
+        "checkpoint '%s' was written for another formula", path);
+  const int64_t conflicts = reader.get<int64_t> ();
+  const double inc = reader.get<double> ();
+
+  // Read everything before changing anything.
+  struct Variable {
+    int8_t saved, target, best;
+    double score;
+    int64_t bumped;
+  };
+  vector<Variable> variables (1 + (size_t) external->max_var);
+  vector<bool> restored (variables.size ());
+  for (int eidx = 1; reader.ok && eidx <= external->max_var; eidx++) {
+    if (!reader.get<int8_t> ())
+      continue;
+    Variable &v = variables[eidx];
+    v.saved = reader.get<int8_t> ();
+    v.target = reader.get<int8_t> ();
+    v.best = reader.get<int8_t> ();
+    v.score = reader.get<double> ();
+    v.bumped = reader.get<int64_t> ();
+    restored[eidx] = true;
+  }
+  vector<int> literals, glues;
+  const uint64_t count = reader.get<uint64_t> ();
+  for (uint64_t i = 0; reader.ok && i < count; i++) {
+    const int glue = reader.get<int32_t> ();
+    const int size = reader.get<int32_t> ();
+    if (glue < 0 || size < 1)
+      reader.ok = false;
+    glues.push_back (glue);
+    for (int j = 0; reader.ok && j < size; j++) {
+      const int elit = reader.get<int32_t> ();
+      if (!elit || elit == INT_MIN || abs (elit) > external->max_var)
+        reader.ok = false;
+      literals.push_back (elit);
+    }
+    literals.push_back (0);
+  }
+  if (!reader.ok || reader.pos + sizeof (expected) != bytes.size ())
+    return error_message.init ("invalid checkpoint '%s'", path);
+
+  if (level)
+    backtrack ();
+
+  // The clauses are added like original clauses (and thus traced as such
+  // in proofs), but learned clauses remain redundant.
+  auto glue = glues.begin ();
+  vector<int> &eclause = external->eclause;
+  for (const auto &elit : literals) {
+    if (elit) {
+      eclause.push_back (elit);
+      original.push_back (external->internalize (elit));
+      continue;
+    }
+    const uint64_t id = ++clause_id;
+    if (proof)
+      proof->add_external_original_clause (id, eclause);
+    add_new_original_clause (id, *glue > 0, *glue);
+    original.clear ();
+    eclause.clear ();
+    glue++;
+  }
+
+  // Move the variables to the front of the queue in the order of their
+  // restored stamps, and then restore scores and phases.
+  vector<int> order;
+  for (int idx = queue.first; idx; idx = links[idx].next)
+    order.push_back (idx);
+  vector<int64_t> stamps (vsize, 0);
+  for (int eidx = 1; eidx <= external->max_var; eidx++) {
+    const int ilit = external->e2i[eidx];
+    if (!ilit || !restored[eidx])
+      continue;
+    const Variable &v = variables[eidx];
+    const int idx = abs (ilit), sign = ilit < 0 ? -1 : 1;
+    phases.saved[idx] = sign * v.saved;
+    phases.target[idx] = sign * v.target;
+    phases.best[idx] = sign * v.best;
+    stab[idx] = v.score;
+    stamps[idx] = v.bumped;
+  }
+  stable_sort (order.begin (), order.end (),
+               [&] (int a, int b) { return stamps[a] < stamps[b]; });
+  queue.first = queue.last = 0;
+  for (const auto &idx : order)
+    queue.enqueue (links, idx);
+  int64_t bumped = queue.bumped;
+  for (int idx = queue.last; idx; idx = links[idx].prev)
+    btab[idx] = bumped--;
+  queue.unassigned = queue.last;
+  scores.erase ();
+  for (const auto &idx : vars)
+    scores.push_back (idx);
+  score_inc = inc;
+
+  MSG ("resumed %zu clauses from checkpoint after %" PRId64 " conflicts",
+       glues.size (), conflicts);
+  return 0;
+}
+
+} // namespace CaDiCaL
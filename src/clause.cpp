@@ -93,7 +93,11 @@ Clause *Internal::new_clause (bool red, int glue) {
     keep = false;
 
   size_t bytes = Clause::bytes (size);
+#ifdef COMPACT
+  Clause *c = (Clause *) arena.allocate (bytes);
+#else
   Clause *c = (Clause *) new char[bytes];
+#endif
 
   stats.added.total++;
   c->id = ++clause_id;
@@ -114,6 +118,9 @@ Clause *Internal::new_clause (bool red, int glue) {
   c->subsume = false;
   c->vivified = false;
   c->vivify = false;
+#ifdef COMPACT
+  c->shrunken = false;
+#endif
   c->used = 0;
 
   c->glue = glue;
@@ -203,9 +210,16 @@ size_t Internal::shrink_clause (Clause *c, int new_size) {
     c->pos = 2;
 
   size_t old_bytes = c->bytes ();
+#ifdef COMPACT
+  const size_t allocated = c->allocated_bytes ();
+#endif
   c->size = new_size;
   size_t new_bytes = c->bytes ();
   size_t res = old_bytes - new_bytes;
+#ifdef COMPACT
+  if ((c->shrunken = new_bytes < allocated))
+    *(size_t *) ((char *) c + new_bytes) = allocated;
+#endif
 
   if (c->redundant)
     promote_clause (c, min (c->size - 1, c->glue));
@@ -230,7 +244,11 @@ void Internal::deallocate_clause (Clause *c) {
   if (arena.contains (p))
     return;
   LOG (c, "deallocate pointer %p", (void *) c);
+#ifdef COMPACT
+  arena.release (p, c->allocated_bytes ());
+#else
   delete[] p;
+#endif
 }
 
 void Internal::delete_clause (Clause *c) {
@@ -340,8 +358,11 @@ void Internal::assign_original_unit (uint64_t id, int lit) {
 }
 
 // New clause added through the API, e.g., while parsing a DIMACS file.
+// Learned clauses restored from a checkpoint are added the same way, but
+// remain redundant.
 //
-void Internal::add_new_original_clause (uint64_t id) {
+void Internal::add_new_original_clause (uint64_t id, bool redundant,
+                                        int glue) {
   if (level)
     backtrack ();
   LOG (original, "original clause");
@@ -424,7 +445,7 @@ void Internal::add_new_original_clause (uint64_t id) {
     } else if (size == 1) {
       assign_original_unit (new_id, clause[0]);
     } else {
-      Clause *c = new_clause (false);
+      Clause *c = new_clause (redundant, glue);
       c->id = new_id;
       clause_id--;
       watch_clause (c);
@@ -41,6 +41,9 @@ struct Clause {
   unsigned used : 2; // resolved in conflict analysis since last 'reduce'
   bool vivified : 1; // clause already vivified
   bool vivify : 1;   // clause scheduled to be vivified
+#ifdef COMPACT
+  bool shrunken : 1; // allocated bytes stored after 'bytes ()' bytes
+#endif
 
   // The glucose level ('LBD' or short 'glue') is a heuristic value for the
   // expected usefulness of a learned clause, where smaller glue is consider
@@ -113,6 +116,17 @@ struct Clause {
 
   size_t bytes () const { return bytes (size); }
 
+#ifdef COMPACT
+  // Clauses are released to the free list of the size they were allocated
+  // with, which is kept in the unused memory after a shrunken clause.
+  //
+  size_t allocated_bytes () const {
+    if (!shrunken)
+      return bytes ();
+    return *(const size_t *) ((const char *) this + bytes ());
+  }
+#endif
+
   // Check whether this clause is ready to be collected and deleted.  The
   // 'reason' flag is only there to protect reason clauses in 'reduce',
   // which does not backtrack to the root level.  If garbage collection is
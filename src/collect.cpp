@@ -203,7 +203,7 @@ inline void Internal::flush_watches (int lit, Watches &saved) {
       continue;
     if (c->moved)
       c = w.clause = c->copy;
-    w.size = c->size;
+    w.update_size (c->size);
     const int new_blit_pos = (c->literals[0] == lit);
     assert (c->literals[!new_blit_pos] == lit); /*FW1*/
     w.blit = c->literals[new_blit_pos];
@@ -462,7 +462,15 @@ void Internal::check_clause_stats () {
 
 /*------------------------------------------------------------------------*/
 
-bool Internal::arenaing () { return opts.arena && (stats.collections > 1); }
+// Clauses in the clause heap can not be moved (see 'arena.hpp').
+
+bool Internal::arenaing () {
+#ifdef COMPACT
+  return false;
+#else
+  return opts.arena && (stats.collections > 1);
+#endif
+}
 
 void Internal::garbage_collection () {
   if (unsat)
@@ -561,12 +561,14 @@ bool Internal::decompose_round () {
       if (!c->redundant)
         mark_removed (c);
       if (proof) {
+        // Deleting 'c' might add a copy of it (see 'Proof::copy_clause').
+        const uint64_t id = ++clause_id;
         if (opts.lrat && !opts.lratexternal)
-          proof->add_derived_clause (++clause_id, clause, lrat_chain);
+          proof->add_derived_clause (id, clause, lrat_chain);
         else
-          proof->add_derived_clause (++clause_id, clause);
+          proof->add_derived_clause (id, clause);
         proof->delete_clause (c);
-        c->id = clause_id;
+        c->id = id;
       }
       size_t l;
       for (l = 2; l < clause.size (); l++)
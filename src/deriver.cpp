@@ -0,0 +1,230 @@
+#include "internal.hpp"
+
+namespace CaDiCaL {
+
+/*------------------------------------------------------------------------*/
+
+Deriver::Deriver (Internal *i)
+    : internal (i), propagated (0), conflict (0), steps (0) {
+  LOG ("DERIVER new");
+  memset (&stats, 0, sizeof (stats));
+}
+
+inline unsigned Deriver::l2u (int lit) {
+  assert (lit);
+  assert (lit != INT_MIN);
+  unsigned res = 2 * (abs (lit) - 1);
+  if (lit < 0)
+    res++;
+  return res;
+}
+
+void Deriver::enlarge (int lit) {
+  const size_t size = 2 * (size_t) abs (lit);
+  if (size <= vals.size ())
+    return;
+  occs.resize (size);
+  units.resize (size, 0);
+  vals.resize (size, 0);
+  reasons.resize (size / 2, 0);
+  seen.resize (size / 2, false);
+}
+
+/*------------------------------------------------------------------------*/
+
+void Deriver::add_original_clause (uint64_t id, const vector<int> &c) {
+  if (c.empty ())
+    return;
+  // Skip duplicated literals and tautologies, which could not be copied.
+  bool skip = false;
+  for (const auto &lit : c) {
+    enlarge (lit);
+    if (vals[l2u (lit)] || vals[l2u (-lit)])
+      skip = true;
+    vals[l2u (lit)] = 1;
+  }
+  for (const auto &lit : c)
+    vals[l2u (lit)] = 0;
+  if (skip)
+    return;
+  const unsigned idx = ids.size ();
+  LOG (c, "DERIVER original clause[%" PRIu64 "] at %u", id, idx);
+  starts.push_back (literals.size ());
+  for (const auto &lit : c)
+    literals.push_back (lit);
+  literals.push_back (0);
+  ids.push_back (id);
+  copied.push_back (false);
+  index[id] = idx;
+  if (c.size () == 1) {
+    unsigned &unit = units[l2u (c[0])];
+    if (!unit)
+      unit = idx + 1;
+  } else
+    for (const auto &lit : c)
+      occs[l2u (lit)].push_back (idx);
+  stats.original++;
+}
+
+const int *Deriver::deleted (uint64_t id) {
+  const auto it = index.find (id);
+  if (it == index.end ())
+    return 0;
+  return &literals[starts[it->second]];
+}
+
+void Deriver::copy (uint64_t id, uint64_t new_id) {
+  const auto it = index.find (id);
+  assert (it != index.end ());
+  const unsigned idx = it->second;
+  LOG ("DERIVER copied clause[%" PRIu64 "] to clause[%" PRIu64 "]", id,
+       new_id);
+  index.erase (it);
+  ids[idx] = new_id;
+  copied[idx] = true;
+  stats.copied++;
+}
+
+/*------------------------------------------------------------------------*/
+
+// Assigning a literal immediately checks for a contradicting unit clause.
+
+void Deriver::assign (int lit, unsigned reason) {
+  assert (!vals[l2u (lit)]);
+  vals[l2u (lit)] = 1;
+  vals[l2u (-lit)] = -1;
+  reasons[abs (lit) - 1] = reason;
+  trail.push_back (lit);
+  if (!conflict && units[l2u (-lit)])
+    conflict = units[l2u (-lit)];
+}
+
+// Unit clauses are not watched but assigned lazily when their variable is
+// first looked at.  Thus we do not have to go over all of them for each
+// derivation (conditions of a characteristic result in many units).
+
+signed char Deriver::val (int lit) {
+  const signed char res = vals[l2u (lit)];
+  if (res)
+    return res;
+  if (units[l2u (lit)]) {
+    assign (lit, units[l2u (lit)]);
+    return 1;
+  }
+  if (units[l2u (-lit)]) {
+    assign (-lit, units[l2u (-lit)]);
+    return -1;
+  }
+  return 0;
+}
+
+// Returns 'true' on conflict and 'false' if propagation completed or ran
+// out of steps.
+
+bool Deriver::propagate () {
+  while (!conflict && propagated < trail.size ()) {
+    const int lit = trail[propagated++];
+    for (const auto &idx : occs[l2u (-lit)]) {
+      if (--steps < 0)
+        return false;
+      int unit = 0;
+      bool done = false;
+      for (const int *p = &literals[starts[idx]]; !done && *p; p++) {
+        const signed char tmp = val (*p);
+        if (tmp > 0)
+          done = true;
+        else if (!tmp && unit)
+          done = true;
+        else if (!tmp)
+          unit = *p;
+      }
+      if (conflict)
+        return true;
+      if (done)
+        continue;
+      if (!unit) {
+        conflict = idx + 1;
+        return true;
+      }
+      assign (unit, idx + 1);
+      if (conflict)
+        return true;
+    }
+  }
+  return conflict;
+}
+
+// The reasons of the conflict in trail order followed by the conflict.
+
+void Deriver::analyze () {
+  assert (conflict);
+  chain.clear ();
+  for (const int *p = &literals[starts[conflict - 1]]; *p; p++)
+    seen[abs (*p) - 1] = true;
+  for (auto i = trail.rbegin (); i != trail.rend (); i++) {
+    const int idx = abs (*i) - 1;
+    const unsigned reason = reasons[idx];
+    if (!seen[idx] || !reason)
+      continue;
+    chain.push_back (ids[reason - 1]);
+    for (const int *p = &literals[starts[reason - 1]]; *p; p++)
+      seen[abs (*p) - 1] = true;
+  }
+  reverse (chain.begin (), chain.end ());
+  chain.push_back (ids[conflict - 1]);
+}
+
+void Deriver::backtrack () {
+  for (const auto &lit : trail) {
+    vals[l2u (lit)] = vals[l2u (-lit)] = 0;
+    reasons[abs (lit) - 1] = 0;
+    seen[abs (lit) - 1] = false;
+  }
+  trail.clear ();
+  propagated = 0;
+  conflict = 0;
+}
+
+bool Deriver::derive (const vector<int> &c) {
+  assert (trail.empty ());
+  LOG (c, "DERIVER deriving");
+  const int64_t limit = internal->opts.proofexternalmax;
+  steps = limit;
+  bool tautological = false;
+  for (const auto &lit : c) {
+    enlarge (lit);
+    const signed char tmp = vals[l2u (-lit)];
+    if (tmp < 0)
+      tautological = true;
+    else if (!tmp)
+      assign (-lit, 0);
+  }
+  const bool res = !tautological && (conflict || propagate ());
+  stats.steps += limit - (steps < 0 ? 0 : steps);
+  if (res) {
+    analyze ();
+    LOG (chain, "DERIVER derived with chain");
+    stats.derived++;
+  } else {
+    LOG ("DERIVER failed to derive clause");
+    stats.failed++;
+  }
+  backtrack ();
+  return res;
+}
+
+/*------------------------------------------------------------------------*/
+
+void Deriver::finalize () {
+  vector<int> c;
+  for (size_t idx = 0; idx < ids.size (); idx++) {
+    if (!copied[idx])
+      continue;
+    for (const int *p = &literals[starts[idx]]; *p; p++)
+      c.push_back (*p);
+    internal->proof->finalize_external_clause (ids[idx], c);
+    c.clear ();
+  }
+}
+
+} // namespace CaDiCaL
@@ -0,0 +1,98 @@
+#ifndef _deriver_hpp_INCLUDED
+#define _deriver_hpp_INCLUDED
+
+/*------------------------------------------------------------------------*/
+
+namespace CaDiCaL {
+
+/*------------------------------------------------------------------------*/
+
+// Derives the clauses of an external propagator (reasons and external
+// clauses) from the original clauses, enabled by 'opts.proofexternal'.
+// Without it these clauses enter the proof as additional original clauses
+// and thus the proof can not be checked independently of the propagator.
+
+// The deriver keeps its own copy of the original clauses (in external
+// literals) with full occurrence lists.  An external clause is derived by
+// assuming its negation and unit propagating over these clauses, starting
+// from the variables of the clause, which thus only visits the encoding
+// of the operations the clause talks about.  If this runs into a conflict
+// within 'opts.proofexternalmax' steps the clause is added as derived
+// clause with the lrat chain of the conflict, otherwise we fall back to
+// adding it as original clause.
+
+// As the solver might delete original clauses needed by later derivations,
+// each original clause is copied (as derived clause with a chain of just
+// the original clause) right before it is deleted in the proof.  The copies
+// are never deleted and finalized as part of the proof.
+
+/*------------------------------------------------------------------------*/
+
+class Deriver {
+
+  Internal *internal;
+
+  // Literals of the clauses with a zero sentinel each, their start, their
+  // current id in the proof and whether it is a copy.
+  //
+  vector<int> literals;
+  vector<size_t> starts;
+  vector<uint64_t> ids;
+  vector<bool> copied;
+
+  // Clause index of original clause ids still used in the proof.
+  //
+  unordered_map<uint64_t, unsigned> index;
+
+  static unsigned l2u (int lit);
+  vector<vector<unsigned>> occs; // clauses by literal
+  vector<unsigned> units;        // unit clause plus one by literal
+  vector<signed char> vals;      // values by literal
+  vector<unsigned> reasons;      // reason plus one by variable
+  vector<bool> seen;             // analyzed variables
+
+  vector<int> trail;
+  size_t propagated;
+  unsigned conflict; // plus one
+  int64_t steps;     // remaining propagation steps
+
+  void enlarge (int lit);
+  void assign (int lit, unsigned reason);
+  signed char val (int lit);
+  bool propagate ();
+  void analyze ();
+  void backtrack ();
+
+  struct {
+    int64_t original; // original clauses
+    int64_t copied;   // copied before deletion
+    int64_t derived;  // successfully derived clauses
+    int64_t failed;   // failed derivations
+    int64_t steps;    // propagation steps
+  } stats;
+
+public:
+  Deriver (Internal *);
+
+  void add_original_clause (uint64_t, const vector<int> &);
+
+  // Returns the literals of an original clause which has to be copied
+  // before it is deleted from the proof or zero otherwise, and then the
+  // id of its copy is set with 'copy'.
+  //
+  const int *deleted (uint64_t);
+  void copy (uint64_t, uint64_t);
+
+  // Tries to find the lrat chain of an external clause, which is then
+  // available in 'chain' until the next derivation.
+  //
+  bool derive (const vector<int> &);
+  vector<uint64_t> chain;
+
+  void finalize ();
+  void print_stats ();
+};
+
+} // namespace CaDiCaL
+
+#endif
@@ -3,7 +3,8 @@
 namespace CaDiCaL {
 
 External::External (Internal *i)
-    : internal (i), max_var (0), vsize (0), extended (false),
+    : internal (i), max_var (0), vsize (0),
+      formula_hash (14695981039346656037ull), extended (false),
       terminator (0), learner (0), propagator (0), solution (0),
       vars (max_var) {
   assert (internal);
@@ -143,6 +144,13 @@ int External::internalize (int elit) {
 void External::add (int elit) {
   assert (elit != INT_MIN);
   reset_extended ();
+
+  // Checkpoints record this hash to reject resuming on another formula.
+  for (unsigned i = 0; i < sizeof elit; i++) {
+    formula_hash ^= (uint8_t) ((unsigned) elit >> (8 * i));
+    formula_hash *= 1099511628211ull;
+  }
+
   if (internal->opts.check &&
       (internal->opts.checkwitness || internal->opts.checkfailed))
     original.push_back (elit);
@@ -382,7 +390,8 @@ void External::reset_observed_vars () {
   // Shouldn't be called if there is no connected propagator
   assert (propagator);
   reset_extended ();
-  assert ((size_t) max_var + 1 == is_observed.size ());
+  // Nothing is allocated before the first variable
+  assert (!max_var || (size_t) max_var + 1 == is_observed.size ());
 
   for (auto elit : vars) {
     int eidx = abs (elit);
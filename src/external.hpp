@@ -67,6 +67,7 @@ struct External {
       ext_units; // External units. Needed to compute lrat for eclause
   vector<bool> ext_flags; // to avoid duplicate units
   vector<int> eclause;    // External version of original input clause.
+  uint64_t formula_hash;  // FNV-1a hash of the added original clauses.
   // The extension stack for reconstructing complete satisfying assignments
   // (models) of the original external formula is kept in this external
   // solver object. It keeps track of blocked clauses and clauses containing
@@ -106,6 +106,14 @@ bool Internal::external_propagate () {
 
     notify_assignments ();
 
+    // Nothing observed was assigned or unassigned since the last round, so
+    // neither propagations nor external clauses can have become available.
+    if (!external->propagator->cb_is_dirty ()) {
+      stats.ext_prop.ext_cb++;
+      stats.ext_prop.eprop_skip++;
+      return true;
+    }
+
     int elit = external->propagator->cb_propagate ();
     stats.ext_prop.ext_cb++;
     stats.ext_prop.eprop_call++;
@@ -413,8 +421,13 @@ Clause *Internal::add_external_clause (bool as_redundant,
     external->original.push_back (elit);
   }
   uint64_t id = ++clause_id;
-  if (proof)
-    proof->add_external_original_clause (id, external_original);
+  if (proof) {
+    if (deriver && deriver->derive (external_original))
+      proof->add_external_derived_clause (id, external_original,
+                                          deriver->chain);
+    else
+      proof->add_external_original_clause (id, external_original);
+  }
 
   if (opts.lrat && !opts.lratexternal) {
     for (const auto &lit : external_original) {
@@ -17,11 +17,34 @@ extern "C" {
 #ifndef _WIN32
 
 extern "C" {
+#include <sys/mman.h>
 #include <sys/wait.h>
 };
 
 #endif
 
+// In-process decompression needs 'fopencookie' of the GNU C library to wrap
+// the decompression into a 'FILE'.
+
+#if (defined(HAVE_ZLIB) || defined(HAVE_LZMA) || defined(HAVE_ZSTD)) && \
+    defined(__GLIBC__)
+#define INFLATE
+#endif
+
+#ifdef INFLATE
+extern "C" {
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_LZMA
+#include <lzma.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+}
+#endif
+
 /*------------------------------------------------------------------------*/
 
 namespace CaDiCaL {
@@ -39,7 +62,7 @@ File::File (Internal *i, bool w, int c, int p, FILE *f, const char *n)
       writing (w),
 #endif
       close_file (c), child_pid (p), file (f), _name (n), _lineno (1),
-      _bytes (0) {
+      _bytes (0), mapped (0), mapped_bytes (0) {
   (void) i, (void) w;
   assert (f), assert (n);
 }
@@ -111,6 +134,7 @@ static int bz2sig[] = {0x42, 0x5A, 0x68, EOF};
 static int gzsig[] = {0x1F, 0x8B, EOF};
 static int sig7z[] = {0x37, 0x7A, 0xBC, 0xAF, 0x27, 0x1C, EOF};
 static int lzmasig[] = {0x5D, EOF};
+static int zstdsig[] = {0x28, 0xB5, 0x2F, 0xFD, EOF};
 
 bool File::match (Internal *internal, const char *path, const int *sig) {
   assert (path);
@@ -302,6 +326,291 @@ FILE *File::write_pipe (Internal *internal, const char *command,
 
 /*------------------------------------------------------------------------*/
 
+// Decompressing inputs in the process with 'zlib', 'liblzma' or 'zstd' (if
+// available at compile time) avoids to fork an external decompressor for
+// every input.  The decompressed data is written by the 'read' function of
+// the wrapped 'FILE' directly into its buffer, which we enlarge to read
+// large blocks, from which 'get' then reads as from any other file.
+
+#ifdef INFLATE
+
+namespace {
+
+struct Inflater {
+  FILE *input = 0; // Compressed input (unless read by 'zlib' itself).
+  std::vector<uint8_t> buffer;
+  virtual ~Inflater () {
+    if (input)
+      fclose (input);
+  }
+  // Returns the number of decompressed bytes, '0' at the end of the input
+  // and '-1' on errors (after returning the bytes decompressed before).
+  virtual ssize_t read (char *, size_t) = 0;
+  bool fill (size_t &available) {
+    available = fread (buffer.data (), 1, buffer.size (), input);
+    return !ferror (input);
+  }
+};
+
+#ifdef HAVE_ZLIB
+
+struct GzipInflater : Inflater {
+  gzFile gz = 0;
+  ~GzipInflater () {
+    if (gz)
+      gzclose (gz);
+  }
+  bool open (const char *path) {
+    if (!(gz = gzopen (path, "rb")))
+      return false;
+    gzbuffer (gz, 1 << 20);
+    return true;
+  }
+  // At the end of a truncated file 'gzread' only sets 'Z_BUF_ERROR'.
+  ssize_t read (char *data, size_t bytes) {
+    int res = gzread (gz, data, bytes);
+    if (res)
+      return res;
+    int errnum;
+    gzerror (gz, &errnum);
+    return errnum == Z_OK ? 0 : -1;
+  }
+};
+
+#endif
+
+#ifdef HAVE_LZMA
+
+// Reads '.xz' as well as '.lzma' files (and several concatenated streams).
+
+struct LzmaInflater : Inflater {
+  lzma_stream stream = LZMA_STREAM_INIT;
+  bool finished = false;
+  ~LzmaInflater () { lzma_end (&stream); }
+  bool open (const char *path) {
+    if (!(input = fopen (path, "rb")))
+      return false;
+    buffer.resize (1 << 20);
+    return lzma_auto_decoder (&stream, UINT64_MAX, LZMA_CONCATENATED) ==
+           LZMA_OK;
+  }
+  ssize_t read (char *data, size_t bytes) {
+    stream.next_out = (uint8_t *) data;
+    stream.avail_out = bytes;
+    while (!finished && stream.avail_out) {
+      lzma_action action = LZMA_RUN;
+      if (!stream.avail_in) {
+        if (!fill (stream.avail_in))
+          return -1;
+        stream.next_in = buffer.data ();
+        if (!stream.avail_in)
+          action = LZMA_FINISH;
+      }
+      lzma_ret ret = lzma_code (&stream, action);
+      if (ret == LZMA_STREAM_END)
+        finished = true;
+      else if (ret != LZMA_OK)
+        return bytes > stream.avail_out ? bytes - stream.avail_out : -1;
+    }
+    return bytes - stream.avail_out;
+  }
+};
+
+#endif
+
+#ifdef HAVE_ZSTD
+
+struct ZstdInflater : Inflater {
+  ZSTD_DStream *stream = 0;
+  ZSTD_inBuffer in = {0, 0, 0};
+  size_t last = 0; // Non-zero unless the last frame was completed.
+  ~ZstdInflater () {
+    if (stream)
+      ZSTD_freeDStream (stream);
+  }
+  bool open (const char *path) {
+    if (!(input = fopen (path, "rb")))
+      return false;
+    buffer.resize (ZSTD_DStreamInSize ());
+    return (stream = ZSTD_createDStream ()) &&
+           !ZSTD_isError (ZSTD_initDStream (stream));
+  }
+  ssize_t read (char *data, size_t bytes) {
+    ZSTD_outBuffer out = {data, bytes, 0};
+    while (out.pos < out.size) {
+      if (in.pos == in.size) {
+        size_t available;
+        if (!fill (available))
+          return -1;
+        if (!available && !last)
+          break;
+        in = {buffer.data (), available, 0};
+      }
+      // At the end of the input only buffered data can be flushed.  If
+      // there is none the last frame is truncated.
+      const size_t before = out.pos;
+      last = ZSTD_decompressStream (stream, &out, &in);
+      if (ZSTD_isError (last) || (!in.size && last && out.pos == before))
+        return out.pos ? (ssize_t) out.pos : -1;
+    }
+    return out.pos;
+  }
+};
+
+#endif
+
+ssize_t read_inflater (void *cookie, char *data, size_t bytes) {
+  return ((Inflater *) cookie)->read (data, bytes);
+}
+
+int close_inflater (void *cookie) {
+  delete (Inflater *) cookie;
+  return 0;
+}
+
+template <class T> FILE *inflate (const char *path) {
+  T *inflater = new T;
+  if (!inflater->open (path)) {
+    delete inflater;
+    return 0;
+  }
+  cookie_io_functions_t functions = {read_inflater, 0, 0, close_inflater};
+  FILE *res = fopencookie (inflater, "r", functions);
+  if (!res) {
+    delete inflater;
+    return 0;
+  }
+  setvbuf (res, 0, _IOFBF, 1 << 20);
+  return res;
+}
+
+} // namespace
+
+#endif
+
+// Returns '0' if the format is not supported in the process.
+
+FILE *File::read_inflate (Internal *internal, const int *sig,
+                          const char *path) {
+#ifdef INFLATE
+  if (!File::exists (path) || !File::match (internal, path, sig))
+    return 0;
+  FILE *res = 0;
+#ifdef HAVE_ZLIB
+  if (sig == gzsig)
+    res = inflate<GzipInflater> (path);
+#endif
+#ifdef HAVE_LZMA
+  if (sig == xzsig || sig == lzmasig)
+    res = inflate<LzmaInflater> (path);
+#endif
+#ifdef HAVE_ZSTD
+  if (sig == zstdsig)
+    res = inflate<ZstdInflater> (path);
+#endif
+  if (res)
+    MSG ("decompressing '%s' while reading", path);
+  return res;
+#else
+  (void) internal, (void) sig, (void) path;
+  return 0;
+#endif
+}
+
+/*------------------------------------------------------------------------*/
+
+// Similarly '.zst' files (in particular large proofs) are compressed in the
+// process by the 'write' function of the wrapped 'FILE'.
+
+#if defined(INFLATE) && defined(HAVE_ZSTD)
+
+namespace {
+
+struct ZstdDeflater {
+  FILE *output = 0;
+  ZSTD_CStream *stream = 0;
+  std::vector<char> buffer;
+  ~ZstdDeflater () {
+    if (stream)
+      ZSTD_freeCStream (stream);
+    if (output)
+      fclose (output);
+  }
+  bool open (const char *path) {
+    if (!(output = fopen (path, "wb")))
+      return false;
+    buffer.resize (ZSTD_CStreamOutSize ());
+    return (stream = ZSTD_createCStream ()) &&
+           !ZSTD_isError (ZSTD_initCStream (stream, 3));
+  }
+  bool flush (ZSTD_outBuffer &out) {
+    return fwrite (buffer.data (), 1, out.pos, output) == out.pos;
+  }
+  // Returns the number of compressed bytes and '0' on errors.
+  ssize_t write (const char *data, size_t bytes) {
+    ZSTD_inBuffer in = {data, bytes, 0};
+    while (in.pos < in.size) {
+      ZSTD_outBuffer out = {buffer.data (), buffer.size (), 0};
+      if (ZSTD_isError (ZSTD_compressStream (stream, &out, &in)) ||
+          !flush (out))
+        return 0;
+    }
+    return bytes;
+  }
+  // Writes the end of the frame.
+  bool finish () {
+    size_t remaining;
+    do {
+      ZSTD_outBuffer out = {buffer.data (), buffer.size (), 0};
+      remaining = ZSTD_endStream (stream, &out);
+      if (ZSTD_isError (remaining) || !flush (out))
+        return false;
+    } while (remaining);
+    return true;
+  }
+};
+
+ssize_t write_deflater (void *cookie, const char *data, size_t bytes) {
+  return ((ZstdDeflater *) cookie)->write (data, bytes);
+}
+
+int close_deflater (void *cookie) {
+  ZstdDeflater *deflater = (ZstdDeflater *) cookie;
+  int res = deflater->finish () ? 0 : EOF;
+  delete deflater;
+  return res;
+}
+
+} // namespace
+
+#endif
+
+// Returns '0' if '.zst' files can not be compressed in the process.
+
+FILE *File::write_deflate (Internal *internal, const char *path) {
+#if defined(INFLATE) && defined(HAVE_ZSTD)
+  ZstdDeflater *deflater = new ZstdDeflater;
+  if (!deflater->open (path)) {
+    delete deflater;
+    return 0;
+  }
+  cookie_io_functions_t functions = {0, write_deflater, 0, close_deflater};
+  FILE *res = fopencookie (deflater, "w", functions);
+  if (!res) {
+    delete deflater;
+    return 0;
+  }
+  setvbuf (res, 0, _IOFBF, 1 << 20);
+  MSG ("compressing '%s' while writing", path);
+  return res;
+#else
+  (void) internal, (void) path;
+  return 0;
+#endif
+}
+
+/*------------------------------------------------------------------------*/
+
 File *File::read (Internal *internal, FILE *f, const char *n) {
   return new File (internal, false, 0, 0, f, n);
 }
@@ -314,20 +623,29 @@ File *File::read (Internal *internal, const char *path) {
   FILE *file;
   int close_input = 2;
   if (has_suffix (path, ".xz")) {
-    file = read_pipe (internal, "xz -c -d %s", xzsig, path);
-    if (!file)
+    if ((file = read_inflate (internal, xzsig, path)))
+      close_input = 4;
+    else if (!(file = read_pipe (internal, "xz -c -d %s", xzsig, path)))
       goto READ_FILE;
   } else if (has_suffix (path, ".lzma")) {
-    file = read_pipe (internal, "lzma -c -d %s", lzmasig, path);
-    if (!file)
+    if ((file = read_inflate (internal, lzmasig, path)))
+      close_input = 4;
+    else if (!(file = read_pipe (internal, "lzma -c -d %s", lzmasig, path)))
       goto READ_FILE;
   } else if (has_suffix (path, ".bz2")) {
     file = read_pipe (internal, "bzip2 -c -d %s", bz2sig, path);
     if (!file)
       goto READ_FILE;
   } else if (has_suffix (path, ".gz")) {
-    file = read_pipe (internal, "gzip -c -d %s", gzsig, path);
-    if (!file)
+    if ((file = read_inflate (internal, gzsig, path)))
+      close_input = 4;
+    else if (!(file = read_pipe (internal, "gzip -c -d %s", gzsig, path)))
+      goto READ_FILE;
+  } else if (has_suffix (path, ".zst")) {
+    if ((file = read_inflate (internal, zstdsig, path)))
+      close_input = 4;
+    else if (!(file = read_pipe (internal, "zstd -c -d -q %s", zstdsig,
+                                 path)))
       goto READ_FILE;
   } else if (has_suffix (path, ".7z")) {
     file = read_pipe (internal, "7z x -so %s 2>/dev/null", sig7z, path);
@@ -355,6 +673,11 @@ File *File::write (Internal *internal, const char *path) {
     file = write_pipe (internal, "bzip2 -c", path, child_pid);
   else if (has_suffix (path, ".gz"))
     file = write_pipe (internal, "gzip -c", path, child_pid);
+  else if (has_suffix (path, ".zst") &&
+           (file = write_deflate (internal, path)))
+    close_output = 5;
+  else if (has_suffix (path, ".zst"))
+    file = write_pipe (internal, "zstd -c -q", path, child_pid);
   else if (has_suffix (path, ".7z"))
     file = write_pipe (internal, "7z a -an -txz -si -so", path, child_pid);
   else
@@ -367,7 +690,7 @@ File *File::write (Internal *internal, const char *path) {
   return new File (internal, true, close_output, child_pid, file, path);
 }
 
-void File::close (bool print) {
+bool File::close (bool print) {
   assert (file);
 #ifndef QUIET
   if (internal->opts.quiet)
@@ -375,6 +698,7 @@ void File::close (bool print) {
   else if (internal->opts.verbose > 0)
     print = true;
 #endif
+  bool res = true;
   if (close_file == 0) {
     if (print)
       MSG ("disconnecting from '%s'", name ());
@@ -382,25 +706,36 @@ void File::close (bool print) {
   if (close_file == 1) {
     if (print)
       MSG ("closing file '%s'", name ());
-    fclose (file);
+    res = !fclose (file);
   }
   if (close_file == 2) {
     if (print)
       MSG ("closing input pipe to read '%s'", name ());
-    pclose (file);
+    res = !pclose (file);
+  }
+  if (close_file == 4) {
+    if (print)
+      MSG ("closing decompressed file '%s'", name ());
+    res = !fclose (file);
+  }
+  if (close_file == 5) {
+    if (print)
+      MSG ("closing compressed file '%s'", name ());
+    res = !fclose (file);
   }
 #ifndef _WIN32
   if (close_file == 3) {
     if (print)
       MSG ("closing output pipe to write '%s'", name ());
-    fclose (file);
-    waitpid (child_pid, 0, 0);
+    res = !fclose (file);
+    int status;
+    if (waitpid (child_pid, &status, 0) != child_pid ||
+        !WIFEXITED (status) || WEXITSTATUS (status))
+      res = false;
   }
 #endif
   file = 0; // mark as closed
 
-  // TODO what about error checking for 'fclose', 'pclose' or 'waitpid'?
-
 #ifndef QUIET
   if (print) {
     if (writing) {
@@ -408,7 +743,7 @@ void File::close (bool print) {
       double written_mb = written_bytes / (double) (1 << 20);
       MSG ("after writing %" PRIu64 " bytes %.1f MB", written_bytes,
            written_mb);
-      if (close_file == 3) {
+      if (close_file == 3 || close_file == 5) {
         size_t actual_bytes = size (name ());
         if (actual_bytes) {
           double actual_mb = actual_bytes / (double) (1 << 20);
@@ -423,7 +758,7 @@ void File::close (bool print) {
       uint64_t read_bytes = bytes ();
       double read_mb = read_bytes / (double) (1 << 20);
       MSG ("after reading %" PRIu64 " bytes %.1f MB", read_bytes, read_mb);
-      if (close_file == 2) {
+      if (close_file == 2 || close_file == 4) {
         size_t actual_bytes = size (name ());
         double actual_mb = actual_bytes / (double) (1 << 20);
         MSG ("inflated from %zd bytes %.1f MB", actual_bytes, actual_mb);
@@ -434,6 +769,45 @@ void File::close (bool print) {
     }
   }
 #endif
+  return res;
+}
+
+/*------------------------------------------------------------------------*/
+
+const char *File::map (size_t &bytes) {
+  assert (file), assert (!writing), assert (!mapped);
+#ifdef _WIN32
+  (void) bytes;
+  return 0;
+#else
+  const int fd = fileno (file);
+  struct stat buf;
+  if (fd < 0 || fstat (fd, &buf) || !S_ISREG (buf.st_mode))
+    return 0;
+  const long pos = ftell (file);
+  if (pos < 0 || pos >= buf.st_size)
+    return 0;
+  void *p = mmap (0, buf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (p == MAP_FAILED)
+    return 0;
+  madvise (p, buf.st_size, MADV_SEQUENTIAL);
+  mapped = (char *) p;
+  mapped_bytes = buf.st_size;
+  bytes = mapped_bytes - pos;
+  return mapped + pos;
+#endif
+}
+
+void File::unmap (uint64_t lines) {
+  assert (mapped);
+#ifndef _WIN32
+  _bytes += mapped_bytes - ftell (file);
+  _lineno += lines;
+  fseek (file, 0, SEEK_END);
+  munmap (mapped, mapped_bytes);
+#endif
+  (void) lines;
+  mapped = 0;
 }
 
 void File::flush () {
@@ -25,7 +25,10 @@ namespace CaDiCaL {
 // Wraps a 'C' file 'FILE' with name and supports zipped reading and writing
 // through 'popen' using external helper tools.  Reading has line numbers.
 // Compression and decompression relies on external utilities, e.g., 'gzip',
-// 'bzip2', 'xz', and '7z', which should be in the 'PATH'.
+// 'bzip2', 'xz', 'zstd' and '7z', which should be in the 'PATH'.  If the
+// libraries 'zlib', 'liblzma' or 'zstd' are available at compile time,
+// the corresponding formats are decompressed in the process instead (and
+// with 'zstd' also compressed).
 
 struct Internal;
 
@@ -38,12 +41,15 @@ class File {
   bool writing;
 #endif
 
-  int close_file; // need to close file (1=fclose, 2=pclose, 3=pipe)
+  int close_file; // need to close file (1=fclose, 2=pclose, 3=pipe,
+                  // 4=decompressed, 5=compressed)
   int child_pid;
   FILE *file;
   const char *_name;
   uint64_t _lineno;
   uint64_t _bytes;
+  char *mapped;        // see 'map'
+  size_t mapped_bytes; // of the whole file
 
   File (Internal *, bool, int, int, FILE *, const char *);
 
@@ -58,6 +64,8 @@ class File {
                           const char *mode);
   static FILE *read_pipe (Internal *, const char *fmt, const int *sig,
                           const char *path);
+  static FILE *read_inflate (Internal *, const int *sig, const char *path);
+  static FILE *write_deflate (Internal *, const char *path);
 #ifndef __WIN32
   static FILE *write_pipe (Internal *, const char *fmt, const char *path,
                            int &child_pid);
@@ -191,13 +199,33 @@ public:
     }
   }
 
+  // Map the rest of a regular file into memory, e.g., to parse it in
+  // parallel.  Returns '0' if the file can not be mapped (such as pipes and
+  // decompressed files).  Otherwise 'bytes' is set to the number of bytes
+  // from the current position to the end of the file, which are skipped by
+  // 'unmap' as if read by 'get' (with that many new-lines).
+  //
+  const char *map (size_t &bytes);
+  void unmap (uint64_t lines);
+
   const char *name () const { return _name; }
   uint64_t lineno () const { return _lineno; }
   uint64_t bytes () const { return _bytes; }
 
   bool closed () { return !file; }
 
-  void close (bool print = false);
+  // Reading failed, e.g., since a compressed input is truncated.
+  //
+  bool failed () { return file && ferror (file); }
+
+  // Opened from a path (and thus not shared with other writers).
+  //
+  bool owned () const { return close_file; }
+
+  // Returns 'false' if closing failed, e.g., if the decompressor of an
+  // input pipe exited with an error since the input is truncated.
+  //
+  bool close (bool print = false);
   void flush ();
 };
 
@@ -18,17 +18,22 @@ Internal::Internal ()
       propagated (0), propagated2 (0), propergated (0), best_assigned (0),
       target_assigned (0), no_conflict_until (0), unsat_constraint (false),
       marked_failed (true), proof (0), checker (0), tracer (0),
-      lratchecker (0), lratbuilder (0), opts (this),
+      lratchecker (0), lratbuilder (0), deriver (0), opts (this),
 #ifndef QUIET
       profiles (this), force_phase_messages (false),
 #endif
       arena (this), prefix ("c "), internal (this), external (0),
-      termination_forced (false), vars (this->max_var),
-      lits (this->max_var) {
+      termination_forced (false), checkpointer (0),
+      checkpoint_failed (false), json_file (0), close_json_file (false),
+      vars (this->max_var), lits (this->max_var) {
   control.push_back (Level (0, 0));
+  memset (&json_reported, 0, sizeof json_reported);
 }
 
 Internal::~Internal () {
+  wait_for_checkpoint ();
+  if (close_json_file)
+    fclose (json_file);
   for (const auto &c : clauses)
     delete_clause (c);
   if (proof)
@@ -41,6 +46,8 @@ Internal::~Internal () {
     delete lratchecker;
   if (lratbuilder)
     delete lratbuilder;
+  if (deriver)
+    delete deriver;
   if (vals) {
     vals -= vsize;
     delete[] vals;
@@ -130,6 +137,42 @@ void Internal::enlarge (int new_max_var) {
   enlarge_zero (phases.min, new_vsize);
   enlarge_zero (marks, new_vsize);
   vsize = new_vsize;
+  if (opts.hugepages || opts.numa)
+    advise_tables ();
+}
+
+/*------------------------------------------------------------------------*/
+
+// Huge pages reduce the TLB misses of the random accesses to the large
+// tables and the arena, and with several solvers on a multi-socket machine
+// the memory of each solver should be on the node it runs on.  The watch
+// lists are allocated separately and thus too small for huge pages, but
+// with 'opts.numa' the solving thread prefers its node for all allocations
+// (see 'solve').
+
+void Internal::advise (void *p, size_t bytes) {
+  if (!opts.hugepages && !opts.numa)
+    return;
+  if (!advise_memory (p, bytes, opts.hugepages, opts.numa))
+    VERBOSE (3, "could not advise memory of %zd bytes", bytes);
+}
+
+void Internal::advise_tables () {
+  advise (unit_clauses);
+  advise (wtab);
+  advise (vtab);
+  advise (links);
+  advise (btab);
+  advise (ptab);
+  advise (ftab);
+  advise (vals - vsize, 2 * vsize);
+  advise (phases.saved);
+  advise (phases.target);
+  advise (phases.best);
+#ifdef COMPACT
+  if (opts.hugepages)
+    Arena::advise_heap ();
+#endif
 }
 
 void Internal::init_vars (int new_max_var) {
@@ -177,6 +220,8 @@ void Internal::add_original_lit (int lit) {
         proof->add_external_original_clause (id, external->eclause);
       else
         proof->add_external_original_clause (id, external->eclause);
+      if (deriver)
+        deriver->add_original_clause (id, external->eclause);
     }
     add_new_original_clause (id);
     original.clear ();
@@ -254,6 +299,8 @@ int Internal::cdcl_loop_with_inprocessing () {
       compact (); // collect variables
     else if (conditioning ())
       condition (); // globally blocked clauses
+    else if (checkpointing ())
+      checkpoint (); // save search state
     else
       res = decide (); // next decision
   }
@@ -407,6 +454,18 @@ void Internal::init_search_limits () {
 
   /*----------------------------------------------------------------------*/
 
+  if (incremental)
+    mode = "keeping";
+  else {
+    lim.checkpoint = stats.conflicts + opts.checkpointint;
+    mode = "initial";
+  }
+  (void) mode;
+  LOG ("%s checkpoint limit %" PRId64 " after %" PRId64 " conflicts", mode,
+       lim.checkpoint, lim.checkpoint - stats.conflicts);
+
+  /*----------------------------------------------------------------------*/
+
   // Initialize or reset 'rephase' limits in any case.
 
   lim.rephase = stats.conflicts + opts.rephaseint;
@@ -673,6 +732,8 @@ int Internal::solve (bool preprocess_only) {
   else
     LOG ("internal solving in full mode");
   init_report_limits ();
+  if (opts.numa && !prefer_local_memory ())
+    VERBOSE (3, "could not prefer memory of the local NUMA node");
   int res = already_solved ();
   if (!res)
     res = restore_clauses ();
@@ -827,6 +888,10 @@ void Internal::finalize () {
     if (!c->garbage || c->size == 2)
       proof->finalize_clause (c);
 
+  // finalize copies of original clauses kept to derive external clauses
+  if (deriver)
+    deriver->finalize ();
+
   // finalize conflict and proof
   if (conflict_id)
     proof->finalize_clause (conflict_id, {});
@@ -841,6 +906,8 @@ void Internal::print_statistics () {
   stats.print (this);
   if (checker)
     checker->print_stats ();
+  if (deriver)
+    deriver->print_stats ();
 }
 
 /*------------------------------------------------------------------------*/
@@ -33,6 +33,7 @@ extern "C" {
 #include <algorithm>
 #include <queue>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 /*------------------------------------------------------------------------*/
@@ -56,6 +57,7 @@ extern "C" {
 #include "contract.hpp"
 #include "cover.hpp"
 #include "decompose.hpp"
+#include "deriver.hpp"
 #include "elim.hpp"
 #include "ema.hpp"
 #include "external.hpp"
@@ -84,6 +86,7 @@ extern "C" {
 #include "reap.hpp"
 #include "reluctant.hpp"
 #include "resources.hpp"
+#include "ring.hpp"
 #include "score.hpp"
 #include "stats.hpp"
 #include "terminal.hpp"
@@ -239,6 +242,7 @@ struct Internal {
   Tracer *tracer;           // proof to file tracer observing proof
   LratChecker *lratchecker; // online lrat checker observing proof
   LratBuilder *lratbuilder; // lrat proof chain builder observing proof
+  Deriver *deriver;         // derives external clauses for the proof
   Options opts;             // run-time options
   Stats stats;              // statistics
 #ifndef QUIET
@@ -261,6 +265,28 @@ struct Internal {
 
   /*----------------------------------------------------------------------*/
 
+  // Checkpoints are written by a background thread (see 'checkpoint.cpp')
+  // which owns the serialized 'checkpoint_bytes' until it is joined.
+  //
+  string checkpoint_path;              // write checkpoints if non-empty
+  string checkpoint_bytes;             // checkpoint being written
+  std::thread *checkpointer;           // background writer of checkpoints
+  std::atomic<bool> checkpoint_failed; // set by the writer on errors
+
+  /*----------------------------------------------------------------------*/
+
+  // Machine-readable report lines (one JSON object per 'report') for
+  // monitoring, written by 'report_json' in 'report.cpp'.
+  //
+  FILE *json_file;      // write JSON report lines if non-zero
+  bool close_json_file; // opened by 'Solver::report_json'
+  struct {
+    double time;
+    int64_t conflicts, decisions, propagations;
+  } json_reported; // counters at the previous JSON report line
+
+  /*----------------------------------------------------------------------*/
+
   const Range vars; // Provides safe variable iteration.
   const Sange lits; // Provides safe literal iteration.
 
@@ -292,6 +318,15 @@ struct Internal {
   void enlarge_vals (size_t new_vsize);
   void enlarge (int new_max_var);
 
+  // Huge pages and NUMA placement of large tables ('opts.hugepages' and
+  // 'opts.numa', see 'advise_memory' in 'resources.hpp').
+  //
+  void advise (void *, size_t bytes);
+  template <class T> void advise (vector<T> &v) {
+    advise (v.data (), v.size () * sizeof (T));
+  }
+  void advise_tables ();
+
   // A variable is 'active' if it is not eliminated nor fixed.
   //
   bool active (int lit) { return flags (lit).active (); }
@@ -562,7 +597,8 @@ struct Internal {
   void delete_clause (Clause *);
   void mark_garbage (Clause *);
   void assign_original_unit (uint64_t, int);
-  void add_new_original_clause (uint64_t);
+  void add_new_original_clause (uint64_t, bool redundant = false,
+                                int glue = 0);
   Clause *new_learned_redundant_clause (int glue);
   Clause *new_hyper_binary_resolved_clause (bool red, int glue);
   Clause *new_clause_as (const Clause *orig);
@@ -709,6 +745,15 @@ struct Internal {
   void unprotect_reasons ();
   void reduce ();
 
+  // Periodically writing checkpoints of the search in 'checkpoint.cpp' and
+  // restoring them through 'resume'.
+  //
+  bool checkpointing ();
+  void checkpoint ();
+  void write_checkpoint ();
+  void wait_for_checkpoint ();
+  const char *resume (const char *path);
+
   // Garbage collection in 'collect.cpp' called from 'reduce' and during
   // inprocessing and preprocessing.
   //
@@ -1292,6 +1337,7 @@ struct Internal {
   // Regularly reports what is going on in 'report.cpp'.
   //
   void report (char type, int verbose_level = 0);
+  void report_json (char type);
   void report_solving (int);
 
   void print_statistics ();
@@ -1358,6 +1404,7 @@ struct Internal {
 
   // Warning messages.
   //
+  void vwarning (const char *, va_list &);
   void warning (const char *, ...) CADICAL_ATTRIBUTE_FORMAT (2, 3);
 };
 
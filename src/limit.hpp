@@ -12,17 +12,18 @@ struct Limit {
   int64_t preprocessing; // limit on preprocessing rounds
   int64_t localsearch;   // limit on local search rounds
 
-  int64_t compact;   // conflict limit for next 'compact'
-  int64_t condition; // conflict limit for next 'condition'
-  int64_t elim;      // conflict limit for next 'elim'
-  int64_t flush;     // conflict limit for next 'flush'
-  int64_t probe;     // conflict limit for next 'probe'
-  int64_t reduce;    // conflict limit for next 'reduce'
-  int64_t rephase;   // conflict limit for next 'rephase'
-  int64_t report;    // report limit for header
-  int64_t restart;   // conflict limit for next 'restart'
-  int64_t stabilize; // conflict limit for next 'stabilize'
-  int64_t subsume;   // conflict limit for next 'subsume'
+  int64_t checkpoint; // conflict limit for next 'checkpoint'
+  int64_t compact;    // conflict limit for next 'compact'
+  int64_t condition;  // conflict limit for next 'condition'
+  int64_t elim;       // conflict limit for next 'elim'
+  int64_t flush;      // conflict limit for next 'flush'
+  int64_t probe;      // conflict limit for next 'probe'
+  int64_t reduce;     // conflict limit for next 'reduce'
+  int64_t rephase;    // conflict limit for next 'rephase'
+  int64_t report;     // report limit for header
+  int64_t restart;    // conflict limit for next 'restart'
+  int64_t stabilize;  // conflict limit for next 'stabilize'
+  int64_t subsume;    // conflict limit for next 'subsume'
 
   int keptsize; // maximum kept size in 'reduce'
   int keptglue; // maximum kept glue in 'reduce'
@@ -0,0 +1,449 @@
+// Stand alone parallel checker of binary LRAT proofs, e.g., for certifying
+// the proofs of many unsatisfiable cubes offline.
+
+#include "internal.hpp"
+
+#include <atomic>
+#include <thread>
+
+namespace CaDiCaL {
+
+static const char *USAGE =
+    "usage: lratcheck [ <option> ... ] <dimacs> <proof>\n"
+    "\n"
+    "where '<option>' can be one of the following:\n"
+    "\n"
+    "  --help | -h    print this command line option summary and exit\n"
+    "  -q             do not print statistics\n"
+    "  -t <threads>   number of checking threads (default all cores)\n"
+    "\n"
+    "The proof has to be in the binary LRAT format written by 'cadical'\n"
+    "with '--lrat' (or '-' to read it from '<stdin>', e.g., after\n"
+    "decompressing it with 'zstd -d -c').  Each added clause has to be\n"
+    "implied by unit propagation over its proof chain, as checked by\n"
+    "the internal LRAT checker ('--checkprooflrat').  As the proof chain\n"
+    "names all the antecedents, these checks are independent of each\n"
+    "other once the proof is read and thus are distributed over the\n"
+    "threads.  The exit code is '0' if the proof is correct and derives\n"
+    "the empty clause ('s VERIFIED') and '1' otherwise.\n";
+
+/*------------------------------------------------------------------------*/
+
+static void die (const char *fmt, ...) CADICAL_ATTRIBUTE_FORMAT (1, 2);
+
+static void die (const char *fmt, ...) {
+  fflush (stdout);
+  fputs ("lratcheck: error: ", stderr);
+  va_list ap;
+  va_start (ap, fmt);
+  vfprintf (stderr, fmt, ap);
+  va_end (ap);
+  fputc ('\n', stderr);
+  exit (1);
+}
+
+/*------------------------------------------------------------------------*/
+
+class LratCheck {
+
+  // All the clauses by identifier, the original clauses first.  A clause
+  // can be used in the proof chains of the steps after the one adding it
+  // ('added', '0' for original clauses) until its deletion ('deleted' is
+  // the first step for which it is no longer available).
+  //
+  struct Clause {
+    uint64_t literals = 0; // offset in 'literals'
+    unsigned size = 0;
+    bool exists = false;
+    int64_t added = 0, deleted = INT64_MAX;
+  };
+  vector<Clause> clauses;
+  vector<int> literals;
+
+  // The added clauses in proof order (starting with step '1').
+  //
+  struct Step {
+    uint64_t id;
+    uint64_t chain; // offset in 'chains'
+    unsigned length;
+  };
+  vector<Step> steps;
+  vector<uint64_t> chains;
+
+  int max_var = 0;
+  bool empty = false; // derived the empty clause
+
+  FILE *file = 0;
+  const char *path = 0;
+  bool binary = false; // errors at byte offsets instead of lines
+  uint64_t lineno = 1, bytes = 0;
+
+  // First failed step (checked in parallel).
+  //
+  std::atomic<int64_t> failed;
+
+  int next () {
+    int res = getc_unlocked (file);
+    if (res == '\n')
+      lineno++;
+    if (res != EOF)
+      bytes++;
+    return res;
+  }
+
+  void error (const char *fmt, ...) CADICAL_ATTRIBUTE_FORMAT (2, 3);
+
+  Clause &clause (uint64_t id) {
+    if (id >= clauses.size ())
+      clauses.resize (max (id + 1, 2 * clauses.size ()));
+    return clauses[id];
+  }
+
+  void add_clause (uint64_t id, const vector<int> &, int64_t step);
+  bool read_varint (uint64_t &); // 'false' for the terminating zero
+
+  bool check (const Step &, vector<signed char> &, vector<int> &);
+  void check_range (size_t threads, unsigned thread);
+
+public:
+  LratCheck () : failed (INT64_MAX) {}
+
+  void parse_dimacs (const char *path);
+  void parse_proof (const char *path);
+  bool check (unsigned threads);
+
+  size_t num_steps () const { return steps.size (); }
+  size_t num_hints () const { return chains.size (); }
+  uint64_t num_bytes () const { return bytes; }
+};
+
+void LratCheck::error (const char *fmt, ...) {
+  fflush (stdout);
+  if (binary)
+    fprintf (stderr, "lratcheck: error: %s: byte %" PRIu64 ": ", path,
+             bytes);
+  else
+    fprintf (stderr, "lratcheck: error: %s:%" PRIu64 ": ", path, lineno);
+  va_list ap;
+  va_start (ap, fmt);
+  vfprintf (stderr, fmt, ap);
+  va_end (ap);
+  fputc ('\n', stderr);
+  exit (1);
+}
+
+void LratCheck::add_clause (uint64_t id, const vector<int> &c,
+                            int64_t step) {
+  Clause &d = clause (id);
+  if (d.exists)
+    error ("clause %" PRIu64 " added twice", id);
+  d.exists = true;
+  d.literals = literals.size ();
+  d.size = c.size ();
+  d.added = step;
+  for (const auto &lit : c) {
+    literals.push_back (lit);
+    max_var = max (max_var, abs (lit));
+  }
+}
+
+/*------------------------------------------------------------------------*/
+
+// The original clauses get the identifiers '1', '2', ... in the order of
+// the DIMACS file (as in the solver).
+
+void LratCheck::parse_dimacs (const char *p) {
+  path = p;
+  if (!(file = fopen (path, "r")))
+    die ("can not read DIMACS file '%s'", path);
+  int ch;
+  while ((ch = next ()) == 'c')
+    while ((ch = next ()) != '\n')
+      if (ch == EOF)
+        error ("unexpected end-of-file in comment");
+  int vars, expected;
+  if (ch != 'p' || fscanf (file, " cnf %d %d", &vars, &expected) != 2)
+    error ("expected 'p cnf <vars> <clauses>' header");
+  clauses.resize (expected + 1);
+  vector<int> c;
+  uint64_t id = 0;
+  for (;;) {
+    ch = next ();
+    if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n')
+      continue;
+    if (ch == EOF)
+      break;
+    if (ch == 'c') {
+      while ((ch = next ()) != '\n' && ch != EOF)
+        ;
+      continue;
+    }
+    int sign = 1;
+    if (ch == '-') {
+      sign = -1;
+      ch = next ();
+    }
+    if (!isdigit (ch))
+      error ("expected literal");
+    int64_t lit = ch - '0';
+    while (isdigit (ch = next ()))
+      if ((lit = 10 * lit + (ch - '0')) > INT_MAX)
+        error ("literal too large");
+    if (ch != ' ' && ch != '\t' && ch != '\r' && ch != '\n' && ch != EOF)
+      error ("expected white space after literal");
+    if (lit)
+      c.push_back (sign * lit);
+    else {
+      if (c.empty ())
+        empty = true;
+      add_clause (++id, c, 0), c.clear ();
+    }
+  }
+  if (!c.empty ())
+    error ("last clause without terminating '0'");
+  if (id != (uint64_t) expected)
+    error ("found %" PRIu64 " clauses but expected %d", id, expected);
+  fclose (file);
+}
+
+/*------------------------------------------------------------------------*/
+
+// Numbers are encoded with 7 bits per byte (least significant first) and
+// the most significant bit set in all but the last byte.
+
+bool LratCheck::read_varint (uint64_t &res) {
+  res = 0;
+  for (unsigned shift = 0;; shift += 7) {
+    int ch = next ();
+    if (ch == EOF)
+      error ("unexpected end-of-file in number");
+    if (shift > 63)
+      error ("number too large");
+    res |= (uint64_t) (ch & 0x7f) << shift;
+    if (!(ch & 0x80))
+      return res != 0;
+  }
+}
+
+// The binary format of 'Tracer::lrat_add_clause' is 'a', the identifier,
+// the literals (as '2 * var + sign'), '0', the proof chain (as '2 * id')
+// and '0', while deletions are 'd' followed by '2 * id' and '0'.
+
+void LratCheck::parse_proof (const char *p) {
+  path = p;
+  binary = true, bytes = 0;
+  if (!strcmp (path, "-"))
+    file = stdin, path = "<stdin>";
+  else if (!(file = fopen (path, "rb")))
+    die ("can not read proof file '%s'", path);
+  vector<int> c;
+  int ch;
+  while ((ch = next ()) != EOF) {
+    uint64_t x;
+    if (ch == 'd') {
+      const int64_t step = steps.size () + 1;
+      while (read_varint (x)) {
+        if (x & 1)
+          error ("negative identifier in deletion");
+        const uint64_t id = x / 2;
+        Clause &d = clause (id);
+        if (!d.exists || d.deleted != INT64_MAX)
+          error ("deleted clause %" PRIu64 " does not exist", id);
+        d.deleted = step;
+      }
+    } else if (ch == 'a') {
+      uint64_t id;
+      if (!read_varint (id))
+        error ("invalid identifier '0'");
+      c.clear ();
+      while (read_varint (x)) {
+        if (x / 2 > INT_MAX)
+          error ("literal too large");
+        const int idx = x / 2;
+        c.push_back ((x & 1) ? -idx : idx);
+      }
+      const int64_t step = steps.size () + 1;
+      add_clause (id, c, step);
+      Step s = {id, chains.size (), 0};
+      while (read_varint (x)) {
+        if (x & 1)
+          error ("RAT steps (negative hints) are not supported");
+        chains.push_back (x / 2);
+        s.length++;
+      }
+      steps.push_back (s);
+      if (c.empty ())
+        empty = true;
+    } else if (isdigit (ch))
+      error ("expected binary LRAT proof (not ASCII)");
+    else
+      error ("expected 'a' or 'd'");
+  }
+  if (file != stdin)
+    fclose (file);
+}
+
+/*------------------------------------------------------------------------*/
+
+// Reverse unit propagation over the proof chain as in 'LratChecker::check'
+// with thread local 'values' (reset afterwards through 'trail').
+
+bool LratCheck::check (const Step &step, vector<signed char> &values,
+                       vector<int> &trail) {
+  const int64_t position = &step - steps.data () + 1;
+  const Clause &added = clauses[step.id];
+  auto val = [&] (int lit) -> signed char & {
+    return values[2u * abs (lit) + (lit < 0)];
+  };
+  auto assign = [&] (int lit) {
+    val (lit) = 1, val (-lit) = -1;
+    trail.push_back (lit);
+  };
+  bool res = false, tautological = false;
+  for (unsigned i = 0; i < added.size; i++) {
+    const int lit = literals[added.literals + i];
+    if (val (lit) < 0)
+      continue;
+    if (val (lit) > 0)
+      tautological = true;
+    else
+      assign (-lit);
+  }
+  if (tautological)
+    res = !step.length;
+  else
+    for (unsigned i = 0; i < step.length; i++) {
+      const uint64_t id = chains[step.chain + i];
+      if (id >= clauses.size ())
+        break;
+      const Clause &c = clauses[id];
+      if (!c.exists || c.added >= position || c.deleted <= position)
+        break;
+      int unit = 0;
+      for (unsigned j = 0; j < c.size; j++) {
+        const int lit = literals[c.literals + j];
+        if (val (lit) < 0)
+          continue;
+        if (unit && unit != lit) {
+          unit = INT_MIN;
+          break;
+        }
+        unit = lit;
+      }
+      if (unit == INT_MIN)
+        break;
+      if (!unit) {
+        res = true;
+        break;
+      }
+      if (!val (unit))
+        assign (unit);
+    }
+  for (const auto &lit : trail)
+    val (lit) = val (-lit) = 0;
+  trail.clear ();
+  return res;
+}
+
+// Steps are checked in blocks, distributed round robin over the threads.
+
+void LratCheck::check_range (size_t threads, unsigned thread) {
+  const size_t block = 1024;
+  vector<signed char> values (2 * (max_var + 1u));
+  vector<int> trail;
+  for (size_t begin = thread * block; begin < steps.size ();
+       begin += threads * block) {
+    const size_t end = min (steps.size (), begin + block);
+    if ((int64_t) begin >= failed)
+      return;
+    for (size_t i = begin; i < end; i++)
+      if (!check (steps[i], values, trail)) {
+        int64_t expected = failed;
+        while ((int64_t) i < expected &&
+               !failed.compare_exchange_weak (expected, i))
+          ;
+        return;
+      }
+  }
+}
+
+bool LratCheck::check (unsigned threads) {
+  vector<std::thread> workers;
+  for (unsigned i = 1; i < threads; i++)
+    workers.emplace_back (&LratCheck::check_range, this, threads, i);
+  check_range (threads, 0);
+  for (auto &worker : workers)
+    worker.join ();
+  if (failed != INT64_MAX) {
+    const Step &step = steps[failed];
+    const Clause &c = clauses[step.id];
+    printf ("c failed to check clause %" PRIu64 ":", step.id);
+    for (unsigned i = 0; i < c.size; i++)
+      printf (" %d", literals[c.literals + i]);
+    printf (" 0\n");
+    return false;
+  }
+  if (!empty)
+    printf ("c all steps checked but no empty clause derived\n");
+  return empty;
+}
+
+} // namespace CaDiCaL
+
+/*------------------------------------------------------------------------*/
+
+using namespace CaDiCaL;
+
+int main (int argc, char **argv) {
+  const char *dimacs = 0, *proof = 0;
+  unsigned threads = 0;
+  bool quiet = false;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp (argv[i], "-h") || !strcmp (argv[i], "--help")) {
+      fputs (USAGE, stdout);
+      return 0;
+    } else if (!strcmp (argv[i], "-q"))
+      quiet = true;
+    else if (!strcmp (argv[i], "-t")) {
+      if (++i == argc || atoi (argv[i]) <= 0)
+        die ("expected positive number of threads after '-t'");
+      threads = atoi (argv[i]);
+    } else if (argv[i][0] == '-' && argv[i][1])
+      die ("invalid option '%s' (try '-h')", argv[i]);
+    else if (!dimacs)
+      dimacs = argv[i];
+    else if (!proof)
+      proof = argv[i];
+    else
+      die ("too many arguments (try '-h')");
+  }
+  if (!proof)
+    die ("expected DIMACS and proof file (try '-h')");
+  if (!threads)
+    threads = max (1u, std::thread::hardware_concurrency ());
+
+  LratCheck checker;
+  const double start = absolute_real_time ();
+  checker.parse_dimacs (dimacs);
+  checker.parse_proof (proof);
+  const double parsed = absolute_real_time ();
+  const bool verified = checker.check (threads);
+  const double end = absolute_real_time ();
+
+  if (!quiet) {
+    const double mb = checker.num_bytes () / (double) (1 << 20);
+    printf ("c parsed %.1f MB proof in %.2f seconds (%.1f MB/sec)\n", mb,
+            parsed - start, mb / max (parsed - start, 1e-9));
+    printf ("c checked %zd steps with %zd hints in %.2f seconds "
+            "with %u threads\n",
+            checker.num_steps (), checker.num_hints (), end - parsed,
+            threads);
+    printf ("c %.0f steps/sec %.0f hints/sec\n",
+            checker.num_steps () / max (end - parsed, 1e-9),
+            checker.num_hints () / max (end - parsed, 1e-9));
+    printf ("c maximum resident set size %.1f MB\n",
+            maximum_resident_set_size () / (double) (1 << 20));
+  }
+  printf ("s %s\n", verified ? "VERIFIED" : "NOT VERIFIED");
+  return !verified;
+}
@@ -133,7 +133,7 @@ void Internal::phase (const char *phase, int64_t count, const char *fmt,
 #endif // ifndef QUIET
 /*------------------------------------------------------------------------*/
 
-void Internal::warning (const char *fmt, ...) {
+void Internal::vwarning (const char *fmt, va_list &ap) {
   fflush (stdout);
   terr.bold ();
   fputs ("cadical: ", stderr);
@@ -141,14 +141,18 @@ void Internal::warning (const char *fmt, ...) {
   fputs ("warning:", stderr);
   terr.normal ();
   fputc (' ', stderr);
-  va_list ap;
-  va_start (ap, fmt);
   vfprintf (stderr, fmt, ap);
-  va_end (ap);
   fputc ('\n', stderr);
   fflush (stderr);
 }
 
+void Internal::warning (const char *fmt, ...) {
+  va_list ap;
+  va_start (ap, fmt);
+  vwarning (fmt, ap);
+  va_end (ap);
+}
+
 /*------------------------------------------------------------------------*/
 
 void Internal::error_message_start () {
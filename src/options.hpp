@@ -38,6 +38,7 @@ OPTION( checkassumptions,  1,  0,  1,0,0,0, "check assumptions satisfied") \
 OPTION( checkconstraint,   1,  0,  1,0,0,0, "check constraint satisfied") \
 OPTION( checkfailed,       1,  0,  1,0,0,0, "check failed literals form core") \
 OPTION( checkfrozen,       0,  0,  1,0,0,0, "check all frozen semantics") \
+OPTION( checkpointint,   1e5,  1,2e9,0,0,1, "checkpoint interval") \
 OPTION( checkproof,        1,  0,  1,0,0,0, "check proof internally") \
 OPTION( checkprooflrat,    1,  0,  1,0,0,0, "use internal LRAT proof checker") \
 OPTION( checkwitness,      1,  0,  1,0,0,0, "check witness internally") \
@@ -97,6 +98,7 @@ OPTION( flush,             0,  0,  1,0,0,1, "flush redundant clauses") \
 OPTION( flushfactor,       3,  1,1e3,0,0,1, "interval increase") \
 OPTION( flushint,        1e5,  1,2e9,0,0,1, "initial limit") \
 OPTION( forcephase,        0,  0,  1,0,0,1, "always use initial phase") \
+OPTION( hugepages,         0,  0,  1,0,0,1, "huge pages for large tables") \
 OPTION( inprocessing,      1,  0,  1,0,0,1, "enable inprocessing") \
 OPTION( instantiate,       0,  0,  1,0,1,1, "variable instantiation") \
 OPTION( instantiateclslim, 3,  2,2e9,0,0,1, "minimum clause size") \
@@ -111,7 +113,11 @@ OPTION( lratveripb,        0,  0,  1,0,0,1, "veriPB proofs. needs lrat=1") \
 OPTION( lucky,             1,  0,  1,0,0,1, "search for lucky phases") \
 OPTION( minimize,          1,  0,  1,0,0,1, "minimize learned clauses") \
 OPTION( minimizedepth,   1e3,  0,1e3,0,0,1, "minimization depth") \
+OPTION( numa,              0,  0,  1,0,0,1, "memory on local NUMA node") \
 OPTION( otfs,              1,  0,  1,0,0,1, "on-the-fly self subsumption") \
+OPTION( parsemap,          1,  0,  1,0,0,1, "parse mapped files in parallel") \
+OPTION( parsemapchunk,   1e6,  1,2e9,0,0,1, "minimum bytes per thread") \
+OPTION( parsemapthreads,   0,  0,256,0,0,1, "parse threads (0=all cores)") \
 OPTION( phase,             1,  0,  1,0,0,1, "initial phase") \
 OPTION( probe,             1,  0,  1,0,1,1, "failed literal probing" ) \
 OPTION( probehbr,          1,  0,  1,0,0,1, "learn hyper binary clauses") \
@@ -121,6 +127,12 @@ OPTION( probemineff,     1e6,  0,2e9,1,0,1, "minimum probing efficiency") \
 OPTION( probereleff,      20,  1,1e5,1,0,1, "relative efficiency per mille") \
 OPTION( proberounds,       1,  1, 16,1,0,1, "probing rounds" ) \
 OPTION( profile,           2,  0,  4,0,0,0, "profiling level") \
+OPTION( proofexternal,     0,  0,  1,0,0,1, "derive external clauses") \
+OPTION( proofexternalmax,1e5,  0,2e9,0,0,1, "maximum derivation steps") \
+OPTION( proofqueue,        0,  0,  1,0,0,1, "write proof in background") \
+OPTION( proofqueuesize,   16,  1,1e3,0,0,1, "proof queue size in MB") \
+OPTION( propbinfirst,      0,  0,  1,0,0,1, "binary clauses first") \
+OPTION( propprefetch,      0,  0, 64,0,0,1, "clause prefetch distance") \
 QUTOPT( quiet,             0,  0,  1,0,0,0, "disable all messages") \
 OPTION( radixsortlim,    800,  0,2e9,0,0,1, "radix sort limit") \
 OPTION( realtime,          0,  0,  1,0,0,0, "real instead of process time") \
@@ -1,20 +1,24 @@
 #include "internal.hpp"
 #include "sha256/sha256.hpp"
 
+#include <thread>
+
 /*------------------------------------------------------------------------*/
 
 namespace CaDiCaL {
 
 /*------------------------------------------------------------------------*/
 
-// Parse error.
+// Parse error (at the current line or at line 'LINE').
+
+#define PERL(LINE, ...) \
+  (internal->error_message.init ("%s:%" PRIu64 ": parse error: ", \
+                                 file->name (), (uint64_t) (LINE)), \
+   internal->error_message.append (__VA_ARGS__))
 
 #define PER(...) \
   do { \
-    internal->error_message.init ( \
-        "%s:%" PRIu64 ": parse error: ", file->name (), \
-        (uint64_t) file->lineno ()); \
-    return internal->error_message.append (__VA_ARGS__); \
+    return PERL (file->lineno (), __VA_ARGS__); \
   } while (0)
 
 /*------------------------------------------------------------------------*/
@@ -87,6 +91,175 @@ inline const char *Parser::parse_lit (int &ch, int &lit, int &vars,
 
 /*------------------------------------------------------------------------*/
 
+// Parsing the clauses of a memory mapped DIMACS file in parallel.  The
+// clauses are split into chunks at new-lines, which are tokenized by one
+// thread each exactly as by the sequential loop in 'parse_dimacs' below.
+// Then the literals and comment lines are added in the original order.
+
+struct ParseChunk {
+  const unsigned char *begin, *end;
+  vector<int> lits;
+  vector<pair<size_t, string>> comments; // after that many literals
+  uint64_t lines = 0;                    // new-lines read so far
+  int vars;                              // maximum variable
+  const char *error = 0;                 // 'cube_token' or 'message'
+  char message[80];
+};
+
+// Tokenize a chunk until the end, the first error or 'zeros' clauses.
+
+static void parse_chunk (ParseChunk &c, bool forced, size_t zeros = 0) {
+  const unsigned char *p = c.begin;
+  auto next = [&] () {
+    if (p == c.end)
+      return EOF;
+    int res = *p++;
+    if (res == '\n')
+      c.lines++;
+    return res;
+  };
+#define CER(...) \
+  do { \
+    snprintf (c.message, sizeof c.message, __VA_ARGS__); \
+    c.error = c.message; \
+    return; \
+  } while (0)
+  int ch;
+  while ((ch = next ()) != EOF) {
+    if (ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r')
+      continue;
+    if (ch == 'c') {
+      const unsigned char *start = p;
+      while ((ch = next ()) != '\n' && ch != EOF)
+        ;
+      const size_t bytes = p - start - (ch == '\n');
+      c.comments.emplace_back (c.lits.size (),
+                               string ((const char *) start, bytes));
+      if (ch == EOF)
+        break;
+      continue;
+    }
+    if (ch == 'a') {
+      c.error = cube_token;
+      return;
+    }
+    int sign, lit;
+    if (ch == '-') {
+      if (!isdigit (ch = next ()))
+        CER ("expected digit after '-'");
+      sign = -1;
+    } else if (!isdigit (ch))
+      CER ("expected digit or '-'");
+    else
+      sign = 1;
+    lit = ch - '0';
+    while (isdigit (ch = next ())) {
+      int digit = ch - '0';
+      if (INT_MAX / 10 < lit || INT_MAX - digit < 10 * lit)
+        CER ("literal too large");
+      lit = 10 * lit + digit;
+    }
+    if (ch == '\r')
+      ch = next ();
+    if (ch != 'c' && ch != ' ' && ch != '\t' && ch != '\n' && ch != EOF)
+      CER ("expected white space after '%d'", sign * lit);
+    if (lit > c.vars) {
+      if (!forced)
+        CER ("literal %d exceeds maximum variable %d", sign * lit, c.vars);
+      c.vars = lit;
+    }
+    if (ch == 'c') {
+      while ((ch = next ()) != '\n')
+        if (ch == EOF)
+          CER ("unexpected end-of-file in comment");
+    }
+    c.lits.push_back (sign * lit);
+    if (!lit && zeros && !--zeros)
+      return;
+  }
+#undef CER
+}
+
+const char *Parser::parse_mapped (const char *mapped, size_t bytes,
+                                  int &vars, int strict, int clauses,
+                                  int &lit, int &parsed) {
+  const unsigned char *begin = (const unsigned char *) mapped;
+  const unsigned char *end = begin + bytes;
+  const bool forced = (strict == FORCED);
+
+  size_t threads = internal->opts.parsemapthreads;
+  if (!threads)
+    threads = max (1u, std::thread::hardware_concurrency ());
+  const size_t chunk = internal->opts.parsemapchunk;
+  threads = min (threads, bytes / chunk + 1);
+
+  // Split at the first new-line after the (even) share of each thread.
+  //
+  vector<ParseChunk> chunks (threads);
+  const unsigned char *p = begin;
+  for (size_t i = 0; i < threads; i++) {
+    auto &c = chunks[i];
+    c.begin = p;
+    if (i + 1 == threads)
+      p = end;
+    else if ((p = begin + (i + 1) * (bytes / threads)) < c.begin)
+      p = c.begin;
+    while (p != end && *p++ != '\n')
+      ;
+    c.end = p;
+    c.vars = vars;
+  }
+  MSG ("parsing %zd bytes of clauses in %zd chunks", bytes, threads);
+
+  vector<std::thread> workers;
+  for (size_t i = 1; i < threads; i++)
+    workers.emplace_back (parse_chunk, std::ref (chunks[i]), forced, 0);
+  parse_chunk (chunks[0], forced);
+  for (auto &worker : workers)
+    worker.join ();
+
+  // Add the clauses in order and report the first error (as sequential
+  // parsing would, that is, at the same line).
+  //
+  const uint64_t first = file->lineno ();
+  uint64_t lines = 0;
+  const char *err = 0;
+  for (auto &c : chunks) {
+    auto comment = c.comments.begin ();
+    size_t zeros = 0;
+    for (size_t i = 0; !err && i <= c.lits.size (); i++) {
+      for (; comment != c.comments.end () && comment->first == i;
+           comment++)
+        SHA256::Propagator::parse_comment_line (comment->second, solver);
+      if (i == c.lits.size ())
+        break;
+      solver->add (lit = c.lits[i]);
+      if (!lit)
+        zeros++;
+      if (!lit && parsed++ >= clauses && !forced) {
+        // Find the line of this clause by tokenizing the chunk again.
+        ParseChunk prefix;
+        prefix.begin = c.begin, prefix.end = c.end, prefix.vars = vars;
+        parse_chunk (prefix, forced, zeros);
+        err = PERL (first + lines + prefix.lines, "too many clauses");
+      }
+    }
+    if (!err && c.error == cube_token)
+      err = cube_token;
+    else if (!err && c.error)
+      err = PERL (first + lines + c.lines, "%s", c.error);
+    lines += c.lines;
+    if (err)
+      break;
+    if (c.vars > vars)
+      vars = c.vars;
+  }
+  file->unmap (lines);
+  return err;
+}
+
+/*------------------------------------------------------------------------*/
+
 // Parsing CNF in DIMACS format.
 
 const char *Parser::parse_dimacs_non_profiled (int &vars, int strict) {
@@ -235,7 +408,18 @@ const char *Parser::parse_dimacs_non_profiled (int &vars, int strict) {
   // Now read body of DIMACS part.
   //
   int lit = 0, parsed = 0;
-  while ((ch = parse_char ()) != EOF) {
+  const char *mapped = 0;
+  size_t bytes = 0;
+  if (!found_inccnf_header && internal->opts.parsemap)
+    mapped = file->map (bytes);
+  if (mapped) {
+    const char *err =
+        parse_mapped (mapped, bytes, vars, strict, clauses, lit, parsed);
+    if (err)
+      return err;
+    ch = EOF;
+  }
+  while (!mapped && (ch = parse_char ()) != EOF) {
     if (ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r')
       continue;
     if (ch == 'c') {
@@ -426,6 +610,10 @@ const char *Parser::parse_dimacs (int &vars, int strict) {
   assert (strict == FORCED || strict == RELAXED || strict == STRICT);
   START (parse);
   const char *err = parse_dimacs_non_profiled (vars, strict);
+  // Decompressors in input pipes only report errors by their exit code.
+  if (file->failed () || (!err && file->owned () && !file->close ()))
+    err = internal->error_message.init (
+        "can not read '%s' (truncated or corrupted)", file->name ());
   STOP (parse);
   return err;
 }
@@ -433,6 +621,9 @@ const char *Parser::parse_dimacs (int &vars, int strict) {
 const char *Parser::parse_solution () {
   START (parse);
   const char *err = parse_solution_non_profiled ();
+  if (file->failed ())
+    err = internal->error_message.init (
+        "can not read '%s' (truncated or corrupted)", file->name ());
   STOP (parse);
   return err;
 }
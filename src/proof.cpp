@@ -13,6 +13,11 @@ void Internal::new_proof_on_demand () {
     proof = new Proof (this);
     LOG ("connecting proof to internal solver");
     build_full_lrat ();
+    if (opts.proofexternal) {
+      deriver = new Deriver (this);
+      LOG ("PROOF connecting external clause deriver");
+      proof->connect (deriver);
+    }
   }
 }
 
@@ -70,7 +75,7 @@ void Internal::flush_trace (bool print) {
 
 Proof::Proof (Internal *s)
     : internal (s), checker (0), tracer (0), lratbuilder (0),
-      lratchecker (0) {
+      lratchecker (0), deriver (0) {
   LOG ("PROOF new");
 }
 
@@ -203,6 +208,20 @@ void Proof::add_derived_clause (uint64_t id, const vector<int> &c,
   add_derived_clause ();
 }
 
+void Proof::add_external_derived_clause (uint64_t id,
+                                         const vector<int> &c,
+                                         const vector<uint64_t> &chain) {
+  // literals of c are already external
+  assert (clause.empty ());
+  assert (proof_chain.empty ());
+  for (auto const &lit : c)
+    clause.push_back (lit);
+  for (const auto &cid : chain)
+    proof_chain.push_back (cid);
+  clause_id = id;
+  add_derived_clause ();
+}
+
 void Proof::delete_clause (Clause *c) {
   LOG (c, "PROOF deleting from proof");
   assert (clause.empty ());
@@ -244,6 +263,15 @@ void Proof::finalize_clause (uint64_t id, const vector<int> &c) {
   finalize_clause ();
 }
 
+void Proof::finalize_external_clause (uint64_t id, const vector<int> &c) {
+  LOG (c, "PROOF finalizing external clause");
+  assert (clause.empty ());
+  for (const auto &lit : c)
+    clause.push_back (lit);
+  clause_id = id;
+  finalize_clause ();
+}
+
 void Proof::finalize_unit (uint64_t id, int lit) {
   LOG ("PROOF finalizing clause %d", lit);
   assert (clause.empty ());
@@ -422,6 +450,8 @@ void Proof::add_derived_clause () {
 
 void Proof::delete_clause () {
   LOG (clause, "PROOF deleting external clause");
+  if (deriver)
+    copy_clause ();
   if (lratbuilder)
     lratbuilder->delete_clause (clause_id, clause);
   if (lratchecker)
@@ -434,6 +464,28 @@ void Proof::delete_clause () {
   clause_id = 0;
 }
 
+// Original clauses might still be needed to derive external clauses, thus
+// the deriver gets a copy added under a new id.  This happens in the middle
+// of deleting the clause and thus we have to save and restore it.
+
+void Proof::copy_clause () {
+  const int *literals = deriver->deleted (clause_id);
+  if (!literals)
+    return;
+  assert (proof_chain.empty ());
+  const uint64_t id = clause_id;
+  vector<int> deleted;
+  swap (deleted, clause);
+  for (const int *p = literals; *p; p++)
+    clause.push_back (*p);
+  proof_chain.push_back (id);
+  clause_id = ++internal->clause_id;
+  deriver->copy (id, clause_id);
+  add_derived_clause ();
+  swap (deleted, clause);
+  clause_id = id;
+}
+
 void Proof::finalize_clause () {
   if (lratchecker)
     lratchecker->finalize_clause (clause_id, clause);
@@ -12,6 +12,7 @@ class Checker;
 class Tracer;
 class LratBuilder;
 class LratChecker;
+class Deriver;
 
 /*------------------------------------------------------------------------*/
 
@@ -30,6 +31,7 @@ class Proof {
   Tracer *tracer;           // trace proof to file
   LratBuilder *lratbuilder; // create lrat proof chain for any clause
   LratChecker *lratchecker; // lrat checker
+  Deriver *deriver;         // derive external clauses
 
   void add_literal (int internal_lit); // add to 'clause'
   void add_literals (Clause *);        // add to 'clause'
@@ -39,6 +41,7 @@ class Proof {
   void add_original_clause (); // notify observers of original clauses
   void add_derived_clause ();  // notify observers of derived clauses
   void delete_clause ();       // notify observers of deleted clauses
+  void copy_clause ();         // copy original clause before deletion
   void finalize_clause ();
 
 public:
@@ -49,6 +52,7 @@ public:
   void connect (LratBuilder *lb) { lratbuilder = lb; }
   void connect (LratChecker *lc) { lratchecker = lc; }
   void connect (Checker *c) { checker = c; }
+  void connect (Deriver *d) { deriver = d; }
 
   // Add original clauses to the proof (for online proof checking).
   //
@@ -75,6 +79,11 @@ public:
   void add_derived_clause (uint64_t, const vector<int> &,
                            const vector<uint64_t> &);
 
+  // Add external clauses derived from original clauses (by 'Deriver').
+  //
+  void add_external_derived_clause (uint64_t, const vector<int> &,
+                                    const vector<uint64_t> &);
+
   void delete_clause (uint64_t, const vector<int> &);
   void delete_unit_clause (uint64_t id, const int lit);
   void delete_clause (Clause *);
@@ -82,6 +91,7 @@ public:
   void finalize_unit (uint64_t, int);
   void finalize_external_unit (uint64_t, int);
   void finalize_clause (uint64_t, const vector<int> &c);
+  void finalize_external_clause (uint64_t, const vector<int> &c);
   void finalize_clause (Clause *);
 
   void finalize_proof (uint64_t);
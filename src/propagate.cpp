@@ -241,6 +241,23 @@ void Internal::search_assign_external (int lit) {
 // propagation costs (2013 JAIR article by Ian Gent) at the expense of four
 // more bytes for each clause.
 
+// With 'opts.propbinfirst' the binary clauses watched by a literal are all
+// propagated before any long clause is visited, which might then already
+// be satisfied by the blocking literal and is then never accessed.  With
+// 'opts.propprefetch' the cache line of the clause of the watch that many
+// watches ahead is prefetched, unless it is binary or blocked, which hides
+// some of the latency of the first access to a clause below.
+
+// Prefetching is only available with GCC and Clang.
+//
+inline static void prefetch_clause (const Clause *c) {
+#ifdef __GNUC__
+  __builtin_prefetch (c);
+#else
+  (void) c;
+#endif
+}
+
 bool Internal::propagate () {
 
   if (level)
@@ -254,6 +271,9 @@ bool Internal::propagate () {
   //
   int64_t before = propagated;
 
+  const bool binary_first = opts.propbinfirst;
+  const int prefetch = opts.propprefetch;
+
   while (!conflict && propagated != trail.size ()) {
 
     const int lit = -trail[propagated++];
@@ -264,8 +284,41 @@ bool Internal::propagate () {
     watch_iterator j = ws.begin ();
     const_watch_iterator i = j;
 
+    if (binary_first) {
+
+      // Watches are usually sorted with binary clauses first, but binary
+      // clauses learned since the last reduction are at the end, thus we
+      // have to go over all watches.  After this loop the blocking
+      // literals of all binary watches are assigned, and thus the binary
+      // case below is only reached for a conflict, which ends the second
+      // loop anyhow.
+
+      for (const auto &w : ws) {
+        if (!w.binary ())
+          continue;
+        const signed char b = val (w.blit);
+        if (b > 0)
+          continue;
+        if (b < 0)
+          conflict = w.clause; // but continue ...
+        else {
+          build_chain_for_units (w.blit, w.clause, 0);
+          search_assign (w.blit, w.clause);
+        }
+      }
+
+      if (conflict)
+        continue;
+    }
+
     while (i != eow) {
 
+      if (prefetch && eow - i > prefetch) {
+        const Watch &ahead = i[prefetch];
+        if (!ahead.binary () && val (ahead.blit) <= 0)
+          prefetch_clause (ahead.clause);
+      }
+
       const Watch w = *j++ = *i++;
       const signed char b = val (w.blit);
 
@@ -1,3 +1,9 @@
+#ifndef _random_hpp_INCLUDED
+#define _random_hpp_INCLUDED
+
+#include <cassert>
+#include <cstdint>
+
 /*------------------------------------------------------------------------*/
 
 // Random number generator.
@@ -91,3 +97,5 @@ public:
 };
 
 } // namespace CaDiCaL
+
+#endif
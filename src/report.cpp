@@ -1,4 +1,6 @@
 #include "internal.hpp"
+#include "sha256/sha256.hpp"
+#include "sha256/shared_cache.hpp"
 
 namespace CaDiCaL {
 
@@ -156,6 +158,8 @@ static const int num_reports = // as compile time constant
 /*------------------------------------------------------------------------*/
 
 void Internal::report (char type, int verbose) {
+  if (json_file && verbose <= opts.verbose)
+    report_json (type);
   if (!opts.report)
     return;
 #ifdef LOGGING
@@ -278,8 +282,90 @@ void Internal::report (char type, int verbose) {
 
 #else // ifndef QUIET
 
-void Internal::report (char, int) {}
+void Internal::report (char type, int verbose) {
+  if (json_file && verbose <= opts.verbose)
+    report_json (type);
+}
 
 #endif
 
+/*------------------------------------------------------------------------*/
+
+// Machine-readable version of each report as one JSON object per line,
+// independent of 'opts.report' and 'opts.quiet', such that many solver
+// runs can be monitored without parsing their output.  Besides the
+// totals we provide rates over the interval since the previous line, which
+// makes stalls (e.g., the propagator eating up all the time) easy to spot.
+
+static double seconds (clock_t ticks) {
+  return ticks / (double) CLOCKS_PER_SEC;
+}
+
+void Internal::report_json (char type) {
+  assert (json_file);
+  const double now = time ();
+  const double delta = now - json_reported.time;
+  const int64_t propagations = stats.propagations.search;
+  FILE *file = json_file;
+  fprintf (file, "{\"type\":\"");
+  if (type == '"' || type == '\\')
+    fputc ('\\', file);
+  fprintf (file, "%c\",\"seconds\":%.2f", type, now);
+  fprintf (file, ",\"conflicts\":%" PRId64, stats.conflicts);
+  fprintf (file, ",\"decisions\":%" PRId64, stats.decisions);
+  fprintf (file, ",\"propagations\":%" PRId64, propagations);
+  fprintf (file, ",\"conflicts_per_second\":%.2f",
+           relative (stats.conflicts - json_reported.conflicts, delta));
+  fprintf (file, ",\"decisions_per_second\":%.2f",
+           relative (stats.decisions - json_reported.decisions, delta));
+  fprintf (file, ",\"propagations_per_second\":%.2f",
+           relative (propagations - json_reported.propagations, delta));
+  fprintf (file, ",\"MB\":%.2f,\"max_MB\":%.2f",
+           current_resident_set_size () / (double) (1l << 20),
+           maximum_resident_set_size () / (double) (1l << 20));
+  fprintf (file, ",\"level\":%.2f", (double) averages.current.level);
+  fprintf (file, ",\"restarts\":%" PRId64, stats.restarts);
+  fprintf (file, ",\"redundant\":%" PRId64, stats.current.redundant);
+  fprintf (file, ",\"irredundant\":%" PRId64, stats.current.irredundant);
+  fprintf (file, ",\"variables\":%d", active ());
+  fprintf (file, ",\"stable\":%s", stable ? "true" : "false");
+
+  const auto &sha256_stats = SHA256::Propagator::stats;
+  fprintf (file, ",\"sha256\":{");
+  fprintf (file, "\"reasons\":%" PRIu64, sha256_stats.reasons_count);
+  fprintf (file, ",\"clauses\":%" PRIu64, sha256_stats.clauses_count);
+  fprintf (file, ",\"decisions\":%" PRIu64, sha256_stats.decisions_count);
+  fprintf (file, ",\"clean_rounds\":%" PRIu64,
+           sha256_stats.clean_rounds_count);
+  fprintf (file, ",\"prop_cache_hit_rate\":%.4f",
+           relative (sha256_stats.prop_cached_calls,
+                     sha256_stats.prop_total_calls));
+  fprintf (file, ",\"two_bit_cache_hit_rate\":%.4f",
+           relative (sha256_stats.two_bit_cached_calls,
+                     sha256_stats.two_bit_total_calls));
+  if (SHA256::shared_cache)
+    fprintf (file, ",\"shared_cache_hit_rate\":%.4f",
+             relative (SHA256::shared_cache->hits,
+                       SHA256::shared_cache->hits +
+                           SHA256::shared_cache->misses));
+  fprintf (file, ",\"callback_seconds\":%.2f",
+           seconds (sha256_stats.total_cb_time));
+  fprintf (file, ",\"prop_seconds\":%.2f",
+           seconds (sha256_stats.total_prop_time));
+  fprintf (file, ",\"wordwise_seconds\":%.2f",
+           seconds (sha256_stats.total_ww_propagate_time));
+  fprintf (file, ",\"two_bit_seconds\":%.2f",
+           seconds (sha256_stats.total_two_bit_derive_time));
+  fprintf (file, ",\"mendel_branch_seconds\":%.2f",
+           seconds (sha256_stats.total_mendel_branch_time));
+  fprintf (file, ",\"refresh_seconds\":%.2f}}\n",
+           seconds (SHA256::Propagator::state.total_refresh_time));
+  fflush (file);
+
+  json_reported.time = now;
+  json_reported.conflicts = stats.conflicts;
+  json_reported.decisions = stats.decisions;
+  json_reported.propagations = propagations;
+}
+
 } // namespace CaDiCaL
@@ -31,6 +31,11 @@ extern "C" {
 
 #endif
 
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
 #include <string.h>
 }
 
@@ -154,4 +159,76 @@ uint64_t current_resident_set_size () {
 
 /*------------------------------------------------------------------------*/
 
+// Memory placement is only supported on Linux.  We call 'mbind' and
+// 'set_mempolicy' directly as system calls to avoid depending on
+// 'libnuma'.  Both are best effort and fail for instance in containers
+// which do not allow to change the memory policy, which we ignore.
+
+#ifdef __linux__
+
+static const int mpol_preferred = 1; // 'MPOL_PREFERRED' in 'numaif.h'
+static const unsigned mpol_mf_move = 2; // 'MPOL_MF_MOVE'
+
+// The mask of the NUMA node of the CPU the calling thread runs on.
+
+struct NodeMask {
+  unsigned long bits[16];
+  unsigned long max_node () const { return 8 * sizeof bits + 1; }
+  NodeMask () : bits () {}
+  bool local () {
+    unsigned cpu, node;
+    if (syscall (SYS_getcpu, &cpu, &node, 0) || node >= 8 * sizeof bits)
+      return false;
+    const unsigned width = 8 * sizeof *bits;
+    bits[node / width] = 1ul << (node % width);
+    return true;
+  }
+};
+
+bool advise_memory (void *p, size_t bytes, bool huge_pages, bool local) {
+  bool res = true;
+  const uintptr_t start = (uintptr_t) p, end = start + bytes;
+  if (huge_pages) {
+#ifdef MADV_HUGEPAGE
+    // Only the huge pages completely in the range can be advised.
+    const uintptr_t huge = (uintptr_t) 1 << 21;
+    const uintptr_t first = (start + huge - 1) & ~(huge - 1);
+    const uintptr_t last = end & ~(huge - 1);
+    if (first < last &&
+        madvise ((void *) first, last - first, MADV_HUGEPAGE))
+      res = false;
+#else
+    res = false;
+#endif
+  }
+  NodeMask mask;
+  if (local && mask.local ()) {
+    const uintptr_t page = sysconf (_SC_PAGESIZE);
+    const uintptr_t first = (start + page - 1) & ~(page - 1);
+    const uintptr_t last = end & ~(page - 1);
+    if (first < last &&
+        syscall (SYS_mbind, first, last - first, mpol_preferred,
+                 mask.bits, mask.max_node (), mpol_mf_move))
+      res = false;
+  }
+  return res;
+}
+
+bool prefer_local_memory () {
+  NodeMask mask;
+  if (!mask.local ())
+    return false;
+  return !syscall (SYS_set_mempolicy, mpol_preferred, mask.bits,
+                   mask.max_node ());
+}
+
+#else
+
+bool advise_memory (void *, size_t, bool, bool) { return false; }
+bool prefer_local_memory () { return false; }
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
 } // namespace CaDiCaL
@@ -9,6 +9,17 @@ double absolute_process_time ();
 uint64_t maximum_resident_set_size ();
 uint64_t current_resident_set_size ();
 
+// Advise the kernel to back the (page aligned part of the) memory range by
+// transparent huge pages and to move it to the NUMA node the calling
+// thread runs on.  Returns 'false' if this failed.
+//
+bool advise_memory (void *, size_t bytes, bool huge_pages, bool local);
+
+// Prefer the NUMA node the calling thread runs on for all its following
+// allocations.
+//
+bool prefer_local_memory ();
+
 } // namespace CaDiCaL
 
 #endif // ifndef _resources_hpp_INCLUDED
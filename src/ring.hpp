@@ -0,0 +1,95 @@
+#ifndef _ring_hpp_INCLUDED
+#define _ring_hpp_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace CaDiCaL {
+
+// Lock-free ring buffer of bytes between exactly one producer thread and
+// one consumer thread.  Both sides only wait (yielding, or sleeping for
+// the idle consumer) if the buffer is full or respectively empty, thus
+// the producer pays for little more than copying the data.  Data larger
+// than the buffer is passed on in pieces.
+
+class Ring {
+
+  std::vector<char> buffer;
+  const size_t mask; // size is a power of two
+
+  // Total number of bytes pushed and popped (each written by one side).
+  //
+  std::atomic<uint64_t> pushed, popped;
+
+  static size_t round_up (size_t bytes) {
+    size_t res = 1;
+    while (res < bytes)
+      res *= 2;
+    return res;
+  }
+
+public:
+  Ring (size_t bytes)
+      : buffer (round_up (bytes)), mask (buffer.size () - 1), pushed (0),
+        popped (0) {}
+
+  bool empty () const {
+    return pushed.load (std::memory_order_acquire) ==
+           popped.load (std::memory_order_relaxed);
+  }
+
+  void push (const void *data, size_t bytes) {
+    const char *p = (const char *) data;
+    uint64_t head = pushed.load (std::memory_order_relaxed);
+    while (bytes) {
+      const uint64_t tail = popped.load (std::memory_order_acquire);
+      size_t n = buffer.size () - (head - tail);
+      if (!n) {
+        std::this_thread::yield ();
+        continue;
+      }
+      if (n > bytes)
+        n = bytes;
+      const size_t pos = head & mask;
+      const size_t first = std::min (n, buffer.size () - pos);
+      memcpy (buffer.data () + pos, p, first);
+      memcpy (buffer.data (), p + first, n - first);
+      pushed.store (head += n, std::memory_order_release);
+      p += n, bytes -= n;
+    }
+  }
+
+  // Returns 'false' if 'stop' is set while waiting for data.
+  //
+  bool pop (void *data, size_t bytes, const std::atomic<bool> &stop) {
+    char *p = (char *) data;
+    uint64_t tail = popped.load (std::memory_order_relaxed);
+    while (bytes) {
+      const uint64_t head = pushed.load (std::memory_order_acquire);
+      size_t n = head - tail;
+      if (!n) {
+        if (stop.load (std::memory_order_acquire) && empty ())
+          return false;
+        std::this_thread::sleep_for (std::chrono::microseconds (100));
+        continue;
+      }
+      if (n > bytes)
+        n = bytes;
+      const size_t pos = tail & mask;
+      const size_t first = std::min (n, buffer.size () - pos);
+      memcpy (p, buffer.data () + pos, first);
+      memcpy (p + first, buffer.data (), n - first);
+      popped.store (tail += n, std::memory_order_release);
+      p += n, bytes -= n;
+    }
+    return true;
+  }
+};
+
+} // namespace CaDiCaL
+
+#endif
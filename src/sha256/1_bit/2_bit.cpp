@@ -6,7 +6,7 @@
 #include <sstream>
 
 namespace SHA256 {
-#if IS_1BIT
+#if IS_1BIT || IS_4BIT
 // Masks used for constructing 2-bit equations
 string masks_by_op_id[NUM_OPS] = {
     "+++.", "+++.",      "+++.",     "+++.",   "+++.",
@@ -18,7 +18,9 @@ pair<int, int> two_bit_diff_sizes[NUM_OPS] = {
 // Functions by operation IDs
 vector<int> (*two_bit_functions[NUM_OPS]) (vector<int>) = {
     xor_, xor_, xor_, xor_, maj_, ch_, add_, add_, add_, add_};
+#endif
 
+#if IS_1BIT
 int load_1bit_two_bit_rules (ifstream &db,
                              cache::lru_cache<string, string> &cache) {
   int count = 0;
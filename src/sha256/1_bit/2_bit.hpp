@@ -4,17 +4,20 @@
 #include "../2_bit.hpp"
 #include "../lru_cache.hpp"
 #include "../state.hpp"
+#include "../strength.hpp"
 #include "../util.hpp"
 #include <string>
 
 using namespace std;
 
 namespace SHA256 {
-#if IS_1BIT
+#if IS_1BIT || IS_4BIT
 extern string masks_by_op_id[NUM_OPS];
 extern pair<int, int> two_bit_diff_sizes[NUM_OPS];
 extern vector<int> (*two_bit_functions[NUM_OPS]) (vector<int>);
+#endif
 
+#if IS_1BIT
 inline void derive_2bit_equations_1bit (
     State &state, list<Equation> &current_lvl_equations, TwoBit &two_bit,
     int trail_level, Stats &stats) {
@@ -60,66 +63,108 @@ inline void derive_2bit_equations_1bit (
       assert (input_size + output_size == int (ids.first.size ()));
       assert (input_size + output_size == int (ids.second.size ()));
 
+#if ADAPTIVE_PROP
+      int placeholders = 0;
+      for (auto &c : all_chars)
+        if (c == 'x' || c == '-')
+          placeholders++;
+      if (!two_bit_strength.allows (op_id, step_i, placeholders))
+        continue;
+#endif
+
       // Replace the equations for this particular spot
       auto &mask = masks_by_op_id[op_id];
       auto new_equations = otf_2bit_eqs (function, input_chars,
                                          output_chars, ids, mask, &stats);
-      // Add the antecedent for the equations
-      for (auto &equation : new_equations) {
-        // Process inputs
-        int const_zeroes_count = 0;
-        for (int input_i = 0; input_i < input_size; input_i++) {
-          if (input_chars[input_i] == '?')
-            continue;
+#if ADAPTIVE_PROP
+      two_bit_strength.record (op_id, step_i, strength_cost (input_chars),
+                               new_equations.size ());
+#endif
+#if XOR_ENGINE
+      auto new_xors =
+          otf_2bit_xors (function, input_chars, output_chars, ids, mask);
+      if (new_equations.empty () && new_xors.empty ())
+        continue;
+#else
+      if (new_equations.empty ())
+        continue;
+#endif
 
-          uint32_t ids[] = {input_words[input_i].ids_f[bit_pos],
-                            input_words[input_i].ids_g[bit_pos],
-                            input_words[input_i].char_ids[bit_pos]};
-          if (ids[0] == state.zero_var_id) {
-            const_zeroes_count++;
-            continue;
-          }
-
-          auto values = gc_values_1bit (input_chars[input_i]);
-          for (int k = 0; k < 3; k++) {
-            uint32_t &id = ids[k];
-            int lit = values[k] * id;
-            if (lit == 0)
-              continue;
-            assert (state.partial_assignment.get (id) ==
-                    (lit > 0 ? LIT_TRUE : LIT_FALSE));
-            equation.antecedent.push_back (-lit);
-          }
+      // The antecedent is shared by all the equations of the differential
+      vector<int> antecedent;
+      // Process inputs
+      int const_zeroes_count = 0;
+      for (int input_i = 0; input_i < input_size; input_i++) {
+        if (input_chars[input_i] == '?')
+          continue;
+
+        uint32_t ids[] = {input_words[input_i].ids_f[bit_pos],
+                          input_words[input_i].ids_g[bit_pos],
+                          input_words[input_i].char_ids[bit_pos]};
+        if (ids[0] == state.zero_var_id) {
+          const_zeroes_count++;
+          continue;
         }
 
-        // Process outputs
-        for (int output_i = 0; output_i < output_size; output_i++) {
-          if (output_chars[output_i] == '?')
+        auto values = gc_values_1bit (input_chars[input_i]);
+        for (int k = 0; k < 3; k++) {
+          uint32_t &id = ids[k];
+          int lit = values[k] * id;
+          if (lit == 0)
             continue;
+          assert (state.partial_assignment.get (id) ==
+                  (lit > 0 ? LIT_TRUE : LIT_FALSE));
+          antecedent.push_back (-lit);
+        }
+      }
 
-          // Ignore the high carry output if addends count < 4
-          if (function == add_ && output_i == 0 &&
-              (input_size - const_zeroes_count) < 4)
-            continue;
+      // Process outputs
+      for (int output_i = 0; output_i < output_size; output_i++) {
+        if (output_chars[output_i] == '?')
+          continue;
 
-          uint32_t ids[] = {output_words[output_i]->ids_f[bit_pos],
-                            output_words[output_i]->ids_g[bit_pos],
-                            output_words[output_i]->char_ids[bit_pos]};
+        // Ignore the high carry output if addends count < 4
+        if (function == add_ && output_i == 0 &&
+            (input_size - const_zeroes_count) < 4)
+          continue;
 
-          if (ids[0] == state.zero_var_id)
-            continue;
+        uint32_t ids[] = {output_words[output_i]->ids_f[bit_pos],
+                          output_words[output_i]->ids_g[bit_pos],
+                          output_words[output_i]->char_ids[bit_pos]};
 
-          auto values = gc_values_1bit (output_chars[output_i]);
-          for (int k = 0; k < 3; k++) {
-            int lit = values[k] * ids[k];
-            if (lit == 0)
-              continue;
-            assert (state.partial_assignment.get (ids[k]) ==
-                    (lit > 0 ? LIT_TRUE : LIT_FALSE));
-            equation.antecedent.push_back (-lit);
-          }
+        if (ids[0] == state.zero_var_id)
+          continue;
+
+        auto values = gc_values_1bit (output_chars[output_i]);
+        for (int k = 0; k < 3; k++) {
+          int lit = values[k] * ids[k];
+          if (lit == 0)
+            continue;
+          assert (state.partial_assignment.get (ids[k]) ==
+                  (lit > 0 ? LIT_TRUE : LIT_FALSE));
+          antecedent.push_back (-lit);
         }
-        assert (!equation.antecedent.empty ());
+      }
+      assert (!antecedent.empty ());
+
+#if XOR_ENGINE
+      // Gauss-Jordan elimination catches the inconsistencies which aren't
+      // cycles of pairwise equations
+      for (auto &xor_equation : new_xors) {
+        stats.xor_equations_count++;
+        vector<int> conflict;
+        if (two_bit.xor_engine.add (xor_equation.ids, xor_equation.rhs,
+                                    antecedent, conflict))
+          continue;
+        stats.xor_conflicts_count++;
+        two_bit.blocking_clauses.push_back (
+            {unordered_set<int> (conflict.begin (), conflict.end ()),
+             trail_level});
+      }
+#endif
+
+      for (auto &equation : new_equations) {
+        equation.antecedent = antecedent;
         current_lvl_equations.push_back (equation);
 
         // Graph-based approach for detecting inconsistencies
@@ -146,6 +191,9 @@ inline void derive_2bit_equations_1bit (
               blocking_clause.insert (lit);
           two_bit.blocking_clauses.push_back (
               {blocking_clause, trail_level});
+#if ADAPTIVE_PROP
+          two_bit_strength.record_reason (op_id, step_i);
+#endif
         }
       }
     }
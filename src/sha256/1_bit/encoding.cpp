@@ -1,59 +1,126 @@
 #include "../sha256.hpp"
+#include "encoding.hpp"
 #include <cassert>
 #include <regex>
 #include <sstream>
 
 namespace SHA256 {
+#if IS_1BIT || IS_4BIT
+vector<WordPrefix> word_prefixes (int step) {
+  auto &steps = Propagator::state.steps;
+  return {
+      {"A_", &steps[step].a, A, DA},
+      {"E_", &steps[step].e, E, DE},
+      {"W_", &steps[step].w, W, DW},
+      {"s0_", &steps[step].s0, sigma0, Dsigma0},
+      {"s1_", &steps[step].s1, sigma1, Dsigma1},
+      {"sigma0_", &steps[step].sigma0, Sigma0, DSigma0},
+      {"sigma1_", &steps[step].sigma1, Sigma1, DSigma1},
+      {"maj_", &steps[step].maj, Maj, DMaj},
+      {"if_", &steps[step].ch, Ch, DCh},
+      {"T_", &steps[step].t, T, DT},
+      {"K_", &steps[step].k, K, DK},
+      {"add.W.r0_", &steps[step].add_w_r[0], add_W_lc, Dadd_W_lc},
+      {"add.W.r1_", &steps[step].add_w_r[1], add_W_hc, Dadd_W_hc},
+      {"add.T.r0_", &steps[step].add_t_r[0], add_T_lc, Dadd_T_lc},
+      {"add.T.r1_", &steps[step].add_t_r[1], add_T_hc, Dadd_T_hc},
+      {"add.E.r0_", &steps[step].add_e_r[0], add_E_lc, Dadd_E_lc},
+      {"add.A.r0_", &steps[step].add_a_r[0], add_A_lc, Dadd_A_lc},
+      {"add.A.r1_", &steps[step].add_a_r[1], add_A_hc, Dadd_A_hc},
+  };
+}
+#endif
+
 #if IS_1BIT
-void add_1bit_variables (string line, CaDiCaL::Solver *&solver) {
+void add_1bit_word (Word &word, int step, VariableName var_name,
+                    char block, int id, CaDiCaL::Solver *solver) {
   auto &state = Propagator::state;
+  assert (var_name >= Unknown && var_name <= Dadd_A_hc);
+  assert (block == 'f' || block == 'g' || block == 'D');
+
+  if (block == 'D')
+    word.chars = string (32, '?');
+
+  // Add the IDs
+  for (int i = 0; i < 32; i++, id++) {
+    if (block == 'D')
+      word.char_ids[i] = id;
+    else if (block == 'f')
+      word.ids_f[i] = id;
+    else
+      word.ids_g[i] = id;
+
+    state.vars_info[id] = {&word, step, i, var_name};
+  }
 
-  istringstream iss (line);
-  string key;
-  int value;
-  iss >> key >> value;
+  // Add to observed vars
+  if (word.ids_f[0] != 0 && word.ids_g[0] != 0 && word.char_ids[0] != 0)
+    for (int i = 0; i < 32; i++) {
+      solver->add_observed_var (word.ids_f[i]);
+      solver->add_observed_var (word.ids_g[i]);
+      solver->add_observed_var (word.char_ids[i]);
+    }
+}
 
-  // Determine the order
-  if (key == "order") {
-    state.order = value;
-    // Since this is the last comment, set the operations
-    state.set_operations ();
+void set_1bit_zero (int id, CaDiCaL::Solver *solver) {
+  auto &state = Propagator::state;
+  state.zero_var_id = id;
+  assert (id >= 0);
+  for (int i = 0; i < 3; i++) {
+    solver->add_observed_var (id + i);
+    state.vars_info[id + i].identity.name = Zero;
+  }
+}
 
-    printf ("Initial state:\n");
-    state.soft_refresh ();
-    state.print ();
+void set_1bit_order (int order, CaDiCaL::Solver *solver) {
+  auto &state = Propagator::state;
+  state.order = order;
+  // Since all the IDs are known, set the operations
+  state.set_operations ();
+
+  printf ("Initial state:\n");
+  state.soft_refresh ();
+  state.print ();
 
 #if SET_PHASE
-    // Set the initial decision phases
-    for (int i = -4; i < state.order; i++) {
-      for (int j = 0; j < 32; j++) {
-        solver->phase (-state.steps[ABS_STEP (i)].a.ids_f[j]);
-        solver->phase (-state.steps[ABS_STEP (i)].a.ids_g[j]);
-        solver->phase (-state.steps[ABS_STEP (i)].a.char_ids[j]);
-      }
+  // Set the initial decision phases
+  for (int i = -4; i < state.order; i++) {
+    for (int j = 0; j < 32; j++) {
+      solver->phase (-state.steps[ABS_STEP (i)].a.ids_f[j]);
+      solver->phase (-state.steps[ABS_STEP (i)].a.ids_g[j]);
+      solver->phase (-state.steps[ABS_STEP (i)].a.char_ids[j]);
+    }
+    for (int j = 0; j < 32; j++) {
+      solver->phase (-state.steps[ABS_STEP (i)].e.ids_f[j]);
+      solver->phase (-state.steps[ABS_STEP (i)].e.ids_g[j]);
+      solver->phase (-state.steps[ABS_STEP (i)].e.char_ids[j]);
+    }
+    if (i >= 0)
       for (int j = 0; j < 32; j++) {
-        solver->phase (-state.steps[ABS_STEP (i)].e.ids_f[j]);
-        solver->phase (-state.steps[ABS_STEP (i)].e.ids_g[j]);
-        solver->phase (-state.steps[ABS_STEP (i)].e.char_ids[j]);
+        solver->phase (-state.steps[i].w.ids_f[j]);
+        solver->phase (-state.steps[i].w.ids_g[j]);
+        solver->phase (-state.steps[i].w.char_ids[j]);
       }
-      if (i >= 0)
-        for (int j = 0; j < 32; j++) {
-          solver->phase (-state.steps[i].w.ids_f[j]);
-          solver->phase (-state.steps[i].w.ids_g[j]);
-          solver->phase (-state.steps[i].w.char_ids[j]);
-        }
-    }
-    printf ("\n");
+  }
+  printf ("\n");
+#else
+  (void) solver;
 #endif
+}
 
+void add_1bit_variables (string line, CaDiCaL::Solver *&solver) {
+  istringstream iss (line);
+  string key;
+  int value;
+  iss >> key >> value;
+
+  // Determine the order
+  if (key == "order") {
+    // This is the last comment
+    set_1bit_order (value, solver);
     return;
   } else if (key == "zero_g") {
-    state.zero_var_id = value;
-    assert (value >= 0);
-    for (int i = 0; i < 3; i++) {
-      solver->add_observed_var (value + i);
-      state.vars_info[value + i].identity.name = Zero;
-    }
+    set_1bit_zero (value, solver);
     return;
   }
 
@@ -73,134 +140,13 @@ void add_1bit_variables (string line, CaDiCaL::Solver *&solver) {
   // Determine the block
   bool is_f = key.back () == 'f';
 
-  // Pair the prefixes with the words
-  vector<pair<string, Word &>> prefix_pairs = {
-      {"A_", state.steps[step].a},
-      {"E_", state.steps[step].e},
-      {"W_", state.steps[step].w},
-      {"s0_", state.steps[step].s0},
-      {"s1_", state.steps[step].s1},
-      {"sigma0_", state.steps[step].sigma0},
-      {"sigma1_", state.steps[step].sigma1},
-      {"maj_", state.steps[step].maj},
-      {"if_", state.steps[step].ch},
-      {"T_", state.steps[step].t},
-      {"K_", state.steps[step].k},
-      {"add.W.r0_", state.steps[step].add_w_r[0]},
-      {"add.W.r1_", state.steps[step].add_w_r[1]},
-      {"add.T.r0_", state.steps[step].add_t_r[0]},
-      {"add.T.r1_", state.steps[step].add_t_r[1]},
-      {"add.E.r0_", state.steps[step].add_e_r[0]},
-      {"add.A.r0_", state.steps[step].add_a_r[0]},
-      {"add.A.r1_", state.steps[step].add_a_r[1]},
-  };
-
-  for (auto &pair : prefix_pairs) {
-    auto &word = pair.second;
-    string prefixes[] = {pair.first, 'D' + pair.first};
-
-    for (auto &prefix : prefixes) {
-      if (prefix != actual_prefix)
-        continue;
-
-      VariableName var_name = Unknown;
-      if (prefix == "A_")
-        var_name = A;
-      else if (prefix == "E_")
-        var_name = E;
-      else if (prefix == "W_")
-        var_name = W;
-      else if (prefix == "s0_")
-        var_name = sigma0;
-      else if (prefix == "s1_")
-        var_name = sigma1;
-      else if (prefix == "sigma0_")
-        var_name = Sigma0;
-      else if (prefix == "sigma1_")
-        var_name = Sigma1;
-      else if (prefix == "maj_") {
-        var_name = Maj;
-      } else if (prefix == "if_")
-        var_name = Ch;
-      else if (prefix == "T_")
-        var_name = T;
-      else if (prefix == "K_")
-        var_name = K;
-      else if (prefix == "add.W.r0_")
-        var_name = add_W_lc;
-      else if (prefix == "add.W.r1_")
-        var_name = add_W_hc;
-      else if (prefix == "add.T.r0_")
-        var_name = add_T_lc;
-      else if (prefix == "add.T.r1_")
-        var_name = add_T_hc;
-      else if (prefix == "add.E.r0_")
-        var_name = add_E_lc;
-      else if (prefix == "add.A.r0_")
-        var_name = add_A_lc;
-      else if (prefix == "add.A.r1_")
-        var_name = add_A_hc;
-      if (prefix == "DA_")
-        var_name = DA;
-      else if (prefix == "DE_")
-        var_name = DE;
-      else if (prefix == "DW_")
-        var_name = DW;
-      else if (prefix == "Ds0_")
-        var_name = Dsigma0;
-      else if (prefix == "Ds1_")
-        var_name = Dsigma1;
-      else if (prefix == "Dsigma0_")
-        var_name = DSigma0;
-      else if (prefix == "Dsigma1_")
-        var_name = DSigma1;
-      else if (prefix == "Dmaj_") {
-        var_name = DMaj;
-      } else if (prefix == "Dif_")
-        var_name = DCh;
-      else if (prefix == "DT_")
-        var_name = DT;
-      else if (prefix == "DK_")
-        var_name = DK;
-      else if (prefix == "Dadd.W.r0_")
-        var_name = Dadd_W_lc;
-      else if (prefix == "Dadd.W.r1_")
-        var_name = Dadd_W_hc;
-      else if (prefix == "Dadd.T.r0_")
-        var_name = Dadd_T_lc;
-      else if (prefix == "Dadd.T.r1_")
-        var_name = Dadd_T_hc;
-      else if (prefix == "Dadd.E.r0_")
-        var_name = Dadd_E_lc;
-      else if (prefix == "Dadd.A.r0_")
-        var_name = Dadd_A_lc;
-      else if (prefix == "Dadd.A.r1_")
-        var_name = Dadd_A_hc;
-      assert (var_name >= Unknown && var_name <= Dadd_A_hc);
-
-      if (prefix[0] == 'D')
-        word.chars = string (32, '?');
-
-      // Add the IDs
-      for (int i = 0, id = value; i < 32; i++, id++) {
-        if (prefix[0] == 'D')
-          word.char_ids[i] = id;
-        else if (is_f)
-          word.ids_f[i] = id;
-        else
-          word.ids_g[i] = id;
-
-        state.vars_info[id] = {&word, step, i, var_name};
-      }
-
-      // Add to observed vars
-      if (word.ids_f[0] != 0 && word.ids_g[0] != 0 && word.char_ids[0] != 0)
-        for (int i = 0; i < 32; i++) {
-          solver->add_observed_var (word.ids_f[i]);
-          solver->add_observed_var (word.ids_g[i]);
-          solver->add_observed_var (word.char_ids[i]);
-        }
-    }
+  for (auto &prefix : word_prefixes (step)) {
+    if (prefix.prefix == actual_prefix)
+      add_1bit_word (*prefix.word, step, prefix.name, is_f ? 'f' : 'g',
+                     value, solver);
+    else if ('D' + prefix.prefix == actual_prefix)
+      add_1bit_word (*prefix.word, step, prefix.diff_name, 'D', value,
+                     solver);
   }
 }
 #endif
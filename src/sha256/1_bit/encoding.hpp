@@ -2,12 +2,34 @@
 #define _sha256_1_bit_encoding_hpp_INCLUDED
 
 #include "../../cadical.hpp"
+#include "../types.hpp"
 #include <string>
+#include <vector>
 
 using namespace std;
 
 namespace SHA256 {
+#if IS_1BIT || IS_4BIT
+// Name prefix of a word in the encoding along with the names of its value
+// and difference variables (shared with the 4-bit encoding)
+struct WordPrefix {
+  string prefix;
+  Word *word;
+  VariableName name, diff_name;
+};
+
+vector<WordPrefix> word_prefixes (int step);
+#endif
+
+#if IS_1BIT
+// Register the 32 consecutive IDs starting at 'id' as the 'f' or 'g' block
+// values or the differences ('D') of a word
+void add_1bit_word (Word &word, int step, VariableName var_name,
+                    char block, int id, CaDiCaL::Solver *solver);
+void set_1bit_zero (int id, CaDiCaL::Solver *solver);
+void set_1bit_order (int order, CaDiCaL::Solver *solver);
+#endif
 void add_1bit_variables (string line, CaDiCaL::Solver *&solver);
 } // namespace SHA256
 
-#endif
\ No newline at end of file
+#endif
@@ -10,13 +10,13 @@
 using namespace std;
 
 namespace SHA256 {
+#if IS_1BIT
 inline void mendel_branch_1bit (State &state, list<int> &decision_lits,
                                 list<list<Equation>> &equations_trail,
                                 TwoBit &two_bit, Stats &stats) {
   auto rand_ground_x = [&state] (list<int> &decision_lits, Word &word,
                                  int &j) {
-    srand (clock () + j);
-    if (rand () % 2 == 0) {
+    if (branch_random.generate_bool ()) {
       // u
       if (state.partial_assignment.get (word.ids_f[j]) == LIT_UNDEF)
         decision_lits.push_back (word.ids_f[j]);
@@ -111,8 +111,7 @@ inline void mendel_branch_1bit (State &state, list<int> &decision_lits,
           continue;
         assert (col >= 0 && col <= 31);
         assert (word->ids_f[col] == ids[x] || word->ids_g[col] == ids[x]);
-        srand (clock () + x);
-        if (rand () % 2 == 0)
+        if (branch_random.generate_bool ())
           decision_lits.push_back (ids[x]);
         else
           decision_lits.push_back (-ids[x]);
@@ -124,6 +123,7 @@ inline void mendel_branch_1bit (State &state, list<int> &decision_lits,
   }
 #endif
 }
+#endif
 } // namespace SHA256
 
 #endif
\ No newline at end of file
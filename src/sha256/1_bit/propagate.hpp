@@ -4,6 +4,7 @@
 #include "../lru_cache.hpp"
 #include "../propagate.hpp"
 #include "../state.hpp"
+#include "../strength.hpp"
 #include "../util.hpp"
 #include <iterator>
 #include <list>
@@ -69,11 +70,27 @@ inline void custom_1bit_propagate (State &state,
           q_count == input_size + output_size)
         continue;
 
+#if ADAPTIVE_PROP
+      if (!prop_strength.allows (op_id, step_i, q_count))
+        continue;
+#endif
+
       // Propagate
       auto output =
           otf_propagate (function, input_chars, output_chars, &stats);
       string &prop_input = output.first;
       string &prop_output = output.second;
+#if ADAPTIVE_PROP
+      {
+        int props = 0;
+        for (int i = 0; i < input_size; i++)
+          props += prop_input[i] != input_chars[i];
+        for (int i = 0; i < output_size; i++)
+          props += prop_output[i] != output_chars[i];
+        prop_strength.record (op_id, step_i, strength_cost (input_chars),
+                              props);
+      }
+#endif
       // printf ("Prop: %s %s -> %s\n", input_chars.c_str (),
       //         output_chars.c_str (), prop_output.c_str ());
       if (output_chars == prop_output && input_chars == prop_input) {
@@ -92,6 +109,8 @@ inline void custom_1bit_propagate (State &state,
 
       // Construct the antecedent with inputs
       Reason reason;
+      reason.op_id = op_id;
+      reason.step_i = step_i;
       int const_zeroes_count = 0;
       for (long x = 0; x < input_size; x++) {
         if (input_chars[x] == '?')
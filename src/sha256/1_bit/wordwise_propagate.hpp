@@ -18,8 +18,6 @@ int add_input_sizes[4] = {4, 3, 2, 5};
 
 // Wordwise propagate (through branching) words by taking information inside
 // the addition equation
-cache::lru_cache<string, pair<string, string>>
-    wordwise_propagate_cache (100e3);
 inline void wordwise_propagate_branch_1bit (State &state,
                                             list<int> &decision_lits,
                                             Stats &stats) {
@@ -11,6 +11,277 @@
 namespace SHA256 {
 unordered_map<string, string> two_bit_rules;
 
-cache::lru_cache<string, pair<string, string>> otf_2bit_cache (5e6);
+cache::lru_cache<uint64_t, TwoBitRelations> otf_2bit_cache (5e6);
 
-} // namespace SHA256
\ No newline at end of file
+enum TwoBitFunctionId {
+  two_bit_xor,
+  two_bit_maj,
+  two_bit_ch,
+  two_bit_add
+};
+
+static TwoBitFunctionId
+two_bit_function_id (vector<int> (*func) (vector<int> inputs)) {
+  if (func == xor_)
+    return two_bit_xor;
+  if (func == maj_)
+    return two_bit_maj;
+  if (func == ch_)
+    return two_bit_ch;
+  assert (func == add_);
+  return two_bit_add;
+}
+
+// Pack the function, the number of inputs and the characteristics (4 bits
+// each through their value pairs) into one key
+uint64_t two_bit_key (vector<int> (*func) (vector<int> inputs),
+                      const string &inputs, const string &outputs) {
+  uint64_t key = two_bit_function_id (func);
+  key = key << 4 | inputs.size ();
+  for (auto &c : inputs)
+    key = key << 4 | gc_pairs (c);
+  for (auto &c : outputs)
+    key = key << 4 | gc_pairs (c);
+  return key;
+}
+
+// Evaluate the function on 64 assignments at once (one per bit)
+static void eval_bitsliced (TwoBitFunctionId func_id, uint64_t *inputs,
+                            int inputs_size, uint64_t *outputs) {
+  switch (func_id) {
+  case two_bit_xor:
+    outputs[0] = 0;
+    for (int i = 0; i < inputs_size; i++)
+      outputs[0] ^= inputs[i];
+    break;
+  case two_bit_maj:
+    outputs[0] = (inputs[0] & inputs[1]) ^ (inputs[1] & inputs[2]) ^
+                 (inputs[0] & inputs[2]);
+    break;
+  case two_bit_ch:
+    outputs[0] = (inputs[0] & inputs[1]) ^ (inputs[0] & inputs[2]) ^
+                 inputs[2];
+    break;
+  case two_bit_add: {
+    // Count the ones with a 3-bit ripple counter (sum modulo 8)
+    uint64_t s0 = 0, s1 = 0, s2 = 0;
+    for (int i = 0; i < inputs_size; i++) {
+      uint64_t c0 = s0 & inputs[i];
+      s0 ^= inputs[i];
+      uint64_t c1 = s1 & c0;
+      s1 ^= c0;
+      s2 ^= c1;
+    }
+    outputs[0] = s2, outputs[1] = s1, outputs[2] = s0;
+    break;
+  }
+  }
+}
+
+// Assignments of the placeholder with index 'j' in the 64 candidates of a
+// chunk (candidate 'chunk * 64 + b' is at bit 'b')
+static uint64_t placeholder_pattern (int j, uint64_t chunk) {
+  static const uint64_t patterns[6] = {
+      0xaaaaaaaaaaaaaaaaull, 0xccccccccccccccccull, 0xf0f0f0f0f0f0f0f0ull,
+      0xff00ff00ff00ff00ull, 0xffff0000ffff0000ull, 0xffffffff00000000ull};
+  if (j < 6)
+    return patterns[j];
+  return (chunk >> (j - 6) & 1) ? ~0ull : 0;
+}
+
+// Enumerate the assignments of the placeholders (64 per word) and keep the
+// ones which have a consistent completion. The relations are then read off
+// the affine hull of the consistent assignments, which is computed through
+// Gaussian elimination of their differences to the first one. Returns
+// false if there is no consistent assignment or enumerating is too costly.
+bool derive_two_bit_relations (vector<int> (*func) (vector<int> inputs),
+                               const string &inputs, const string &outputs,
+                               TwoBitRelations &relations) {
+  auto func_id = two_bit_function_id (func);
+  int inputs_size = inputs.size (), outputs_size = outputs.size ();
+  int n = inputs_size + outputs_size;
+  string all_chars = inputs + outputs;
+  assert (n <= TWO_BIT_MAX_CHARS);
+
+  // Placeholder index of each position (-1 if it isn't a placeholder)
+  int placeholder_of[TWO_BIT_MAX_CHARS];
+  int positions[TWO_BIT_MAX_CHARS];
+  uint8_t pairs[TWO_BIT_MAX_CHARS];
+  int placeholders = 0;
+  for (int i = 0; i < n; i++) {
+    pairs[i] = gc_pairs (all_chars[i]);
+    if (!pairs[i])
+      return false;
+    placeholder_of[i] = -1;
+    if (all_chars[i] == 'x' || all_chars[i] == '-') {
+      placeholder_of[i] = placeholders;
+      positions[placeholders++] = i;
+    }
+  }
+
+  // Inputs with several possible value pairs have to be enumerated
+  vector<int> free_inputs;
+  int64_t completions = 1;
+  for (int i = 0; i < inputs_size; i++) {
+    if (placeholder_of[i] >= 0 || __builtin_popcount (pairs[i]) == 1)
+      continue;
+    free_inputs.push_back (i);
+    completions *= __builtin_popcount (pairs[i]);
+    if (completions > TWO_BIT_MAX_COMPLETIONS)
+      return false;
+  }
+
+  auto pair_words = [] (uint8_t pair, uint64_t &f, uint64_t &g) {
+    assert (__builtin_popcount (pair) == 1);
+    f = pair & 10 ? ~0ull : 0;
+    g = pair & 12 ? ~0ull : 0;
+  };
+
+  uint64_t candidates = 1ull << placeholders;
+  uint64_t chunks = (candidates + 63) / 64;
+  uint64_t valid = candidates >= 64 ? ~0ull : (1ull << candidates) - 1;
+  vector<uint64_t> consistent (chunks, 0);
+  uint64_t f_in[TWO_BIT_MAX_CHARS], g_in[TWO_BIT_MAX_CHARS];
+  uint64_t f_out[3], g_out[3];
+  for (uint64_t chunk = 0; chunk < chunks; chunk++) {
+    // Placeholder and fixed inputs don't depend on the completion
+    for (int i = 0; i < inputs_size; i++) {
+      if (placeholder_of[i] >= 0) {
+        f_in[i] = placeholder_pattern (placeholder_of[i], chunk);
+        g_in[i] = all_chars[i] == 'x' ? ~f_in[i] : f_in[i];
+      } else if (__builtin_popcount (pairs[i]) == 1)
+        pair_words (pairs[i], f_in[i], g_in[i]);
+    }
+
+    // Go through the completions like an odometer over the value pairs
+    vector<uint8_t> choices (free_inputs.size (), 0);
+    for (int64_t completion = 0; completion < completions; completion++) {
+      for (size_t k = 0; k < free_inputs.size (); k++) {
+        int i = free_inputs[k];
+        // Select the 'choices[k]'-th value pair of the characteristic
+        uint8_t remaining = pairs[i];
+        for (int skip = 0; skip < choices[k]; skip++)
+          remaining &= remaining - 1;
+        pair_words (remaining & -remaining, f_in[i], g_in[i]);
+      }
+      for (size_t k = 0; k < free_inputs.size (); k++) {
+        int i = free_inputs[k];
+        if (++choices[k] < __builtin_popcount (pairs[i]))
+          break;
+        choices[k] = 0;
+      }
+
+      eval_bitsliced (func_id, f_in, inputs_size, f_out);
+      eval_bitsliced (func_id, g_in, inputs_size, g_out);
+
+      uint64_t ok = valid;
+      for (int k = 0; k < outputs_size && ok; k++) {
+        int i = inputs_size + k;
+        if (placeholder_of[i] >= 0) {
+          uint64_t f = placeholder_pattern (placeholder_of[i], chunk);
+          uint64_t g = all_chars[i] == 'x' ? ~f : f;
+          ok &= ~(f_out[k] ^ f) & ~(g_out[k] ^ g);
+          continue;
+        }
+        uint64_t allowed = 0;
+        if (pairs[i] & 1)
+          allowed |= ~f_out[k] & ~g_out[k];
+        if (pairs[i] & 2)
+          allowed |= f_out[k] & ~g_out[k];
+        if (pairs[i] & 4)
+          allowed |= ~f_out[k] & g_out[k];
+        if (pairs[i] & 8)
+          allowed |= f_out[k] & g_out[k];
+        ok &= allowed;
+      }
+      consistent[chunk] |= ok;
+    }
+  }
+
+  // Basis of the differences indexed by their pivot (lowest bit)
+  uint16_t basis[TWO_BIT_MAX_CHARS] = {0};
+  int rank = 0;
+  int64_t first = -1;
+  for (uint64_t chunk = 0; chunk < chunks && rank < placeholders; chunk++)
+    for (uint64_t word = consistent[chunk]; word && rank < placeholders;
+         word &= word - 1) {
+      uint64_t candidate = chunk * 64 + __builtin_ctzll (word);
+      if (first < 0) {
+        first = candidate;
+        continue;
+      }
+      uint16_t diff = candidate ^ first;
+      for (int b = 0; b < placeholders && diff; b++) {
+        if (!(diff >> b & 1))
+          continue;
+        if (!basis[b]) {
+          basis[b] = diff;
+          rank++;
+          break;
+        }
+        diff ^= basis[b];
+      }
+    }
+  if (first < 0)
+    return false;
+
+  // Two placeholders are related iff they agree in every basis vector
+  relations.parities = 0;
+  uint16_t columns[TWO_BIT_MAX_CHARS];
+  for (int j = 0; j < placeholders; j++) {
+    columns[j] = 0;
+    for (int k = 0; k < placeholders; k++)
+      columns[j] |= (basis[k] >> j & 1) << k;
+  }
+  for (int i = 0; i < TWO_BIT_MAX_CHARS; i++)
+    relations.classes[i] = -1;
+  for (int j = 0; j < placeholders; j++) {
+    int i = positions[j];
+    relations.parities |= (first >> j & 1) << i;
+    for (int l = 0; l <= j; l++)
+      if (columns[l] == columns[j]) {
+        relations.classes[i] = l;
+        break;
+      }
+  }
+
+  // Reduce the basis and read off the relations which hold in its
+  // orthogonal complement: each placeholder outside of the pivots is the
+  // sum of the pivots whose basis vectors contain it
+  for (int b = 0; b < placeholders; b++)
+    for (int c = 0; c < placeholders && basis[b]; c++)
+      if (c != b && (basis[c] >> b & 1))
+        basis[c] ^= basis[b];
+  relations.xors_size = 0;
+  relations.xors_rhs = 0;
+  for (int j = 0; j < placeholders; j++) {
+    if (basis[j])
+      continue;
+    uint16_t xor_ = 1 << j;
+    for (int b = 0; b < placeholders; b++)
+      if (basis[b] >> j & 1)
+        xor_ |= 1 << b;
+
+    auto &k = relations.xors_size;
+    relations.xors[k] = 0;
+    for (int l = 0; l < placeholders; l++)
+      if (xor_ >> l & 1)
+        relations.xors[k] |= 1 << positions[l];
+    relations.xors_rhs |= (__builtin_popcount (xor_ & first) & 1) << k;
+    k++;
+  }
+
+  // Drop the classes with a single placeholder
+  for (int j = 0; j < placeholders; j++) {
+    int i = positions[j];
+    int size = 0;
+    for (int l = 0; l < placeholders; l++)
+      size += relations.classes[positions[l]] == relations.classes[i];
+    if (size == 1)
+      relations.classes[i] = -1;
+  }
+
+  return true;
+}
+
+} // namespace SHA256
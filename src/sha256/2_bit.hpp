@@ -3,6 +3,7 @@
 
 #include "lru_cache.hpp"
 #include "propagate.hpp"
+#include "shared_cache.hpp"
 #include "state.hpp"
 #include "types.hpp"
 #include "util.hpp"
@@ -26,6 +27,11 @@
 #define TWO_BIT_ADD6_ID 8
 #define TWO_BIT_ADD7_ID 9
 
+// Most characteristics in one differential (8 inputs and 3 outputs)
+#define TWO_BIT_MAX_CHARS 11
+// Most assignments of the non-placeholder inputs tried per differential
+#define TWO_BIT_MAX_COMPLETIONS (1 << 16)
+
 using namespace std;
 
 namespace SHA256 {
@@ -273,168 +279,98 @@ inline vector<Equation> check_consistency (list<Equation *> &equations,
 //   return true;
 // }
 
-extern cache::lru_cache<string, pair<string, string>> otf_2bit_cache;
+// Pairwise XOR relations between the placeholders ('x' and '-') of a
+// differential, as classes of placeholders whose first block values are
+// linearly related
+struct TwoBitRelations {
+  // Class of each position (-1 if it isn't a related placeholder)
+  int8_t classes[TWO_BIT_MAX_CHARS];
+  // Value of each placeholder in an arbitrary consistent assignment
+  uint16_t parities;
+  // All the independent XOR relations of the first block values (one bit
+  // per position) and their right-hand sides (one bit per relation)
+  uint16_t xors[TWO_BIT_MAX_CHARS], xors_rhs;
+  int8_t xors_size;
+};
+
+extern cache::lru_cache<uint64_t, TwoBitRelations> otf_2bit_cache;
+uint64_t two_bit_key (vector<int> (*func) (vector<int> inputs),
+                      const string &inputs, const string &outputs);
+bool derive_two_bit_relations (vector<int> (*func) (vector<int> inputs),
+                               const string &inputs, const string &outputs,
+                               TwoBitRelations &relations);
+
+// Look up the relations in the cache or derive them
+inline bool otf_2bit_relations (vector<int> (*func) (vector<int> inputs),
+                                const string &inputs, const string &outputs,
+                                TwoBitRelations &relations,
+                                Stats *stats = NULL) {
+  uint64_t cache_key = two_bit_key (func, inputs, outputs);
+  if (shared_cache != NULL &&
+      shared_cache->get (cache_key, &relations, sizeof (relations))) {
+    if (stats != NULL)
+      stats->two_bit_cached_calls++;
+    return true;
+  }
+  if (otf_2bit_cache.exists (cache_key)) {
+    if (stats != NULL)
+      stats->two_bit_cached_calls++;
+    relations = otf_2bit_cache.get (cache_key);
+    return true;
+  }
+  if (!derive_two_bit_relations (func, inputs, outputs, relations))
+    return false;
+  if (shared_cache == NULL ||
+      !shared_cache->put (cache_key, &relations, sizeof (relations)))
+    otf_2bit_cache.put (cache_key, relations);
+  return true;
+}
+
 inline vector<Equation>
 otf_2bit_eqs (vector<int> (*func) (vector<int> inputs), string inputs,
               string outputs, pair<vector<uint32_t>, vector<uint32_t>> ids,
               string mask, Stats *stats = NULL) {
   if (stats != NULL)
     stats->two_bit_total_calls++;
+  if (kernel_trace != NULL)
+    kernel_trace->two_bit (function_tag (func), inputs, outputs, mask, ids);
 
   vector<Equation> equations;
-  pair<string, string> cols_xor;
-  // printf ("Debug: %ld %ld %ld\n", inputs.size (), outputs.size (),
-  //         char_ids.size ());
   assert (inputs.size () + outputs.size () == ids.first.size ());
   assert (inputs.size () + outputs.size () == ids.second.size ());
   assert (ids.first.size () == mask.size ());
   assert (ids.second.size () == mask.size ());
-
-  // Look in the cache
-  bool is_cached = false;
-  string cache_key;
-  {
-    string func_str = to_string (reinterpret_cast<int64_t> (func));
-    cache_key = func_str + " " + inputs + " " + outputs;
-  }
-  if (otf_2bit_cache.exists (cache_key)) {
-    if (stats != NULL)
-      stats->two_bit_cached_calls++;
-    is_cached = true;
-    cols_xor = otf_2bit_cache.get (cache_key);
-  }
+  assert (inputs.size () + outputs.size () <= TWO_BIT_MAX_CHARS);
 
   string all_chars = inputs + outputs;
-  assert (all_chars.size () == inputs.size () + outputs.size ());
-
-  if (!is_cached) {
-    vector<int> positions;
-    for (int i = 0; i < int (all_chars.size ()); i++)
-      if (is_in (all_chars[i], {'x', '-'}))
-        positions.push_back (i);
-
-    if (positions.size () > 4)
-      return {};
-
-    vector<pair<string, string>> selections[2];
-    int n = positions.size (); // n is the placeholders count
-    for (int block_i = 0; block_i < 2; block_i++)
-      for (int i = 0; i < pow (2, n); i++) {
-        int values[n];
-        for (int j = 0; j < n; j++)
-          values[j] = i >> j & 1;
-        string candidate = all_chars;
-        for (int j = 0; j < n; j++) {
-          auto &value = values[j];
-          // c: differential characteristic in the selected placeholder
-          auto &c = candidate[positions[j]];
-          assert (c == '-' || c == 'x');
-          if (block_i == 0)
-            c = c == 'x' ? (value == 1 ? 'u' : 'n')
-                         : (value == 1 ? '1' : '0');
-          else
-            c = c == 'x' ? (value == 1 ? 'n' : 'u')
-                         : (value == 1 ? '0' : '1');
-        }
-
-        string candidate_inputs = candidate.substr (0, inputs.size ());
-        string candidate_outputs =
-            candidate.substr (inputs.size (), outputs.size ());
-        auto propagation =
-            otf_propagate (func, candidate_inputs, candidate_outputs);
-        string &prop_output = propagation.second;
-        bool skip = false;
-        for (auto &c : prop_output) {
-          if (c == '#') {
-            skip = true;
-            break;
-          }
-        }
-        if (skip)
-          continue;
-
-        selections[block_i].push_back (
-            {candidate_inputs, candidate_outputs});
-      }
-
-    int pairs_count = 0;
-    {
-      int n = all_chars.size ();
-      for (int i = 0; i < n; i++) {
-        for (int j = i + 1; j < n; j++) {
-          pairs_count += 1;
-          // Each characteristic for each block
-          cols_xor.first += "?";
-          cols_xor.second += "?";
-        }
-      }
-    }
-    assert (int (cols_xor.first.size ()) == pairs_count);
-    assert (int (cols_xor.second.size ()) == pairs_count);
-
-    auto break_gc_f = [] (char gc) {
-      assert (gc == 'u' || gc == '1' || gc == 'n' || gc == '0');
-      return gc == 'u' || gc == '1' ? 1 : 0;
-    };
-    auto break_gc_g = [] (char gc) {
-      assert (gc == 'u' || gc == '1' || gc == 'n' || gc == '0');
-      return gc == 'n' || gc == '1' ? 1 : 0;
-    };
-    for (int block_i = 0; block_i < 2; block_i++) {
-      auto &col_xor = block_i == 0 ? cols_xor.first : cols_xor.second;
-      for (auto &selection : selections[block_i]) {
-        auto combined = selection.first + selection.second;
-        int x = -1;
-        int n = combined.size ();
-        for (int i = 0; i < n; i++) {
-          for (int j = i + 1; j < n; j++) {
-            assert (i != j);
-            x++;
-
-            if (!is_in (i, positions) || !is_in (j, positions)) {
-              col_xor[x] = '?';
-              continue;
-            }
-
-            auto break_gc = block_i == 0 ? break_gc_f : break_gc_g;
-            uint8_t c1 = break_gc (combined[i]);
-            uint8_t c2 = break_gc (combined[j]);
-            char diff = (c1 ^ c2) == 0 ? '0' : '1';
-
-            col_xor[x] = col_xor[x] == '?'    ? diff
-                         : diff == col_xor[x] ? diff
-                                              : 'v';
-          }
-        }
-      }
-    }
-
-    // Add to the cache
-    otf_2bit_cache.put (cache_key, cols_xor);
-  }
-
   int n = all_chars.size ();
+  int placeholders = 0;
+  for (auto &c : all_chars)
+    if (c == 'x' || c == '-')
+      placeholders++;
+  if (placeholders < 2)
+    return {};
+
+  TwoBitRelations relations;
+  if (!otf_2bit_relations (func, inputs, outputs, relations, stats))
+    return {};
+
+  // The equations of the first block come before the second block ones
   for (int block_i = 0; block_i < 2; block_i++) {
-    auto &col_xor = block_i == 0 ? cols_xor.first : cols_xor.second;
     auto &char_ids_ = block_i == 0 ? ids.first : ids.second;
-    int x = -1;
     for (int i = 0; i < n; i++) {
-      for (int j = i + 1; j < n; j++) {
-        x += 1;
-
-        if (col_xor[x] == '?' || col_xor[x] == 'v')
-          continue;
-
-        if (mask[i] != '+' || mask[j] != '+')
-          continue;
+      if (relations.classes[i] < 0 || mask[i] != '+')
+        continue;
 
-        if (!is_in (all_chars[i], {'-', 'x'}) ||
-            !is_in (all_chars[j], {'-', 'x'}))
+      for (int j = i + 1; j < n; j++) {
+        if (relations.classes[j] != relations.classes[i] || mask[j] != '+')
           continue;
 
         Equation eq;
-        assert (col_xor[x] == '0' || col_xor[x] == '1');
-        eq.diff = col_xor[x] == '0' ? 0 : 1;
+        eq.diff = (relations.parities >> i ^ relations.parities >> j) & 1;
+        // In the second block, 'x' flips the value of the first block
+        if (block_i == 1)
+          eq.diff ^= (all_chars[i] == 'x') ^ (all_chars[j] == 'x');
         // Sort the IDs for non-ambiguous comparison
         uint32_t x, y;
         if (char_ids_[i] < char_ids_[j]) {
@@ -454,6 +390,51 @@ otf_2bit_eqs (vector<int> (*func) (vector<int> inputs), string inputs,
   return equations;
 }
 
+// Same as 'otf_2bit_eqs' but with all the XOR relations over any number of
+// placeholders instead of the pairwise ones. A relation over a single
+// placeholder fixes its value.
+inline vector<XorEquation>
+otf_2bit_xors (vector<int> (*func) (vector<int> inputs), string inputs,
+               string outputs, pair<vector<uint32_t>, vector<uint32_t>> ids,
+               string mask) {
+  assert (inputs.size () + outputs.size () == ids.first.size ());
+  assert (inputs.size () + outputs.size () == ids.second.size ());
+  assert (ids.first.size () == mask.size ());
+  assert (inputs.size () + outputs.size () <= TWO_BIT_MAX_CHARS);
+
+  string all_chars = inputs + outputs;
+  int n = all_chars.size ();
+  if (all_chars.find_first_of ("x-") == string::npos)
+    return {};
+
+  TwoBitRelations relations;
+  if (!otf_2bit_relations (func, inputs, outputs, relations))
+    return {};
+
+  vector<XorEquation> equations;
+  for (int block_i = 0; block_i < 2; block_i++) {
+    auto &char_ids_ = block_i == 0 ? ids.first : ids.second;
+    for (int k = 0; k < relations.xors_size; k++) {
+      XorEquation eq;
+      eq.rhs = relations.xors_rhs >> k & 1;
+      bool masked = false;
+      for (int i = 0; i < n; i++) {
+        if (!(relations.xors[k] >> i & 1))
+          continue;
+        masked |= mask[i] != '+';
+        eq.ids.push_back (char_ids_[i]);
+        // In the second block, 'x' flips the value of the first block
+        if (block_i == 1 && all_chars[i] == 'x')
+          eq.rhs ^= 1;
+      }
+      if (!masked)
+        equations.push_back (eq);
+    }
+  }
+
+  return equations;
+}
+
 void load_two_bit_rules ();
 } // namespace SHA256
 
@@ -1,13 +1,172 @@
 #ifndef _sha256_4_bit_2_bit_hpp_INCLUDED
 #define _sha256_4_bit_2_bit_hpp_INCLUDED
 
+#include "../1_bit/2_bit.hpp"
+#include "../2_bit.hpp"
 #include "../state.hpp"
+#include "../strength.hpp"
+#include "../util.hpp"
+#include "state.hpp"
 #include <string>
 
 using namespace std;
 
 namespace SHA256 {
-void custom_4bit_block (State &state, TwoBit &two_bit);
+#if IS_4BIT
+// The equations relate the values of the blocks as in the 1-bit encoding,
+// but the antecedents consist of the excluded pairs of the characteristics
+inline void derive_2bit_equations_4bit (
+    State &state, list<Equation> &current_lvl_equations, TwoBit &two_bit,
+    int trail_level, Stats &stats) {
+  for (auto level = state.two_bit_markings_trail.end ();
+       level-- != state.two_bit_markings_trail.begin ();) {
+    for (auto marking_it = level->end ();
+         marking_it-- != level->begin ();) {
+      auto op_id = marking_it->op_id;
+      auto step_i = marking_it->step_i;
+      auto bit_pos = marking_it->bit_pos;
+      auto basis = marking_it->basis;
+      marking_it = level->erase (marking_it);
+
+      auto &function = two_bit_functions[op_id];
+#if !TWO_BIT_ADD_DIFFS
+      assert (op_id < op_add_w);
+#endif
+
+      // Construct the differential
+      int input_size = two_bit_diff_sizes[op_id].first,
+          output_size = two_bit_diff_sizes[op_id].second;
+      auto &input_words = state.operations[step_i].inputs_by_op_id[op_id];
+      auto &output_words = state.operations[step_i].outputs_by_op_id[op_id];
+      string input_chars, output_chars;
+      pair<vector<uint32_t>, vector<uint32_t>> ids;
+      bool basis_found = false;
+      for (int i = 0; i < input_size; i++) {
+        input_chars += *input_words[i].chars[bit_pos];
+        ids.first.push_back (input_words[i].ids_f[bit_pos]);
+        ids.second.push_back (input_words[i].ids_g[bit_pos]);
+        if (input_words[i].char_ids[bit_pos] == basis)
+          basis_found = true;
+      }
+      for (int i = 0; i < output_size; i++) {
+        output_chars += output_words[i]->chars[bit_pos];
+        ids.first.push_back (output_words[i]->ids_f[bit_pos]);
+        ids.second.push_back (output_words[i]->ids_g[bit_pos]);
+        if (output_words[i]->char_ids[bit_pos] == basis)
+          basis_found = true;
+      }
+      assert (basis_found);
+
+#if ADAPTIVE_PROP
+      int placeholders = 0;
+      for (auto &c : input_chars + output_chars)
+        if (c == 'x' || c == '-')
+          placeholders++;
+      if (!two_bit_strength.allows (op_id, step_i, placeholders))
+        continue;
+#endif
+
+      // Replace the equations for this particular spot
+      auto &mask = masks_by_op_id[op_id];
+      auto new_equations = otf_2bit_eqs (function, input_chars,
+                                         output_chars, ids, mask, &stats);
+#if ADAPTIVE_PROP
+      two_bit_strength.record (op_id, step_i, strength_cost (input_chars),
+                               new_equations.size ());
+#endif
+#if XOR_ENGINE
+      auto new_xors =
+          otf_2bit_xors (function, input_chars, output_chars, ids, mask);
+      if (new_equations.empty () && new_xors.empty ())
+        continue;
+#else
+      if (new_equations.empty ())
+        continue;
+#endif
+
+      // The antecedent is shared by all the equations of the differential
+      vector<int> antecedent;
+      // Process inputs
+      int const_zeroes_count = 0;
+      for (int input_i = 0; input_i < input_size; input_i++) {
+        if (input_chars[input_i] == '?')
+          continue;
+
+        if (input_words[input_i].ids_f[bit_pos] == state.zero_var_id) {
+          const_zeroes_count++;
+          continue;
+        }
+
+        add_4bit_antecedent (state.partial_assignment,
+                             input_words[input_i].char_ids[bit_pos],
+                             input_chars[input_i], antecedent);
+      }
+
+      // Process outputs
+      for (int output_i = 0; output_i < output_size; output_i++) {
+        if (output_chars[output_i] == '?')
+          continue;
+
+        // Ignore the high carry output if addends count < 4
+        if (function == add_ && output_i == 0 &&
+            (input_size - const_zeroes_count) < 4)
+          continue;
+
+        if (output_words[output_i]->ids_f[bit_pos] == state.zero_var_id)
+          continue;
+
+        add_4bit_antecedent (state.partial_assignment,
+                             output_words[output_i]->char_ids[bit_pos],
+                             output_chars[output_i], antecedent);
+      }
+      assert (!antecedent.empty ());
+
+#if XOR_ENGINE
+      // The values aren't observed in this encoding, so the matrix only
+      // serves for detecting inconsistencies
+      for (auto &xor_equation : new_xors) {
+        stats.xor_equations_count++;
+        vector<int> conflict;
+        if (two_bit.xor_engine.add (xor_equation.ids, xor_equation.rhs,
+                                    antecedent, conflict))
+          continue;
+        stats.xor_conflicts_count++;
+        two_bit.blocking_clauses.push_back (
+            {unordered_set<int> (conflict.begin (), conflict.end ()),
+             trail_level});
+      }
+#endif
+
+      for (auto &equation : new_equations) {
+        equation.antecedent = antecedent;
+        current_lvl_equations.push_back (equation);
+
+        // Graph-based approach for detecting inconsistencies
+        vector<vector<int> *> blocking_antecedents;
+        bool trivial_conflict = two_bit.graph.add_edge (
+            equation.ids[0], equation.ids[1], equation.diff,
+            &current_lvl_equations.back ().antecedent,
+            &blocking_antecedents);
+        if (!trivial_conflict)
+          two_bit.graph.shortest_inconsistent_cycle (
+              equation.ids[0], equation.ids[1], &blocking_antecedents);
+
+        if (!blocking_antecedents.empty ()) {
+          unordered_set<int> blocking_clause;
+          for (auto &antecedent : blocking_antecedents)
+            for (auto &lit : *antecedent)
+              blocking_clause.insert (lit);
+          two_bit.blocking_clauses.push_back (
+              {blocking_clause, trail_level});
+#if ADAPTIVE_PROP
+          two_bit_strength.record_reason (op_id, step_i);
+#endif
+        }
+      }
+    }
+  }
+}
+#endif
 } // namespace SHA256
 
-#endif
\ No newline at end of file
+#endif
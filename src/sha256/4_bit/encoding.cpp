@@ -1,14 +1,97 @@
+#include "encoding.hpp"
+#include "../1_bit/encoding.hpp"
 #include "../sha256.hpp"
 #include "../state.hpp"
+#include "state.hpp"
 #include <cassert>
 #include <regex>
 #include <sstream>
 
 namespace SHA256 {
 #if IS_4BIT
-void add_4bit_variables (string line, CaDiCaL::Solver *&solver) {
+void add_4bit_word (Word &word, int step, VariableName var_name,
+                    char block, int id, CaDiCaL::Solver *solver) {
+  auto &state = Propagator::state;
+  assert (var_name >= Unknown && var_name <= Dadd_A_hc);
+  assert (block == 'f' || block == 'g' || block == 'D');
+
+  if (block == 'D')
+    word.chars = string (32, '?');
+
+  // Add the IDs
+  for (int i = 0; i < 32; i++) {
+    if (block == 'D') {
+      word.char_ids[i] = id + 4 * i;
+      for (int k = 0; k < 4; k++)
+        state.vars_info[id + 4 * i + k] = {&word, step, i, var_name};
+    } else {
+      if (block == 'f')
+        word.ids_f[i] = id + i;
+      else
+        word.ids_g[i] = id + i;
+      state.vars_info[id + i] = {&word, step, i, var_name};
+    }
+  }
+
+  // Add to observed vars
+  if (word.ids_f[0] != 0 && word.ids_g[0] != 0 && word.char_ids[0] != 0)
+    for (int i = 0; i < 32; i++)
+      for (int k = 0; k < 4; k++)
+        solver->add_observed_var (word.char_ids[i] + k);
+}
+
+void set_4bit_zero (int id, CaDiCaL::Solver *solver) {
   auto &state = Propagator::state;
+  state.zero_var_id = id;
+  assert (id >= 0);
+  for (int i = 0; i < 6; i++) {
+    solver->add_observed_var (id + i);
+    state.vars_info[id + i].identity.name = Zero;
+  }
+}
+
+void set_4bit_order (int order, CaDiCaL::Solver *solver) {
+  auto &state = Propagator::state;
+  state.order = order;
+  // Since all the IDs are known, set the operations
+  state.set_operations ();
+
+  printf ("Initial state:\n");
+  state.hard_refresh ();
+  state.print ();
+
+  // The values of the blocks are only known to the propagator through the
+  // pairs they take, so observe the values of the words the blocks are
+  // computed from for verifying the models
+  for (int i = -4; i < min (order, 16); i++) {
+    Word *words[] = {i < 0 ? &state.steps[ABS_STEP (i)].a : NULL,
+                     i < 0 ? &state.steps[ABS_STEP (i)].e : NULL,
+                     i >= 0 ? &state.steps[i].w : NULL};
+    for (auto &word : words)
+      for (int j = 0; word != NULL && j < 32; j++) {
+        solver->add_observed_var (word->ids_f[j]);
+        solver->add_observed_var (word->ids_g[j]);
+      }
+  }
+
+#if SET_PHASE
+  // Set the initial decision phases
+  for (int i = -4; i < state.order; i++) {
+    Word *words[] = {&state.steps[ABS_STEP (i)].a,
+                     &state.steps[ABS_STEP (i)].e,
+                     i >= 0 ? &state.steps[i].w : NULL};
+    for (auto &word : words)
+      for (int j = 0; word != NULL && j < 32; j++)
+        for (int k = 0; k < 4; k++) {
+          int var = word->char_ids[j] + k;
+          solver->phase (phase_4bit_lit (state.vars_info[var], var));
+        }
+  }
+  printf ("\n");
+#endif
+}
 
+void add_4bit_variables (string line, CaDiCaL::Solver *&solver) {
   istringstream iss (line);
   string key;
   int value;
@@ -16,22 +99,11 @@ void add_4bit_variables (string line, CaDiCaL::Solver *&solver) {
 
   // Determine the order
   if (key == "order") {
-    state.order = value;
-    // Since this is the last comment, set the operations
-    state.set_operations ();
-
-    printf ("Initial state:\n");
-    state.hard_refresh ();
-    state.print ();
-
+    // This is the last comment
+    set_4bit_order (value, solver);
     return;
   } else if (key == "zero_g") {
-    state.zero_var_id = value;
-    assert (value >= 0);
-    for (int i = 0; i < 6; i++) {
-      solver->add_observed_var (value + i);
-      state.vars_info[value + i].identity.name = Zero;
-    }
+    set_4bit_zero (value, solver);
     return;
   }
 
@@ -51,140 +123,14 @@ void add_4bit_variables (string line, CaDiCaL::Solver *&solver) {
   // Determine the block
   bool is_f = key.back () == 'f';
 
-  // Pair the prefixes with the words
-  vector<pair<string, Word &>> prefix_pairs = {
-      {"A_", state.steps[step].a},
-      {"E_", state.steps[step].e},
-      {"W_", state.steps[step].w},
-      {"s0_", state.steps[step].s0},
-      {"s1_", state.steps[step].s1},
-      {"sigma0_", state.steps[step].sigma0},
-      {"sigma1_", state.steps[step].sigma1},
-      {"maj_", state.steps[step].maj},
-      {"if_", state.steps[step].ch},
-      {"T_", state.steps[step].t},
-      {"K_", state.steps[step].k},
-      {"add.W.r0_", state.steps[step].add_w_r[0]},
-      {"add.W.r1_", state.steps[step].add_w_r[1]},
-      {"add.T.r0_", state.steps[step].add_t_r[0]},
-      {"add.T.r1_", state.steps[step].add_t_r[1]},
-      {"add.E.r0_", state.steps[step].add_e_r[0]},
-      {"add.A.r0_", state.steps[step].add_a_r[0]},
-      {"add.A.r1_", state.steps[step].add_a_r[1]},
-  };
-
-  for (auto &pair : prefix_pairs) {
-    auto &word = pair.second;
-    string prefixes[] = {pair.first, 'D' + pair.first};
-
-    for (auto &prefix : prefixes) {
-      if (prefix != actual_prefix)
-        continue;
-
-      VariableName var_name = Unknown;
-      if (prefix == "A_")
-        var_name = A;
-      else if (prefix == "E_")
-        var_name = E;
-      else if (prefix == "W_")
-        var_name = W;
-      else if (prefix == "s0_")
-        var_name = sigma0;
-      else if (prefix == "s1_")
-        var_name = sigma1;
-      else if (prefix == "sigma0_")
-        var_name = Sigma0;
-      else if (prefix == "sigma1_")
-        var_name = Sigma1;
-      else if (prefix == "maj_") {
-        var_name = Maj;
-      } else if (prefix == "if_")
-        var_name = Ch;
-      else if (prefix == "T_")
-        var_name = T;
-      else if (prefix == "K_")
-        var_name = K;
-      else if (prefix == "add.W.r0_")
-        var_name = add_W_lc;
-      else if (prefix == "add.W.r1_")
-        var_name = add_W_hc;
-      else if (prefix == "add.T.r0_")
-        var_name = add_T_lc;
-      else if (prefix == "add.T.r1_")
-        var_name = add_T_hc;
-      else if (prefix == "add.E.r0_")
-        var_name = add_E_lc;
-      else if (prefix == "add.A.r0_")
-        var_name = add_A_lc;
-      else if (prefix == "add.A.r1_")
-        var_name = add_A_hc;
-      if (prefix == "DA_")
-        var_name = DA;
-      else if (prefix == "DE_")
-        var_name = DE;
-      else if (prefix == "DW_")
-        var_name = DW;
-      else if (prefix == "Ds0_")
-        var_name = Dsigma0;
-      else if (prefix == "Ds1_")
-        var_name = Dsigma1;
-      else if (prefix == "Dsigma0_")
-        var_name = DSigma0;
-      else if (prefix == "Dsigma1_")
-        var_name = DSigma1;
-      else if (prefix == "Dmaj_") {
-        var_name = DMaj;
-      } else if (prefix == "Dif_")
-        var_name = DCh;
-      else if (prefix == "DT_")
-        var_name = DT;
-      else if (prefix == "DK_")
-        var_name = DK;
-      else if (prefix == "Dadd.W.r0_")
-        var_name = Dadd_W_lc;
-      else if (prefix == "Dadd.W.r1_")
-        var_name = Dadd_W_hc;
-      else if (prefix == "Dadd.T.r0_")
-        var_name = Dadd_T_lc;
-      else if (prefix == "Dadd.T.r1_")
-        var_name = Dadd_T_hc;
-      else if (prefix == "Dadd.E.r0_")
-        var_name = Dadd_E_lc;
-      else if (prefix == "Dadd.A.r0_")
-        var_name = Dadd_A_lc;
-      else if (prefix == "Dadd.A.r1_")
-        var_name = Dadd_A_hc;
-      assert (var_name >= Unknown && var_name <= Dadd_A_hc);
-
-      if (prefix[0] == 'D')
-        word.chars = string (32, '?');
-
-      // Add the IDs
-      for (int i = 0, id = value, id2 = value; i < 32;
-           i++, id++, id2 += 4) {
-        if (prefix[0] == 'D') {
-          word.char_ids[i] = id2;
-          for (int j = 0; j < 4; j++)
-            state.vars_info[id2 + j] = {&word, step, i, var_name};
-          assert (id == value ? state.vars_info[id2].identity.col == 0
-                              : true);
-        } else if (is_f) {
-          word.ids_f[i] = id;
-          state.vars_info[id] = {&word, step, i, var_name};
-        } else {
-          word.ids_g[i] = id;
-          state.vars_info[id] = {&word, step, i, var_name};
-        }
-      }
-
-      // Add to observed vars
-      if (word.ids_f[0] != 0 && word.ids_g[0] != 0 && word.char_ids[0] != 0)
-        for (int i = 0; i < 32; i++) {
-          for (int j = 0; j < 4; j++)
-            solver->add_observed_var (word.char_ids[i] + j);
-        }
-    }
+  for (auto &prefix : word_prefixes (step)) {
+    if (prefix.prefix == actual_prefix)
+      add_4bit_word (*prefix.word, step, prefix.name, is_f ? 'f' : 'g',
+                     value, solver);
+    else if ('D' + prefix.prefix == actual_prefix)
+      add_4bit_word (*prefix.word, step, prefix.diff_name, 'D', value,
+                     solver);
   }
 }
 #endif
-} // namespace SHA256
\ No newline at end of file
+} // namespace SHA256
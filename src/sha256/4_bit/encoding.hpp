@@ -2,12 +2,21 @@
 #define _sha256_4_bit_encoding_hpp_INCLUDED
 
 #include "../../cadical.hpp"
+#include "../types.hpp"
 #include <string>
 
 using namespace std;
 
 namespace SHA256 {
+#if IS_4BIT
+// Register the IDs starting at 'id' as the 'f' or 'g' block values (32
+// consecutive IDs) or the characteristics ('D', 4 IDs per bit) of a word
+void add_4bit_word (Word &word, int step, VariableName var_name,
+                    char block, int id, CaDiCaL::Solver *solver);
+void set_4bit_zero (int id, CaDiCaL::Solver *solver);
+void set_4bit_order (int order, CaDiCaL::Solver *solver);
+#endif
 void add_4bit_variables (string line, CaDiCaL::Solver *&solver);
 } // namespace SHA256
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,103 @@
+#ifndef _sha256_4_bit_mendel_branch_hpp_INCLUDED
+#define _sha256_4_bit_mendel_branch_hpp_INCLUDED
+
+#include "../sha256.hpp"
+#include "../state.hpp"
+#include "../util.hpp"
+#include "2_bit.hpp"
+#include "state.hpp"
+#include <string>
+
+using namespace std;
+
+namespace SHA256 {
+#if IS_4BIT
+// Same stages as 'mendel_branch_1bit', with the decisions excluding pairs:
+// 'u' or 'n' for a difference, and '0' or '1' for a value
+inline void mendel_branch_4bit (State &state, list<int> &decision_lits,
+                                list<list<Equation>> &equations_trail,
+                                TwoBit &two_bit, Stats &stats) {
+  // Exclude one of the pairs 'first' and 'second' at random (the pairs
+  // which are assigned already can't be excluded)
+  auto rand_exclude = [&state] (list<int> &decision_lits, uint32_t base_id,
+                                int first, int second) {
+    int k = branch_random.generate_bool () ? first : second;
+    if (state.partial_assignment.get (base_id + k) != LIT_UNDEF)
+      k = k == first ? second : first;
+    if (state.partial_assignment.get (base_id + k) != LIT_UNDEF)
+      return false;
+    decision_lits.push_back (-int (base_id + k));
+    return true;
+  };
+
+  // Impose '-' for a characteristic with and without a difference, and
+  // 'u' or 'n' for 'x'
+  auto ground = [&state, &rand_exclude] (list<int> &decision_lits,
+                                         Word &word, int j) {
+    uint32_t base_id = word.char_ids[j];
+    uint8_t values = gc_values_4bit (word.chars[j]);
+    if ((values & 6) && (values & 9)) {
+      for (int k = 1; k <= 2; k++)
+        if ((values >> k & 1) &&
+            state.partial_assignment.get (base_id + k) == LIT_UNDEF) {
+          decision_lits.push_back (-int (base_id + k));
+          return true;
+        }
+    } else if (values == 6)
+      return rand_exclude (decision_lits, base_id, 1, 2);
+    return false;
+  };
+
+#if MENDEL_BRANCHING_STAGES >= 1
+  // Stage 1
+  for (int i = state.order - 1; i >= 0; i--) {
+    auto &w = state.steps[i].w;
+    for (int j = 31; j >= 0; j--)
+      if (ground (decision_lits, w, j))
+        return;
+  }
+#endif
+
+#if MENDEL_BRANCHING_STAGES >= 2
+  // Stage 2
+  for (int i = -4; i < state.order; i++) {
+    auto &a = state.steps[ABS_STEP (i)].a;
+    for (int j = 31; j >= 0; j--)
+      if (ground (decision_lits, a, j))
+        return;
+  }
+  for (int i = -4; i < state.order; i++) {
+    auto &e = state.steps[ABS_STEP (i)].e;
+    for (int j = 31; j >= 0; j--)
+      if (ground (decision_lits, e, j))
+        return;
+  }
+#endif
+
+  // Stage 3
+#if MENDEL_BRANCHING_STAGES == 3
+  // TODO: Handle blocking clauses
+  derive_2bit_equations_4bit (state, equations_trail.back (), two_bit,
+                              int (equations_trail.size () - 1), stats);
+  for (auto &level : equations_trail) {
+    for (auto &equation : level) {
+      for (int x = 0; x < 2; x++) {
+        auto &var_info = state.vars_info[equation.ids[x]];
+        auto &col = var_info.identity.col;
+        auto &word = var_info.word;
+        if (word->chars[col] != '-')
+          continue;
+        assert (col >= 0 && col <= 31);
+        if (!rand_exclude (decision_lits, word->char_ids[col], 0, 3))
+          continue;
+        stats.mendel_branching_stage3_count++;
+        return;
+      }
+    }
+  }
+#endif
+}
+#endif
+} // namespace SHA256
+
+#endif
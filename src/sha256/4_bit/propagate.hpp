@@ -1,14 +1,160 @@
 #ifndef _sha256_4_bit_propagate_hpp_INCLUDED
 #define _sha256_4_bit_propagate_hpp_INCLUDED
 
+#include "../propagate.hpp"
 #include "../state.hpp"
+#include "../strength.hpp"
+#include "../util.hpp"
+#include "state.hpp"
+#include <list>
 #include <string>
 
 using namespace std;
 
 namespace SHA256 {
-void custom_4bit_propagate (State &state, vector<int> &propagation_lits,
-                            map<int, Reason> &reasons);
+#if IS_4BIT
+inline void custom_4bit_propagate (State &state,
+                                   list<int> &propagation_lits,
+                                   map<int, Reason> &reasons,
+                                   Stats &stats) {
+  // Differential sizes
+  pair<int, int> prop_diff_sizes[NUM_OPS] = {{3, 1}, {3, 1}, {3, 1}, {3, 1},
+                                             {3, 1}, {3, 1}, {6, 3}, {5, 3},
+                                             {3, 3}, {7, 3}};
+  // Functions by operation IDs
+  vector<int> (*prop_functions[NUM_OPS]) (vector<int>) = {
+      xor_, xor_, xor_, xor_, maj_, ch_, add_, add_, add_, add_};
+
+  assert (propagation_lits.empty ());
+  for (auto level = state.prop_markings_trail.end ();
+       level-- != state.prop_markings_trail.begin ();) {
+    for (auto marking_it = level->end ();
+         marking_it-- != level->begin ();) {
+      auto op_id = marking_it->op_id;
+      auto step_i = marking_it->step_i;
+      auto bit_pos = marking_it->bit_pos;
+      auto basis = marking_it->basis;
+      marking_it = level->erase (marking_it);
+
+      // Construct the differential
+      int input_size = prop_diff_sizes[op_id].first,
+          output_size = prop_diff_sizes[op_id].second;
+      auto &input_words = state.operations[step_i].inputs_by_op_id[op_id];
+      auto &output_words = state.operations[step_i].outputs_by_op_id[op_id];
+      string input_chars, output_chars;
+      bool basis_found = false;
+      for (int i = 0; i < input_size; i++) {
+        input_chars += *input_words[i].chars[bit_pos];
+        if (input_words[i].char_ids[bit_pos] == basis)
+          basis_found = true;
+      }
+      for (int i = 0; i < output_size; i++) {
+        output_chars += output_words[i]->chars[bit_pos];
+        if (output_words[i]->char_ids[bit_pos] == basis)
+          basis_found = true;
+      }
+      assert (basis_found);
+      auto &function = prop_functions[op_id];
+
+      // Skip differentials with low probability
+      int q_count = 0;
+      for (auto &c : input_chars)
+        if (c == '?')
+          q_count++;
+      for (auto &c : output_chars)
+        if (c == '?')
+          q_count++;
+
+      if ((function != add_ && q_count == 0) ||
+          q_count == input_size + output_size)
+        continue;
+
+#if ADAPTIVE_PROP
+      if (!prop_strength.allows (op_id, step_i, q_count))
+        continue;
+#endif
+
+      // Propagate
+      auto output =
+          otf_propagate (function, input_chars, output_chars, &stats);
+      string &prop_input = output.first;
+      string &prop_output = output.second;
+#if ADAPTIVE_PROP
+      {
+        int props = 0;
+        for (int i = 0; i < input_size; i++)
+          props += prop_input[i] != input_chars[i];
+        for (int i = 0; i < output_size; i++)
+          props += prop_output[i] != output_chars[i];
+        prop_strength.record (op_id, step_i, strength_cost (input_chars),
+                              props);
+      }
+#endif
+      if (output_chars == prop_output && input_chars == prop_input)
+        continue;
+
+      // Construct the antecedent with inputs
+      Reason reason;
+      reason.op_id = op_id;
+      reason.step_i = step_i;
+      int const_zeroes_count = 0;
+      for (long x = 0; x < input_size; x++) {
+        if (input_chars[x] == '?')
+          continue;
+
+        // Count the const zeroes
+        if (input_words[x].ids_f[bit_pos] == state.zero_var_id) {
+          const_zeroes_count++;
+          continue;
+        }
+
+        auto &base_id = input_words[x].char_ids[bit_pos];
+        add_4bit_antecedent (state.partial_assignment, base_id,
+                             input_chars[x], reason.antecedent);
+
+        if (prop_input[x] == '#')
+          continue;
+
+        for (auto &lit : get_4bit_lits (state.partial_assignment, base_id,
+                                        prop_input[x]))
+          propagation_lits.push_back (lit);
+      }
+
+      if (reason.antecedent.empty ())
+        continue;
+
+      // Construct the antecedent with outputs
+      for (long x = 0; x < output_size; x++) {
+        // Ignore the high carry output if addends can't add up to >= 4
+        if (function == add_ && x == 0 &&
+            (input_size - const_zeroes_count) < 4)
+          continue;
+
+        if (output_words[x]->ids_f[bit_pos] == state.zero_var_id)
+          continue;
+
+        auto &base_id = output_words[x]->char_ids[bit_pos];
+        add_4bit_antecedent (state.partial_assignment, base_id,
+                             output_chars[x], reason.antecedent);
+
+        if (prop_output[x] == '#')
+          continue;
+
+        for (auto &lit : get_4bit_lits (state.partial_assignment, base_id,
+                                        prop_output[x]))
+          propagation_lits.push_back (lit);
+      }
+
+      // Since we're done with the antecedent, we can insert the reasons
+      for (auto &lit : propagation_lits)
+        reasons[lit] = reason;
+
+      if (!propagation_lits.empty ())
+        return;
+    }
+  }
+}
+#endif
 } // namespace SHA256
 
-#endif
\ No newline at end of file
+#endif
@@ -1,9 +1,12 @@
 #ifndef _sha256_4_bit_state_hpp_INCLUDED
 #define _sha256_4_bit_state_hpp_INCLUDED
 
+#include "../partial_assignment.hpp"
 #include "../types.hpp"
+#include "../util.hpp"
 #include <cinttypes>
 #include <string>
+#include <vector>
 
 using namespace std;
 
@@ -43,6 +46,41 @@ inline void refresh_4bit_char (uint8_t *diff, char &c) {
   else
     c = '?';
 }
+
+#if IS_4BIT
+// A characteristic holds because the variables of the (f, g) pairs it
+// excludes are false, so these make up its part of an antecedent
+inline void add_4bit_antecedent (PartialAssignment &partial_assignment,
+                                 uint32_t base_id, char c,
+                                 vector<int> &antecedent) {
+  uint8_t values = gc_values_4bit (c);
+  for (int k = 0; k < 4; k++) {
+    if (values >> k & 1)
+      continue;
+    assert (partial_assignment.get (base_id + k) == LIT_FALSE);
+    antecedent.push_back (base_id + k);
+  }
+}
+
+// Literals that narrow the characteristic down to 'c'
+inline vector<int> get_4bit_lits (PartialAssignment &partial_assignment,
+                                  uint32_t base_id, char c) {
+  vector<int> lits;
+  uint8_t values = gc_values_4bit (c);
+  for (int k = 0; k < 4; k++)
+    if (!(values >> k & 1) &&
+        partial_assignment.get (base_id + k) == LIT_UNDEF)
+      lits.push_back (-int (base_id + k));
+  return lits;
+}
+
+// Phase of a characteristic variable that prefers no difference
+inline int phase_4bit_lit (VarInfo &info, int var) {
+  int k = var - info.word->char_ids[info.identity.col];
+  assert (k >= 0 && k < 4);
+  return k == 1 || k == 2 ? -var : var;
+}
+#endif
 } // namespace SHA256
 
 #endif
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "blocking.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+
+namespace SHA256 {
+static bool
+removable (int lit, const unordered_set<int> &clause,
+           const unordered_map<int, vector<int>> &implications,
+           const function<bool (int)> &is_fixed,
+           unordered_map<int, bool> &cache, int depth) {
+  if (is_fixed (abs (lit)))
+    return true;
+  if (depth > BLOCKING_MINIMIZE_DEPTH)
+    return false;
+
+  auto cache_it = cache.find (lit);
+  if (cache_it != cache.end ())
+    return cache_it->second;
+
+  // The negation of the literal has to be implied by its antecedent
+  bool result = false;
+  auto implication_it = implications.find (abs (lit));
+  if (implication_it != implications.end ()) {
+    result = true;
+    for (auto &other : implication_it->second) {
+      if (clause.find (other) != clause.end ())
+        continue;
+      if (!removable (other, clause, implications, is_fixed, cache,
+                      depth + 1)) {
+        result = false;
+        break;
+      }
+    }
+  }
+
+  cache[lit] = result;
+  return result;
+}
+
+int minimize_blocking_clause (
+    vector<int> &clause,
+    const unordered_map<int, vector<int>> &implications,
+    const function<bool (int)> &is_fixed) {
+  unordered_set<int> lits (clause.begin (), clause.end ());
+  unordered_map<int, bool> cache;
+  vector<int> minimized;
+  for (auto &lit : lits)
+    if (!removable (lit, lits, implications, is_fixed, cache, 0))
+      minimized.push_back (lit);
+
+  int removed = clause.size () - minimized.size ();
+  clause = minimized;
+  return removed;
+}
+
+vector<vector<int>>
+select_blocking_clauses (vector<vector<int>> candidates,
+                         set<vector<int>> &added, int limit,
+                         uint64_t &duplicates) {
+  for (auto &candidate : candidates)
+    sort (candidate.begin (), candidate.end ());
+  stable_sort (candidates.begin (), candidates.end (),
+               [] (const vector<int> &a, const vector<int> &b) {
+                 return a.size () < b.size ();
+               });
+
+  vector<vector<int>> selected;
+  for (auto &candidate : candidates) {
+    if (int (selected.size ()) >= limit)
+      break;
+
+    if (added.count (candidate)) {
+      duplicates++;
+      continue;
+    }
+
+    // Only shorter (or equally long) clauses can subsume the candidate
+    bool subsumed = false;
+    for (auto &clause : selected)
+      if (includes (candidate.begin (), candidate.end (), clause.begin (),
+                    clause.end ())) {
+        subsumed = true;
+        break;
+      }
+    if (subsumed)
+      continue;
+
+    added.insert (candidate);
+    selected.push_back (candidate);
+  }
+
+  return selected;
+}
+} // namespace SHA256
@@ -0,0 +1,38 @@
+#ifndef _sha256_blocking_hpp_INCLUDED
+#define _sha256_blocking_hpp_INCLUDED
+
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Blocking clauses added per callback
+#define MAX_BLOCKING_CLAUSES 4
+// Recursion limit for removing literals through their antecedents
+#define BLOCKING_MINIMIZE_DEPTH 1000
+
+using namespace std;
+
+namespace SHA256 {
+// Remove the literals of a falsified blocking clause which are fixed at
+// the root level or whose negation was propagated with an antecedent
+// contained in the clause (recursively). This is the minimization of
+// 'minimize.cpp' restricted to the antecedents known to the propagator,
+// which are kept by variable. Returns the number of removed literals.
+int minimize_blocking_clause (
+    vector<int> &clause,
+    const unordered_map<int, vector<int>> &implications,
+    const function<bool (int)> &is_fixed);
+
+// Select up to 'limit' clauses, shortest first, skipping the ones in
+// 'added' and the ones subsumed by a selected clause. The selected clauses
+// are sorted and inserted into 'added'.
+vector<vector<int>>
+select_blocking_clauses (vector<vector<int>> candidates,
+                         set<vector<int>> &added, int limit,
+                         uint64_t &duplicates);
+} // namespace SHA256
+
+#endif
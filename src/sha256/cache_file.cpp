@@ -0,0 +1,261 @@
+#include "cache_file.hpp"
+#include "2_bit.hpp"
+#include "lru_cache.hpp"
+#include "propagate.hpp"
+#include "types.hpp"
+#include "wordwise_propagate.hpp"
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+
+namespace SHA256 {
+static_assert (is_trivially_copyable<TwoBitRelations>::value,
+               "the 2-bit relations are stored as they are in memory");
+
+static const char cache_file_magic[8] = {'S', 'H', 'A', '2',
+                                         '5', '6', 'R', 'C'};
+
+// The rules depend on the encoding through the functions and the words
+static const uint32_t cache_file_encoding = IS_LI2024 ? 3 : IS_4BIT ? 2 : 1;
+
+// Records and values are bounded so that corrupted sizes are detected
+#define CACHE_FILE_MAX_SIZE (1 << 16)
+// Size of the chunks of records written at once
+#define CACHE_FILE_CHUNK_SIZE (1 << 20)
+
+enum RecordKind : uint8_t { prop_record, two_bit_record, wordwise_record };
+
+// FNV-1a
+static uint32_t checksum (const char *bytes, size_t size) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= uint8_t (bytes[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static uint64_t key_hash (uint8_t kind, const string &key) {
+  return hash<string> () (string (1, char (kind)) + key);
+}
+
+static void put_u32 (string &bytes, uint32_t value) {
+  bytes.append ((const char *) &value, sizeof (value));
+}
+
+static string encode_pair (const pair<string, string> &value) {
+  string bytes;
+  put_u32 (bytes, value.first.size ());
+  return bytes + value.first + value.second;
+}
+
+static bool decode_pair (const string &bytes, pair<string, string> &value) {
+  uint32_t first_size;
+  if (bytes.size () < sizeof (first_size))
+    return false;
+  memcpy (&first_size, bytes.data (), sizeof (first_size));
+  if (bytes.size () - sizeof (first_size) < first_size)
+    return false;
+  value.first = bytes.substr (sizeof (first_size), first_size);
+  value.second = bytes.substr (sizeof (first_size) + first_size);
+  return true;
+}
+
+static void add_record (string &bytes, uint8_t kind, const string &key,
+                        const string &value) {
+  size_t start = bytes.size ();
+  bytes += char (kind);
+  put_u32 (bytes, key.size ());
+  put_u32 (bytes, value.size ());
+  bytes += key;
+  bytes += value;
+  put_u32 (bytes, checksum (bytes.data () + start, bytes.size () - start));
+}
+
+// Put a rule read from the file in its cache
+static bool put_rule (uint8_t kind, const string &key,
+                      const string &value) {
+  pair<string, string> strings;
+  switch (kind) {
+  case prop_record:
+    if (!decode_pair (value, strings))
+      return false;
+    otf_prop_cache.put (key, strings);
+    return true;
+  case two_bit_record: {
+    uint64_t two_bit_key;
+    TwoBitRelations relations;
+    if (key.size () != sizeof (two_bit_key) ||
+        value.size () != sizeof (relations))
+      return false;
+    memcpy (&two_bit_key, key.data (), sizeof (two_bit_key));
+    memcpy (&relations, value.data (), sizeof (relations));
+    otf_2bit_cache.put (two_bit_key, relations);
+    return true;
+  }
+  case wordwise_record:
+    if (!decode_pair (value, strings))
+      return false;
+    wordwise_propagate_cache.put (key, strings);
+    return true;
+  default:
+    return false;
+  }
+}
+
+static string header () {
+  string bytes (cache_file_magic, sizeof (cache_file_magic));
+  put_u32 (bytes, CACHE_FILE_VERSION);
+  put_u32 (bytes, cache_file_encoding);
+  put_u32 (bytes, sizeof (TwoBitRelations));
+  return bytes;
+}
+
+static bool write_all (int fd, const string &bytes) {
+  size_t written = 0;
+  while (written < bytes.size ()) {
+    ssize_t n =
+        write (fd, bytes.data () + written, bytes.size () - written);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return false;
+    written += n;
+  }
+  return true;
+}
+
+bool CacheFile::read_header (FILE *file) {
+  string expected = header (), actual (expected.size (), 0);
+  return fread (&actual[0], 1, actual.size (), file) == actual.size () &&
+         actual == expected;
+}
+
+const char *CacheFile::load () {
+  FILE *file = fopen (path.c_str (), "rb");
+  if (!file) {
+    if (errno == ENOENT)
+      return 0;
+    return "can not read rule cache";
+  }
+  if (!read_header (file)) {
+    fclose (file);
+    printf ("Ignoring the rules in '%s' (other version or encoding)\n",
+            path.c_str ());
+    rewrite = true;
+    return 0;
+  }
+
+  string record;
+  while (true) {
+    uint8_t kind;
+    uint32_t sizes[2];
+    if (fread (&kind, 1, 1, file) != 1)
+      break;
+
+    // A torn or corrupted record ends the rules which can be trusted
+    if (fread (sizes, sizeof (uint32_t), 2, file) != 2 ||
+        sizes[0] > CACHE_FILE_MAX_SIZE || sizes[1] > CACHE_FILE_MAX_SIZE) {
+      rewrite = true;
+      break;
+    }
+    size_t rest = sizes[0] + sizes[1] + sizeof (uint32_t);
+    record.assign (1, char (kind));
+    record.append ((const char *) sizes, sizeof (sizes));
+    record.resize (record.size () + rest);
+    if (fread (&record[record.size () - rest], 1, rest, file) != rest) {
+      rewrite = true;
+      break;
+    }
+    uint32_t expected;
+    size_t checked_size = record.size () - sizeof (expected);
+    memcpy (&expected, record.data () + checked_size, sizeof (expected));
+    size_t key_start = 1 + sizeof (sizes);
+    string key = record.substr (key_start, sizes[0]);
+    string value = record.substr (key_start + sizes[0], sizes[1]);
+    if (checksum (record.data (), checked_size) != expected ||
+        !put_rule (kind, key, value)) {
+      rewrite = true;
+      break;
+    }
+
+    records_in_file++;
+    keys_in_file.insert (key_hash (kind, key));
+    loaded++;
+  }
+  fclose (file);
+
+  if (records_in_file > CACHE_FILE_DUPLICATES_FACTOR * keys_in_file.size ())
+    rewrite = true;
+  return 0;
+}
+
+bool CacheFile::write_records (int fd, bool all) {
+  string bytes;
+  bool ok = true;
+  auto add = [&] (uint8_t kind, const string &key, const string &value) {
+    if (!ok)
+      return;
+    bool is_new = keys_in_file.insert (key_hash (kind, key)).second;
+    if (!all && !is_new)
+      return;
+    add_record (bytes, kind, key, value);
+    records_in_file++;
+    saved++;
+    if (bytes.size () < CACHE_FILE_CHUNK_SIZE)
+      return;
+    ok = write_all (fd, bytes);
+    bytes.clear ();
+  };
+
+  otf_prop_cache.for_each (
+      [&] (const string &key, const pair<string, string> &value) {
+        add (prop_record, key, encode_pair (value));
+      });
+  otf_2bit_cache.for_each (
+      [&] (const uint64_t &key, const TwoBitRelations &relations) {
+        add (two_bit_record, string ((const char *) &key, sizeof (key)),
+             string ((const char *) &relations, sizeof (relations)));
+      });
+  wordwise_propagate_cache.for_each (
+      [&] (const string &key, const pair<string, string> &value) {
+        add (wordwise_record, key, encode_pair (value));
+      });
+
+  return ok && write_all (fd, bytes);
+}
+
+const char *CacheFile::save () {
+  saved = 0;
+  if (!rewrite) {
+    int fd = open (path.c_str (), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0)
+      return "can not write rule cache";
+    struct stat st;
+    bool ok = !fstat (fd, &st) &&
+              (st.st_size || write_all (fd, header ())) &&
+              write_records (fd, false);
+    if (close (fd) || !ok)
+      return "can not write rule cache";
+    return 0;
+  }
+
+  // Replace the file at once so that runs reading it see either version
+  string tmp_path = path + ".tmp";
+  int fd = open (tmp_path.c_str (), O_WRONLY | O_TRUNC | O_CREAT, 0644);
+  if (fd < 0)
+    return "can not write rule cache";
+  keys_in_file.clear ();
+  records_in_file = 0;
+  bool ok = write_all (fd, header ()) && write_records (fd, true);
+  if (close (fd) || !ok || rename (tmp_path.c_str (), path.c_str ()))
+    return "can not write rule cache";
+  rewrite = false;
+  return 0;
+}
+} // namespace SHA256
@@ -0,0 +1,48 @@
+#ifndef _sha256_cache_file_hpp_INCLUDED
+#define _sha256_cache_file_hpp_INCLUDED
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_set>
+
+// Bump whenever the records or the cached values change their meaning
+#define CACHE_FILE_VERSION 1
+// Rewrite the file once it holds this many times more records than
+// distinct ones (concurrent runs append the same rules)
+#define CACHE_FILE_DUPLICATES_FACTOR 2
+
+using namespace std;
+
+namespace SHA256 {
+// The propagation, 2-bit and wordwise propagation caches persisted across
+// runs. The file starts with a header and continues with one record per
+// rule, each with its own checksum. Runs append the rules they derived
+// with writes of whole records, and a file with a bad header or torn
+// records is rewritten from the rules which could be loaded.
+class CacheFile {
+  string path;
+  // Hashes of the cache keys in the file
+  unordered_set<uint64_t> keys_in_file;
+  uint64_t records_in_file = 0;
+  bool rewrite = false;
+
+  bool read_header (FILE *file);
+  // Write the cached rules not in the file yet (all of them if 'all') in
+  // chunks of whole records
+  bool write_records (int fd, bool all);
+
+public:
+  uint64_t loaded = 0, saved = 0;
+
+  CacheFile (const string &path) : path (path) {}
+
+  // Put the rules of the file in the caches (the file may not exist yet).
+  // Returns an error message or 0 on success.
+  const char *load ();
+  // Append the new rules or rewrite the file if needed
+  const char *save ();
+};
+} // namespace SHA256
+
+#endif
@@ -0,0 +1,282 @@
+#include "callback_trace.hpp"
+#include "sha256.hpp"
+#include "types.hpp"
+#include <chrono>
+#include <cinttypes>
+#include <cstring>
+
+namespace SHA256 {
+static const char callback_trace_magic[8] = {'S', 'H', 'A', '2',
+                                             '5', '6', 'C', 'T'};
+
+// The literals only mean the same with the same encoding
+static const uint32_t callback_trace_encoding =
+    IS_LI2024 ? 3 : IS_4BIT ? 2 : 1;
+
+const char *callback_event_names[event_kinds] = {
+    "",
+    "notify_assignment",
+    "notify_assignment (fixed)",
+    "notify_new_decision_level",
+    "notify_backtrack",
+    "cb_check_found_model",
+    "cb_has_external_clause",
+    "cb_add_external_clause_lit",
+    "cb_decide",
+    "cb_propagate",
+    "cb_is_dirty",
+    "cb_add_reason_clause_lit",
+};
+
+static uint32_t zigzag (int lit) {
+  return (uint32_t (lit) << 1) ^ uint32_t (lit >> 31);
+}
+
+static int unzigzag (uint64_t value) {
+  return int (value >> 1) ^ -int (value & 1);
+}
+
+/*------------------------------------------------------------------------*/
+
+CallbackRecorder::CallbackRecorder (
+    CaDiCaL::ExternalPropagator *propagator, FILE *file, uint32_t seed)
+    : propagator (propagator), file (file) {
+  is_lazy = propagator->is_lazy;
+  branch_random = seed;
+  uint32_t header[3] = {CALLBACK_TRACE_VERSION, callback_trace_encoding,
+                        seed};
+  fwrite (callback_trace_magic, sizeof (callback_trace_magic), 1, file);
+  fwrite (header, sizeof (header), 1, file);
+}
+
+void CallbackRecorder::put_event (CallbackEvent event) {
+  putc_unlocked (event, file);
+  events++;
+}
+
+void CallbackRecorder::put_uint (uint64_t value) {
+  while (value >= 0x80) {
+    putc_unlocked (uint8_t (value) | 0x80, file);
+    value >>= 7;
+  }
+  putc_unlocked (value, file);
+}
+
+void CallbackRecorder::put_lit (int lit) { put_uint (zigzag (lit)); }
+
+void CallbackRecorder::notify_assignment (int lit, bool is_fixed) {
+  put_event (is_fixed ? event_fixed_assignment : event_assignment);
+  put_lit (lit);
+  propagator->notify_assignment (lit, is_fixed);
+}
+
+void CallbackRecorder::notify_new_decision_level () {
+  put_event (event_new_decision_level);
+  propagator->notify_new_decision_level ();
+}
+
+void CallbackRecorder::notify_backtrack (size_t new_level) {
+  put_event (event_backtrack);
+  put_uint (new_level);
+  propagator->notify_backtrack (new_level);
+}
+
+bool CallbackRecorder::cb_check_found_model (const vector<int> &model) {
+  put_event (event_check_found_model);
+  put_uint (model.size ());
+  for (auto &lit : model)
+    put_lit (lit);
+  bool res = propagator->cb_check_found_model (model);
+  put_lit (res);
+  return res;
+}
+
+bool CallbackRecorder::cb_has_external_clause () {
+  put_event (event_has_external_clause);
+  bool res = propagator->cb_has_external_clause ();
+  put_lit (res);
+  return res;
+}
+
+int CallbackRecorder::cb_add_external_clause_lit () {
+  put_event (event_add_external_clause_lit);
+  int res = propagator->cb_add_external_clause_lit ();
+  put_lit (res);
+  return res;
+}
+
+int CallbackRecorder::cb_decide () {
+  put_event (event_decide);
+  int res = propagator->cb_decide ();
+  put_lit (res);
+  return res;
+}
+
+int CallbackRecorder::cb_propagate () {
+  put_event (event_propagate);
+  int res = propagator->cb_propagate ();
+  put_lit (res);
+  return res;
+}
+
+bool CallbackRecorder::cb_is_dirty () {
+  put_event (event_is_dirty);
+  bool res = propagator->cb_is_dirty ();
+  put_lit (res);
+  return res;
+}
+
+int CallbackRecorder::cb_add_reason_clause_lit (int propagated_lit) {
+  put_event (event_add_reason_clause_lit);
+  put_lit (propagated_lit);
+  int res = propagator->cb_add_reason_clause_lit (propagated_lit);
+  put_lit (res);
+  return res;
+}
+
+/*------------------------------------------------------------------------*/
+
+const char *CallbackReplay::read (FILE *file) {
+  char magic[sizeof (callback_trace_magic)];
+  uint32_t header[3];
+  if (fread (magic, sizeof (magic), 1, file) != 1 ||
+      memcmp (magic, callback_trace_magic, sizeof (magic)) ||
+      fread (header, sizeof (header), 1, file) != 1)
+    return "not a callback trace";
+  if (header[0] != CALLBACK_TRACE_VERSION)
+    return "callback trace of another version";
+  if (header[1] != callback_trace_encoding)
+    return "callback trace of another encoding";
+  seed = header[2];
+
+  uint8_t buffer[1 << 16];
+  size_t n;
+  while ((n = fread (buffer, 1, sizeof (buffer), file)) > 0)
+    bytes.insert (bytes.end (), buffer, buffer + n);
+  if (ferror (file))
+    return "can not read callback trace";
+  pos = 0;
+  return 0;
+}
+
+bool CallbackReplay::get_uint (uint64_t &value) {
+  value = 0;
+  for (int shift = 0; shift < 64 && pos < bytes.size (); shift += 7) {
+    uint8_t byte = bytes[pos++];
+    value |= uint64_t (byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+      return true;
+  }
+  return false;
+}
+
+bool CallbackReplay::get_lit (int &lit) {
+  uint64_t value;
+  if (!get_uint (value) || value > UINT32_MAX)
+    return false;
+  lit = unzigzag (value);
+  return true;
+}
+
+const char *CallbackReplay::fail (const char *what, int64_t expected,
+                                  int64_t actual) {
+  char message[160];
+  if (expected == actual)
+    snprintf (message, sizeof (message), "%s at event %" PRIu64, what,
+              events);
+  else
+    snprintf (message, sizeof (message),
+              "%s returned %" PRId64 " instead of %" PRId64
+              " at event %" PRIu64,
+              what, actual, expected, events);
+  error = message;
+  return error.c_str ();
+}
+
+const char *
+CallbackReplay::replay (CaDiCaL::ExternalPropagator *propagator) {
+  branch_random = seed;
+  vector<int> model;
+  while (pos < bytes.size ()) {
+    uint8_t event = bytes[pos++];
+    if (!event || event >= event_kinds)
+      return fail ("invalid event");
+
+    // Decode the arguments and the result first so that only the
+    // propagator is timed
+    int lit = 0, expected = 0, actual = 0;
+    uint64_t value = 0;
+    bool ok = true;
+    switch (event) {
+    case event_assignment:
+    case event_fixed_assignment:
+      ok = get_lit (lit);
+      break;
+    case event_new_decision_level:
+      break;
+    case event_backtrack:
+      ok = get_uint (value);
+      break;
+    case event_check_found_model:
+      ok = get_uint (value) && value <= bytes.size () - pos;
+      model.resize (ok ? value : 0);
+      for (auto &model_lit : model)
+        ok = ok && get_lit (model_lit);
+      ok = ok && get_lit (expected);
+      break;
+    case event_add_reason_clause_lit:
+      ok = get_lit (lit) && get_lit (expected);
+      break;
+    default:
+      ok = get_lit (expected);
+      break;
+    }
+    if (!ok)
+      return fail ("truncated event");
+
+    auto start = chrono::steady_clock::now ();
+    switch (event) {
+    case event_assignment:
+    case event_fixed_assignment:
+      propagator->notify_assignment (lit,
+                                     event == event_fixed_assignment);
+      break;
+    case event_new_decision_level:
+      propagator->notify_new_decision_level ();
+      break;
+    case event_backtrack:
+      propagator->notify_backtrack (value);
+      break;
+    case event_check_found_model:
+      actual = propagator->cb_check_found_model (model);
+      break;
+    case event_has_external_clause:
+      actual = propagator->cb_has_external_clause ();
+      break;
+    case event_add_external_clause_lit:
+      actual = propagator->cb_add_external_clause_lit ();
+      break;
+    case event_decide:
+      actual = propagator->cb_decide ();
+      break;
+    case event_propagate:
+      actual = propagator->cb_propagate ();
+      break;
+    case event_is_dirty:
+      actual = propagator->cb_is_dirty ();
+      break;
+    case event_add_reason_clause_lit:
+      actual = propagator->cb_add_reason_clause_lit (lit);
+      break;
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now () - start;
+    seconds[event] += elapsed.count ();
+    counts[event]++;
+
+    if (actual != expected)
+      return fail (callback_event_names[event], expected, actual);
+    events++;
+  }
+  return 0;
+}
+} // namespace SHA256
@@ -0,0 +1,96 @@
+#ifndef _sha256_callback_trace_hpp_INCLUDED
+#define _sha256_callback_trace_hpp_INCLUDED
+
+#include "../cadical.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Bump whenever the events or their arguments change
+#define CALLBACK_TRACE_VERSION 2
+
+using namespace std;
+
+namespace SHA256 {
+enum CallbackEvent : uint8_t {
+  event_assignment = 1,
+  event_fixed_assignment,
+  event_new_decision_level,
+  event_backtrack,
+  event_check_found_model,
+  event_has_external_clause,
+  event_add_external_clause_lit,
+  event_decide,
+  event_propagate,
+  event_is_dirty,
+  event_add_reason_clause_lit,
+  event_kinds
+};
+
+extern const char *callback_event_names[event_kinds];
+
+// Connected to the solver instead of the propagator, forwarding the
+// callbacks to it and writing them with their results to the file. After
+// a header with the seed of 'branch_random', each event is a byte followed by its arguments and its result
+// as variable-length integers (zig-zag encoded for the literals and the
+// results).
+class CallbackRecorder : public CaDiCaL::ExternalPropagator {
+  CaDiCaL::ExternalPropagator *propagator;
+  FILE *file;
+
+  void put_event (CallbackEvent event);
+  void put_uint (uint64_t value);
+  void put_lit (int lit);
+
+public:
+  uint64_t events = 0;
+
+  // Writes the header and seeds 'branch_random'
+  CallbackRecorder (CaDiCaL::ExternalPropagator *propagator, FILE *file,
+                    uint32_t seed);
+
+  void notify_assignment (int lit, bool is_fixed);
+  void notify_new_decision_level ();
+  void notify_backtrack (size_t new_level);
+  bool cb_check_found_model (const std::vector<int> &model);
+  bool cb_has_external_clause ();
+  int cb_add_external_clause_lit ();
+  int cb_decide ();
+  int cb_propagate ();
+  bool cb_is_dirty ();
+  int cb_add_reason_clause_lit (int propagated_lit);
+  // Not recorded as it does not influence the search
+  void notify_checkpoint () { propagator->notify_checkpoint (); }
+};
+
+// Feeds a recorded trace to a propagator set up with the same instance,
+// without a solver, and checks that it returns the recorded results. The
+// propagator has to be deterministic, which is why 'branch_random' is
+// seeded as during the recording.
+class CallbackReplay {
+  vector<uint8_t> bytes;
+  size_t pos = 0;
+  uint32_t seed = 0;
+  string error;
+
+  bool get_uint (uint64_t &value);
+  bool get_lit (int &lit);
+  const char *fail (const char *what, int64_t expected = 0,
+                    int64_t actual = 0);
+
+public:
+  uint64_t events = 0;
+  // Events and time spent in the propagator by event kind
+  uint64_t counts[event_kinds] = {0};
+  double seconds[event_kinds] = {0};
+
+  // Read the trace. Returns an error message or 0 on success.
+  const char *read (FILE *file);
+  // Seeds 'branch_random' and returns an error message (on the first
+  // mismatch) or 0 on success
+  const char *replay (CaDiCaL::ExternalPropagator *propagator);
+};
+} // namespace SHA256
+
+#endif
@@ -0,0 +1,369 @@
+#include "generate.hpp"
+#include "1_bit/2_bit.hpp"
+#include "1_bit/encoding.hpp"
+#include "4_bit/encoding.hpp"
+#include "sha256.hpp"
+#include "util.hpp"
+#include "verify.hpp"
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace SHA256 {
+// Error message of the last failed generation
+static string generate_error;
+
+static const char *generate_failed (const string &message) {
+  generate_error = message;
+  return generate_error.c_str ();
+}
+
+#if IS_1BIT || IS_4BIT
+// Number of IDs taken by a word and by the zero variables
+#if IS_4BIT
+static const int word_ids_count = 192, zero_ids_count = 6;
+#else
+static const int word_ids_count = 96, zero_ids_count = 3;
+#endif
+
+vector<vector<int>> characteristic_clauses (Word &word, int bit, char c) {
+  vector<vector<int>> clauses;
+  uint8_t pairs = gc_pairs (c);
+  if (!pairs)
+    return clauses;
+
+#if IS_4BIT
+  // Exclude the value pairs which aren't allowed (00, 10, 01 and 11)
+  for (int pair = 0; pair < 4; pair++)
+    if (!(pairs >> pair & 1))
+      clauses.push_back ({-int (word.char_ids[bit] + pair)});
+#else
+  // Forbid the value pairs which aren't allowed (00, 10, 01 and 11)
+  int f = word.ids_f[bit], g = word.ids_g[bit], d = word.char_ids[bit];
+  for (int pair = 0; pair < 4; pair++)
+    if (!(pairs >> pair & 1))
+      clauses.push_back ({pair & 1 ? -f : f, pair & 2 ? -g : g});
+
+  // Fix the difference if it's the same for all the pairs
+  if (!(pairs & 6))
+    clauses.push_back ({-d});
+  else if (!(pairs & 9))
+    clauses.push_back ({d});
+#endif
+  return clauses;
+}
+
+class Generator {
+  CaDiCaL::Solver *solver;
+  State &state;
+  int next_id = 1;
+  uint64_t clauses_count = 0;
+
+  void add_clause (const vector<int> &clause) {
+    for (auto &lit : clause)
+      solver->add (lit);
+    solver->add (0);
+    clauses_count++;
+  }
+
+  // Values of the zero variables and the round constants are known
+  bool is_constant (uint32_t id, int &value) {
+    if (id >= state.zero_var_id &&
+        id < state.zero_var_id + zero_ids_count) {
+      value = 0;
+      return true;
+    }
+    auto &identity = state.vars_info[id].identity;
+    if (identity.name == DK) {
+      value = 0;
+      return true;
+    }
+    if (identity.name == K) {
+      value = k_constants[identity.step] >> identity.col & 1;
+      return true;
+    }
+    return false;
+  }
+
+  void add_word (Word &word, int step, VariableName name,
+                 VariableName diff_name) {
+#if IS_4BIT
+    add_4bit_word (word, step, name, 'f', next_id, solver);
+    add_4bit_word (word, step, name, 'g', next_id + 32, solver);
+    add_4bit_word (word, step, diff_name, 'D', next_id + 64, solver);
+#else
+    add_1bit_word (word, step, name, 'f', next_id, solver);
+    add_1bit_word (word, step, name, 'g', next_id + 32, solver);
+    add_1bit_word (word, step, diff_name, 'D', next_id + 64, solver);
+#endif
+    next_id += word_ids_count;
+  }
+
+  void add_zero () {
+#if IS_4BIT
+    // Both values are 0, so only the pair 00 is possible
+    set_4bit_zero (next_id, solver);
+    for (int i = 0; i < zero_ids_count; i++)
+      add_clause ({i == 2 ? next_id + i : -(next_id + i)});
+#else
+    set_1bit_zero (next_id, solver);
+    for (int i = 0; i < zero_ids_count; i++)
+      add_clause ({-(next_id + i)});
+#endif
+    next_id += zero_ids_count;
+  }
+
+#if IS_4BIT
+  // The pair of values of both blocks must be one of the possible pairs
+  void add_differences (Word &word) {
+    for (int i = 0; i < 32; i++) {
+      int f = word.ids_f[i], g = word.ids_g[i], base = word.char_ids[i];
+      for (int k = 0; k < 4; k++)
+        add_clause ({k & 1 ? -f : f, k & 2 ? -g : g, base + k});
+    }
+  }
+
+  // A fresh variable which implies a difference in the bit
+  int add_difference_lit (Word &word, int bit) {
+    int f = word.ids_f[bit], g = word.ids_g[bit], d = next_id++;
+    add_clause ({-d, f, g});
+    add_clause ({-d, -f, -g});
+    return d;
+  }
+#else
+  // The difference is the XOR of the values of both blocks
+  void add_differences (Word &word) {
+    for (int i = 0; i < 32; i++) {
+      int f = word.ids_f[i], g = word.ids_g[i], d = word.char_ids[i];
+      add_clause ({-d, f, g});
+      add_clause ({-d, -f, -g});
+      add_clause ({d, -f, g});
+      add_clause ({d, f, -g});
+    }
+  }
+
+  int add_difference_lit (Word &word, int bit) {
+    return word.char_ids[bit];
+  }
+#endif
+
+  // Encode 'outputs = func (inputs)' through its truth table over the
+  // inputs which aren't constant
+  void add_function (vector<int> (*func) (vector<int>),
+                     const vector<uint32_t> &inputs,
+                     const vector<uint32_t> &outputs) {
+    vector<int> values (inputs.size (), 0);
+    vector<int> free_inputs;
+    for (size_t i = 0; i < inputs.size (); i++)
+      if (!is_constant (inputs[i], values[i]))
+        free_inputs.push_back (i);
+
+    for (uint32_t assignment = 0; assignment < 1u << free_inputs.size ();
+         assignment++) {
+      // The clauses are falsified by exactly this assignment
+      vector<int> clause;
+      for (size_t k = 0; k < free_inputs.size (); k++) {
+        int i = free_inputs[k];
+        values[i] = assignment >> k & 1;
+        clause.push_back (values[i] ? -int (inputs[i]) : int (inputs[i]));
+      }
+
+      auto results = func (values);
+      assert (results.size () == outputs.size ());
+      for (size_t k = 0; k < outputs.size (); k++) {
+        int value;
+        if (is_constant (outputs[k], value)) {
+          if (value != results[k])
+            add_clause (clause);
+          continue;
+        }
+        int output = outputs[k];
+        clause.push_back (results[k] ? output : -output);
+        add_clause (clause);
+        clause.pop_back ();
+      }
+    }
+  }
+
+  const char *add_characteristic (Word &word, int bit, char c) {
+    if (!gc_pairs (c))
+      return generate_failed (string ("invalid characteristic '") + c +
+                              "'");
+    for (auto &clause : characteristic_clauses (word, bit, c))
+      add_clause (clause);
+    return 0;
+  }
+
+  const char *add_characteristic (Word &word, const string &chars) {
+    if (chars.size () != 32)
+      return generate_failed ("expected 32 characteristics in '" + chars +
+                              "'");
+    // The most significant bit comes first
+    for (int i = 0; i < 32; i++)
+      if (const char *err = add_characteristic (word, i, chars[31 - i]))
+        return err;
+    return 0;
+  }
+
+  const char *add_characteristic (const string &path, int order) {
+    ifstream file (path);
+    if (!file.is_open ())
+      return generate_failed ("can not read characteristic '" + path +
+                              "'");
+
+    string line;
+    while (getline (file, line)) {
+      if (line.empty () || line[0] == '#')
+        continue;
+      istringstream iss (line);
+      int step;
+      string a, e, w;
+      if (!(iss >> step >> a >> e) || step < -4 || step >= order)
+        return generate_failed ("invalid characteristic line '" + line +
+                                "'");
+      const char *err;
+      if ((err = add_characteristic (state.steps[ABS_STEP (step)].a, a)))
+        return err;
+      if ((err = add_characteristic (state.steps[ABS_STEP (step)].e, e)))
+        return err;
+      if (!(iss >> w))
+        continue;
+      if (step < 0)
+        return generate_failed ("no message word in line '" + line + "'");
+      if ((err = add_characteristic (state.steps[step].w, w)))
+        return err;
+    }
+
+    return 0;
+  }
+
+  // Ask for a collision: no difference in the first and last four states
+  // but some difference in the message
+  void add_collision (int order) {
+    string no_diff (32, '-');
+    for (int i = 0; i < 4; i++) {
+      add_characteristic (state.steps[i].a, no_diff);
+      add_characteristic (state.steps[i].e, no_diff);
+      add_characteristic (state.steps[order + i].a, no_diff);
+      add_characteristic (state.steps[order + i].e, no_diff);
+    }
+
+    vector<int> clause;
+    for (int i = 0; i < min (order, 16); i++)
+      for (int j = 0; j < 32; j++)
+        clause.push_back (add_difference_lit (state.steps[i].w, j));
+    add_clause (clause);
+  }
+
+public:
+  Generator (CaDiCaL::Solver *solver)
+      : solver (solver), state (Propagator::state) {}
+
+  const char *generate (int order, const string &characteristic) {
+    add_zero ();
+
+    // The words of the steps (A and E from step -4 on)
+    vector<Word *> words;
+    for (int i = 0; i < order + 4; i++)
+      for (auto &prefix : word_prefixes (i)) {
+        bool is_state = prefix.name == A || prefix.name == E;
+        if (!is_state && i >= order)
+          continue;
+        if (!is_state && i < 16 &&
+            (prefix.name == sigma0 || prefix.name == sigma1 ||
+             prefix.name == add_W_lc || prefix.name == add_W_hc))
+          continue;
+        if (next_id + word_ids_count >= MAX_VAR_ID)
+          return generate_failed ("too many variables");
+        add_word (*prefix.word, i, prefix.name, prefix.diff_name);
+        words.push_back (prefix.word);
+      }
+    for (auto &word : words)
+      add_differences (*word);
+
+#if IS_4BIT
+    set_4bit_order (order, solver);
+#else
+    set_1bit_order (order, solver);
+#endif
+
+    // The operations of both blocks and the differences of the XORs (only
+    // the 1-bit encoding has variables for them)
+    for (int i = 0; i < order; i++)
+      for (int op_id = 0; op_id < NUM_OPS; op_id++) {
+        if (i < 16 && (op_id == op_s0 || op_id == op_s1 ||
+                       op_id == op_add_w))
+          continue;
+
+        auto func = two_bit_functions[op_id];
+        int inputs_size = two_bit_diff_sizes[op_id].first;
+        int outputs_size = two_bit_diff_sizes[op_id].second;
+        auto &inputs = state.operations[i].inputs_by_op_id[op_id];
+        auto &outputs = state.operations[i].outputs_by_op_id[op_id];
+        for (int pos = 0; pos < 32; pos++)
+          for (int block = 0; block < 3; block++) {
+            if (block == 2 && (IS_4BIT || func != xor_))
+              continue;
+            vector<uint32_t> input_ids, output_ids;
+            for (int k = 0; k < inputs_size; k++)
+              input_ids.push_back (block == 0   ? inputs[k].ids_f[pos]
+                                   : block == 1 ? inputs[k].ids_g[pos]
+                                                : inputs[k].char_ids[pos]);
+            for (int k = 0; k < outputs_size; k++)
+              output_ids.push_back (block == 0 ? outputs[k]->ids_f[pos]
+                                    : block == 1
+                                        ? outputs[k]->ids_g[pos]
+                                        : outputs[k]->char_ids[pos]);
+            add_function (func, input_ids, output_ids);
+          }
+      }
+
+    // The round constants are the same in both blocks
+    for (int i = 0; i < order; i++)
+      for (int j = 0; j < 32; j++)
+        add_characteristic (state.steps[i].k, j,
+                            k_constants[i] >> j & 1 ? '1' : '0');
+
+    if (characteristic.empty ())
+      add_collision (order);
+    else if (const char *err = add_characteristic (characteristic, order))
+      return err;
+
+    printf ("Generated %d steps with %d variables and %ld clauses.\n",
+            order, next_id - 1, clauses_count);
+    return 0;
+  }
+};
+
+const char *generate_encoding (CaDiCaL::Solver *solver, const char *spec) {
+  string steps, encoding, characteristic;
+  istringstream iss (spec);
+  getline (iss, steps, ',');
+  getline (iss, encoding, ',');
+  getline (iss, characteristic);
+
+  int order = atoi (steps.c_str ());
+  if (order < 1 || order > 64 || to_string (order) != steps)
+    return generate_failed ("invalid number of steps '" + steps +
+                            "' (expected '1..64')");
+  string expected = IS_4BIT ? "4bit" : "1bit";
+  if (encoding != expected)
+    return generate_failed ("can not generate encoding '" + encoding +
+                            "' (expected '" + expected + "')");
+
+  Generator generator (solver);
+  return generator.generate (order, characteristic);
+}
+#else
+const char *generate_encoding (CaDiCaL::Solver *solver, const char *spec) {
+  (void) solver, (void) spec;
+  return generate_failed (
+      "only the 1-bit and 4-bit encodings can be generated");
+}
+#endif
+} // namespace SHA256
@@ -0,0 +1,28 @@
+#ifndef _sha256_generate_hpp_INCLUDED
+#define _sha256_generate_hpp_INCLUDED
+
+#include "../cadical.hpp"
+#include "types.hpp"
+#include <vector>
+
+using namespace std;
+
+namespace SHA256 {
+// Generate the encoding described by '<steps>,<encoding>[,<path>]' in the
+// solver and fill the state with its variables, skipping DIMACS. The
+// optional file holds the starting characteristic as lines of a step
+// followed by the characteristics of A, E and optionally W (most
+// significant bit first, as printed by 'State::print'). Without it, a
+// collision with no difference in the first and last four states and
+// some difference in the message is asked for. Returns an error message
+// or 0 on success.
+const char *generate_encoding (CaDiCaL::Solver *solver, const char *spec);
+
+#if IS_1BIT || IS_4BIT
+// The clauses excluding the pairs of values of a bit of the word which the
+// characteristic symbol doesn't allow (none for an invalid symbol)
+vector<vector<int>> characteristic_clauses (Word &word, int bit, char c);
+#endif
+} // namespace SHA256
+
+#endif
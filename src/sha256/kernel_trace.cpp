@@ -0,0 +1,41 @@
+#include "kernel_trace.hpp"
+#include <cinttypes>
+
+namespace SHA256 {
+KernelTrace *kernel_trace = NULL;
+
+void KernelTrace::propagate (char function, const string &inputs,
+                             const string &outputs) {
+  if (full ())
+    return;
+  fprintf (file, "p %c %s %s\n", function, inputs.c_str (),
+           outputs.c_str ());
+}
+
+void KernelTrace::two_bit (
+    char function, const string &inputs, const string &outputs,
+    const string &mask,
+    const pair<vector<uint32_t>, vector<uint32_t>> &ids) {
+  if (full ())
+    return;
+  fprintf (file, "2 %c %s %s %s ", function, inputs.c_str (),
+           outputs.c_str (), mask.c_str ());
+  const char *separator = "";
+  for (auto block : {&ids.first, &ids.second})
+    for (auto &id : *block) {
+      fprintf (file, "%s%" PRIu32, separator, id);
+      separator = ",";
+    }
+  fputc ('\n', file);
+}
+
+void KernelTrace::wordwise (const vector<string> &words,
+                            int64_t constant) {
+  if (full ())
+    return;
+  fprintf (file, "w %" PRId64, constant);
+  for (auto &word : words)
+    fprintf (file, " %s", word.c_str ());
+  fputc ('\n', file);
+}
+} // namespace SHA256
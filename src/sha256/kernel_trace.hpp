@@ -0,0 +1,46 @@
+#ifndef _sha256_kernel_trace_hpp_INCLUDED
+#define _sha256_kernel_trace_hpp_INCLUDED
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Calls recorded by default (about 100 MB of differentials)
+#define KERNEL_TRACE_MAX_CALLS 2000000
+
+using namespace std;
+
+namespace SHA256 {
+// Records the differentials passed to the propagation kernels while
+// solving, one call per line, for the benchmarks to replay them:
+//
+//   p <function> <inputs> <outputs>
+//   2 <function> <inputs> <outputs> <mask> <IDs>
+//   w <constant> <words>
+//
+// The functions are given by 'function_tag' and the IDs are those of the
+// first block followed by the second block ones, separated by commas.
+class KernelTrace {
+  FILE *file;
+  uint64_t calls = 0, max_calls;
+
+  bool full () { return ++calls > max_calls; }
+
+public:
+  KernelTrace (FILE *file, uint64_t max_calls = KERNEL_TRACE_MAX_CALLS)
+      : file (file), max_calls (max_calls) {}
+
+  void propagate (char function, const string &inputs,
+                  const string &outputs);
+  void two_bit (char function, const string &inputs, const string &outputs,
+                const string &mask,
+                const pair<vector<uint32_t>, vector<uint32_t>> &ids);
+  void wordwise (const vector<string> &words, int64_t constant);
+};
+
+// Null unless the kernel calls are recorded
+extern KernelTrace *kernel_trace;
+} // namespace SHA256
+
+#endif
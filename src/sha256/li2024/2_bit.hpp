@@ -4,6 +4,7 @@
 #include "../2_bit.hpp"
 #include "../lru_cache.hpp"
 #include "../state.hpp"
+#include "../strength.hpp"
 #include "../util.hpp"
 #include <string>
 
@@ -61,10 +62,23 @@ inline void derive_2bit_equations_li2024 (
       assert (input_size + output_size == int (ids.first.size ()));
       assert (input_size + output_size == int (ids.second.size ()));
 
+#if ADAPTIVE_PROP
+      int placeholders = 0;
+      for (auto &c : all_chars)
+        if (c == 'x' || c == '-')
+          placeholders++;
+      if (!two_bit_strength.allows (op_id, step_i, placeholders))
+        continue;
+#endif
+
       // Replace the equations for this particular spot
       auto &mask = masks_by_op_id[op_id];
       auto new_equations = otf_2bit_eqs (function, input_chars,
                                          output_chars, ids, mask, &stats);
+#if ADAPTIVE_PROP
+      two_bit_strength.record (op_id, step_i, strength_cost (input_chars),
+                               new_equations.size ());
+#endif
       // Add the antecedent for the equations
       for (auto &equation : new_equations) {
         // Process inputs
@@ -147,6 +161,9 @@ inline void derive_2bit_equations_li2024 (
               blocking_clause.insert (lit);
           two_bit.blocking_clauses.push_back (
               {blocking_clause, trail_level});
+#if ADAPTIVE_PROP
+          two_bit_strength.record_reason (op_id, step_i);
+#endif
         }
       }
     }
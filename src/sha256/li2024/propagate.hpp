@@ -4,6 +4,7 @@
 #include "../lru_cache.hpp"
 #include "../propagate.hpp"
 #include "../state.hpp"
+#include "../strength.hpp"
 #include "../util.hpp"
 #include <iterator>
 #include <list>
@@ -68,6 +69,11 @@ inline void custom_li2024_propagate (State &state,
           q_count == input_size + output_size)
         continue;
 
+#if ADAPTIVE_PROP
+      if (!prop_strength.allows (op_id, step_i, q_count))
+        continue;
+#endif
+
       assert (input_chars.size () == input_size);
       assert (output_chars.size () == output_size);
       // Propagate
@@ -75,6 +81,17 @@ inline void custom_li2024_propagate (State &state,
           otf_propagate (function, input_chars, output_chars, &stats);
       string &prop_input = output.first;
       string &prop_output = output.second;
+#if ADAPTIVE_PROP
+      {
+        int props = 0;
+        for (int i = 0; i < input_size; i++)
+          props += prop_input[i] != input_chars[i];
+        for (int i = 0; i < output_size; i++)
+          props += prop_output[i] != output_chars[i];
+        prop_strength.record (op_id, step_i, strength_cost (input_chars),
+                              props);
+      }
+#endif
       if (output_chars == prop_output && input_chars == prop_input) {
         continue;
       }
@@ -87,6 +104,8 @@ inline void custom_li2024_propagate (State &state,
 
       // Construct the antecedent with inputs
       Reason reason;
+      reason.op_id = op_id;
+      reason.step_i = step_i;
       reason.differentials.first += input_chars + "->" + output_chars;
       reason.differentials.second += prop_input + "->" + prop_output;
 
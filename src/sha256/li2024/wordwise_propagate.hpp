@@ -52,8 +52,6 @@ string k[64] = {
 
 // Wordwise propagate (through branching) words by taking information inside
 // the addition equation
-cache::lru_cache<string, pair<string, string>>
-    wordwise_propagate_cache (100e3);
 inline void wordwise_propagate_branch_li2024 (State &state,
                                               list<int> &decision_lits,
                                               Stats &stats) {
@@ -56,6 +56,19 @@ public:
 
   size_t size () const { return _cache_items_map.size (); }
 
+  void clear () {
+    _cache_items_map.clear ();
+    _cache_items_list.clear ();
+  }
+
+  // Visit the items from the least to the most recently used one, so that
+  // putting them in that order restores the recency
+  template <typename visitor_t> void for_each (visitor_t visit) const {
+    for (auto it = _cache_items_list.rbegin ();
+         it != _cache_items_list.rend (); it++)
+      visit (it->first, it->second);
+  }
+
 private:
   std::list<key_value_pair_t> _cache_items_list;
   std::unordered_map<key_t, list_iterator_t> _cache_items_map;
@@ -1,7 +1,9 @@
 #ifndef _sha256_propagate_hpp_INCLUDED
 #define _sha256_propagate_hpp_INCLUDED
 
+#include "kernel_trace.hpp"
 #include "lru_cache.hpp"
+#include "shared_cache.hpp"
 #include "types.hpp"
 #include "util.hpp"
 #include <cstdint>
@@ -88,32 +90,11 @@ inline char get_symbol (const set<char> &symbols) {
   return '#';
 }
 
-extern cache::lru_cache<string, pair<string, string>> otf_prop_cache;
+// Propagate the differential by trying all the values it allows, which is
+// slow but serves as the reference for the cached propagation
 inline pair<string, string>
-otf_propagate (vector<int> (*func) (vector<int> inputs), string inputs,
-               string outputs, Stats *stats = NULL) {
-#if IS_LI2024
-  assert (func == add_ ? outputs.size () == 2 : true);
-#else
-  assert (func == add_ ? outputs.size () == 3 : true);
-#endif
-
-  if (stats != NULL)
-    stats->prop_total_calls++;
-
-  // Look in the cache
-  string cache_key;
-  {
-    stringstream ss;
-    ss << (int64_t) func << " " << inputs << " " << outputs;
-    cache_key = ss.str ();
-    if (otf_prop_cache.exists (cache_key)) {
-      if (stats != NULL)
-        stats->prop_cached_calls++;
-      return otf_prop_cache.get (cache_key);
-    }
-  }
-
+enumerate_propagate (vector<int> (*func) (vector<int> inputs),
+                     const string &inputs, const string &outputs) {
   int inputs_size = inputs.size (), outputs_size = outputs.size ();
   auto conforms_to = [] (char c1, char c2) {
     vector<char> c1_chars = get_symbols (c1), c2_chars = get_symbols (c2);
@@ -206,11 +187,51 @@ otf_propagate (vector<int> (*func) (vector<int> inputs), string inputs,
   for (auto &p : input_possibilities)
     propagated_input += get_symbol (p);
 
-  // Cache the result
-  otf_prop_cache.put (cache_key, {propagated_input, propagated_output});
   return {propagated_input, propagated_output};
 }
 
+extern cache::lru_cache<string, pair<string, string>> otf_prop_cache;
+inline pair<string, string>
+otf_propagate (vector<int> (*func) (vector<int> inputs), string inputs,
+               string outputs, Stats *stats = NULL) {
+#if IS_LI2024
+  assert (func == add_ ? outputs.size () == 2 : true);
+#else
+  assert (func == add_ ? outputs.size () == 3 : true);
+#endif
+
+  if (stats != NULL)
+    stats->prop_total_calls++;
+  if (kernel_trace != NULL)
+    kernel_trace->propagate (function_tag (func), inputs, outputs);
+
+  // Look in the cache
+  string cache_key;
+  {
+    stringstream ss;
+    ss << function_tag (func) << " " << inputs << " " << outputs;
+    cache_key = ss.str ();
+    pair<string, string> shared;
+    if (shared_cache != NULL && shared_cache->get (cache_key, shared)) {
+      if (stats != NULL)
+        stats->prop_cached_calls++;
+      return shared;
+    }
+    if (otf_prop_cache.exists (cache_key)) {
+      if (stats != NULL)
+        stats->prop_cached_calls++;
+      return otf_prop_cache.get (cache_key);
+    }
+  }
+
+  auto result = enumerate_propagate (func, inputs, outputs);
+
+  // Cache the result (privately only if it can't be shared)
+  if (shared_cache == NULL || !shared_cache->put (cache_key, result))
+    otf_prop_cache.put (cache_key, result);
+  return result;
+}
+
 void load_prop_rules ();
 } // namespace SHA256
 
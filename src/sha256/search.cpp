@@ -0,0 +1,87 @@
+#include "search.hpp"
+#include "generate.hpp"
+#include "sha256.hpp"
+#include "util.hpp"
+
+namespace SHA256 {
+CharacteristicSearch::CharacteristicSearch (CaDiCaL::Solver *solver)
+    : solver (solver), propagator (new Propagator (solver)) {}
+
+CharacteristicSearch::~CharacteristicSearch () { delete propagator; }
+
+const char *CharacteristicSearch::generate (const char *spec) {
+  return generate_encoding (solver, spec);
+}
+
+int CharacteristicSearch::condition (int step, char word, int bit,
+                                     char symbol) {
+#if IS_1BIT || IS_4BIT
+  auto key = make_tuple (step, word, bit, symbol);
+  auto it = lits.find (key);
+  if (it != lits.end ())
+    return it->second;
+
+  auto &state = Propagator::state;
+  if (!gc_pairs (symbol) || bit < 0 || bit >= 32 || step < -4 ||
+      step >= state.order)
+    return 0;
+  Word *w;
+  if (word == 'A')
+    w = &state.steps[ABS_STEP (step)].a;
+  else if (word == 'E')
+    w = &state.steps[ABS_STEP (step)].e;
+  else if (word == 'W' && step >= 0)
+    w = &state.steps[step].w;
+  else
+    return 0;
+
+  // The clauses of the symbol as generated, but under the literal
+  int lit = solver->vars () + 1;
+  solver->reserve (lit);
+  for (auto &clause : characteristic_clauses (*w, bit, symbol)) {
+    solver->add (-lit);
+    for (auto &other : clause)
+      solver->add (other);
+    solver->add (0);
+  }
+  // Keep it from being eliminated between the calls
+  solver->freeze (lit);
+
+  lits[key] = lit;
+  conditions[lit] = {step, word, bit, symbol};
+  return lit;
+#else
+  (void) step, (void) word, (void) bit, (void) symbol;
+  return 0;
+#endif
+}
+
+int CharacteristicSearch::add_condition (int step, char word, int bit,
+                                         char symbol) {
+  int lit = condition (step, word, bit, symbol);
+  if (lit)
+    added.insert (lit);
+  return lit;
+}
+
+void CharacteristicSearch::remove_condition (int lit) { added.erase (lit); }
+
+int CharacteristicSearch::solve () {
+  for (auto &lit : added)
+    solver->assume (lit);
+  return result = solver->solve ();
+}
+
+bool CharacteristicSearch::failed (int lit) {
+  return result == 20 && added.count (lit) && solver->failed (lit);
+}
+
+vector<CharacteristicSearch::Condition>
+CharacteristicSearch::failed_conditions () {
+  vector<Condition> failed_conditions;
+  for (auto &lit : added)
+    if (failed (lit))
+      failed_conditions.push_back (conditions[lit]);
+  return failed_conditions;
+}
+} // namespace SHA256
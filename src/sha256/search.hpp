@@ -0,0 +1,80 @@
+#ifndef _sha256_search_hpp_INCLUDED
+#define _sha256_search_hpp_INCLUDED
+
+#include "../cadical.hpp"
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+namespace SHA256 {
+class Propagator;
+
+// Incremental search for a characteristic in one solver, which keeps the
+// learned clauses, the propagator and its caches from one call of 'solve'
+// to the next. Each condition on a bit of an A, E or W word (the
+// characteristic symbol it has to take, as in the characteristic files)
+// is encoded once, guarded by an activation literal, and enforced by
+// assuming that literal while the condition is added. Thus conditions can
+// be added and removed between the calls, and the failed ones are those
+// of the failed assumptions. As the state of the propagator is static,
+// there can only be one search in a process.
+//
+//   CharacteristicSearch search (solver);
+//   search.generate ("16,1bit");
+//   int lit = search.add_condition (5, 'W', 0, 'x');
+//   if (search.solve () == 20 && search.failed (lit))
+//     search.remove_condition (lit);
+//
+// The activation literals can also be assumed directly (for instance
+// through IPASIR, see 'ccadical_sha256_condition').
+class CharacteristicSearch {
+public:
+  struct Condition {
+    int step;
+    char word; // 'A', 'E' or 'W'
+    int bit;   // The least significant bit is 0
+    char symbol;
+  };
+
+  CharacteristicSearch (CaDiCaL::Solver *solver);
+  ~CharacteristicSearch ();
+
+  // Generate the encoding as 'generate_encoding' with the specification
+  // '<steps>,<encoding>[,<characteristic>]'. Returns an error message or
+  // 0 on success.
+  const char *generate (const char *spec);
+
+  // The activation literal of a condition (encoded on first use), or 0 if
+  // the word, the bit or the symbol is invalid
+  int condition (int step, char word, int bit, char symbol);
+
+  // Enforce the condition in the following calls of 'solve' until it's
+  // removed and return its activation literal (or 0 if it's invalid)
+  int add_condition (int step, char word, int bit, char symbol);
+  void remove_condition (int lit);
+
+  // Solve under the added conditions (10 = SAT, 20 = UNSAT, 0 = unknown)
+  int solve ();
+
+  // Whether an added condition was needed to show UNSAT in the last call
+  bool failed (int lit);
+  vector<Condition> failed_conditions ();
+
+  const Condition &describe (int lit) { return conditions.at (lit); }
+
+private:
+  CaDiCaL::Solver *solver;
+  Propagator *propagator;
+  // The activation literal of each encoded condition and the conditions
+  map<tuple<int, char, int, char>, int> lits;
+  map<int, Condition> conditions;
+  set<int> added;
+  int result = 0;
+};
+} // namespace SHA256
+
+#endif
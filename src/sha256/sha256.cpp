@@ -1,19 +1,26 @@
 #include "sha256.hpp"
 #include "1_bit/2_bit.hpp"
 #include "1_bit/encoding.hpp"
+#include "1_bit/mendel_branch.hpp"
 #include "1_bit/propagate.hpp"
 #include "1_bit/wordwise_propagate.hpp"
 #include "4_bit/2_bit.hpp"
 #include "4_bit/encoding.hpp"
+#include "4_bit/mendel_branch.hpp"
 #include "4_bit/propagate.hpp"
+#include "4_bit/wordwise_propagate.hpp"
+#include "blocking.hpp"
+#include "cache_file.hpp"
 #include "li2024/2_bit.hpp"
 #include "li2024/encoding.hpp"
 #include "li2024/propagate.hpp"
 #include "li2024/wordwise_propagate.hpp"
 #include "state.hpp"
+#include "strength.hpp"
 #include "tests.hpp"
 #include "types.hpp"
 #include "util.hpp"
+#include "verify.hpp"
 #include <cassert>
 #include <climits>
 #include <cstdio>
@@ -30,6 +37,7 @@ uint64_t prop_counter = 0;
 uint64_t block_counter = 0;
 uint64_t mendel_branch_counter = 0;
 Stats Propagator::stats = Stats{};
+CaDiCaL::Random SHA256::branch_random (0);
 
 Propagator::Propagator (CaDiCaL::Solver *solver) {
 #ifndef NDEBUG
@@ -45,10 +53,7 @@ Propagator::Propagator (CaDiCaL::Solver *solver) {
   // load_prop_rules ();
   // load_two_bit_rules ();
 
-#if IS_4BIT
-  printf ("4-bit encoding isn't supported anymore.\n");
-  exit (0);
-#elif !IS_1BIT && !IS_LI2024
+#if !IS_1BIT && !IS_4BIT && !IS_LI2024
   printf ("None of the encoding modes are enabled.\n");
   exit (0);
 #endif
@@ -70,6 +75,14 @@ Propagator::Propagator (CaDiCaL::Solver *solver) {
           MENDEL_BRANCHING_STAGES);
 #endif
 
+#if ADAPTIVE_PROP
+  printf ("Adaptive propagation strength turned on.\n");
+#endif
+
+#if XOR_ENGINE
+  printf ("Gauss-Jordan elimination of 2-bit relations turned on.\n");
+#endif
+
 #if SET_PHASE
   printf ("Phase set to false for state and message variables.\n");
 #endif
@@ -92,6 +105,12 @@ void Propagator::parse_comment_line (string line,
 
 void Propagator::notify_assignment (int lit, bool is_fixed) {
   // Timer timer (&stats.total_cb_time);
+#if IS_4BIT
+  // The values of the blocks are only observed for verifying the models
+  auto name = state.vars_info[abs (lit)].identity.name;
+  if (name >= A && name < DA)
+    return;
+#endif
   if (is_fixed) {
     state.current_trail.front ().push_back (lit);
     state.vars_info[abs (lit)].is_fixed = true;
@@ -101,6 +120,11 @@ void Propagator::notify_assignment (int lit, bool is_fixed) {
 
   // Assign the variable in the partial assignment
   state.partial_assignment.set (lit);
+#if XOR_ENGINE
+  two_bit.xor_engine.touch (abs (lit));
+#endif
+  if (state.vars_info[abs (lit)].word != NULL)
+    epoch++;
   // printf ("Assign %d (%c%c) in level %ld\n", lit,
   //         solver->is_decision (lit) ? 'd' : 'p', is_fixed ? 'f' : 'l',
   //         state.current_trail.size () - 1);
@@ -150,11 +174,16 @@ void Propagator::notify_assignment (int lit, bool is_fixed) {
 
 void Propagator::notify_backtrack (size_t new_level) {
   // Timer timer (&stats.total_cb_time);
+  epoch++;
   while (state.current_trail.size () > new_level + 1) {
     // Unassign the variables that are removed from the trail
     auto &level = state.current_trail.back ();
     for (auto &lit : level) {
       state.partial_assignment.unset (lit);
+      implications.erase (abs (lit));
+#if XOR_ENGINE
+      two_bit.xor_engine.touch (abs (lit));
+#endif
 // printf ("Unassign %d (%ld)\n", lit, state.current_trail.size () -
 // 1);
 
@@ -168,7 +197,11 @@ void Propagator::notify_backtrack (size_t new_level) {
             state.vars_info[var].identity.name == A ||
             state.vars_info[var].identity.name == E ||
             state.vars_info[var].identity.name == W)
+#if IS_4BIT
+          solver->phase (phase_4bit_lit (state.vars_info[var], var));
+#else
           solver->phase (-var);
+#endif
       }
 #endif
     }
@@ -180,6 +213,9 @@ void Propagator::notify_backtrack (size_t new_level) {
 
     state.current_trail.pop_back ();
     two_bit.equations_trail.pop_back ();
+#if XOR_ENGINE
+    two_bit.xor_engine.pop_level ();
+#endif
     state.prop_markings_trail.pop_back ();
     state.two_bit_markings_trail.pop_back ();
   }
@@ -205,6 +241,9 @@ void Propagator::notify_backtrack (size_t new_level) {
 void Propagator::notify_new_decision_level () {
   state.current_trail.push_back ({});
   two_bit.equations_trail.push_back ({});
+#if XOR_ENGINE
+  two_bit.xor_engine.new_level ();
+#endif
   state.prop_markings_trail.push_back ({});
   state.two_bit_markings_trail.push_back ({});
 }
@@ -212,6 +251,12 @@ void Propagator::notify_new_decision_level () {
 int Propagator::cb_decide () {
   Timer timer (&stats.total_cb_time);
 
+  // The solver may have assigned the queued decisions in the meantime
+  while (!decision_lits.empty () &&
+         state.partial_assignment.get (abs (decision_lits.front ())) !=
+             LIT_UNDEF)
+    decision_lits.pop_front ();
+
 #if MENDEL_BRANCHING
   if (decision_lits.empty ()) {
     state.soft_refresh ();
@@ -230,7 +275,7 @@ int Propagator::cb_decide () {
 
   if (decision_lits.empty ())
     return 0;
-  int &lit = decision_lits.front ();
+  int lit = decision_lits.front ();
   assert (state.partial_assignment.get (abs (lit)) == LIT_UNDEF);
   decision_lits.pop_front ();
   stats.decisions_count++;
@@ -245,7 +290,7 @@ inline bool Propagator::custom_block () {
   int trail_level = int (two_bit.equations_trail.size () - 1);
 #if IS_4BIT
   derive_2bit_equations_4bit (state, two_bit.equations_trail.back (),
-                              stats);
+                              two_bit, trail_level, stats);
 #elif IS_1BIT
   derive_2bit_equations_1bit (state, two_bit.equations_trail.back (),
                               two_bit, trail_level, stats);
@@ -254,32 +299,34 @@ inline bool Propagator::custom_block () {
                                 two_bit, trail_level, stats);
 #endif
 
-  int shortest_l_graph_based = INT_MAX;
-  unordered_set<int> shortest_c_graph_based;
+  // Minimize the candidates and add the shortest ones which aren't
+  // duplicates or subsumed by another one
+  vector<vector<int>> candidates;
+  auto is_fixed = [] (int var) { return state.vars_info[var].is_fixed; };
   for (auto &entry : two_bit.blocking_clauses) {
     if (entry.second < trail_level)
       continue;
 
-    if (entry.first.size () >= shortest_l_graph_based)
-      continue;
-
-    shortest_l_graph_based = entry.first.size ();
-    shortest_c_graph_based = entry.first;
+    vector<int> clause (entry.first.begin (), entry.first.end ());
+    stats.blocking_minimized_lits_count +=
+        minimize_blocking_clause (clause, implications, is_fixed);
+    candidates.push_back (clause);
   }
   two_bit.blocking_clauses.clear ();
-  if (!shortest_c_graph_based.empty ()) {
-    vector<int> clause;
-    for (auto &lit : shortest_c_graph_based)
-      clause.push_back (lit);
+
+  auto clauses =
+      select_blocking_clauses (candidates, blocking_clauses,
+                               MAX_BLOCKING_CLAUSES,
+                               stats.blocking_duplicates_count);
+  for (auto &clause : clauses) {
     external_clauses.push_back (clause);
 #if PRINT_BLOCKING_CLAUSE
     printf ("Blocking clause: ");
     print (clause);
 #endif
-    return true;
   }
 
-  return false;
+  return !clauses.empty ();
 }
 
 int Propagator::cb_propagate () {
@@ -300,10 +347,18 @@ int Propagator::cb_propagate () {
   }
 #endif
 
+#if XOR_ENGINE && !IS_4BIT
+  // The 4-bit encoding doesn't observe the values of the blocks
   if (propagation_lits.empty ())
+    xor_propagate ();
+#endif
+
+  if (propagation_lits.empty ()) {
+    propagated_epoch = epoch;
     return 0;
+  }
 
-  int &lit = propagation_lits.front ();
+  int lit = propagation_lits.front ();
   assert (lit != 0);
 
   // If reason doesn't exist, skip propagation
@@ -321,9 +376,36 @@ int Propagator::cb_propagate () {
   if (state.partial_assignment.get (abs (lit)) != LIT_UNDEF)
     return 0;
 
+  implications[abs (lit)] = reason_it->second.antecedent;
   return lit;
 }
 
+// Propagate the units of the XOR matrix, with the conflicts turned into
+// blocking clauses
+void Propagator::xor_propagate () {
+  vector<pair<int, vector<int>>> units;
+  vector<int> conflict;
+  auto value = [] (uint32_t id) {
+    auto value = state.partial_assignment.get (id);
+    return value == LIT_TRUE ? 1 : value == LIT_FALSE ? -1 : 0;
+  };
+  if (!two_bit.xor_engine.propagate (value, units, conflict)) {
+    stats.xor_conflicts_count++;
+    external_clauses.push_back (conflict);
+    return;
+  }
+
+  for (auto &unit : units) {
+    if (reasons.find (unit.first) != reasons.end ())
+      continue;
+    Reason reason;
+    reason.antecedent = unit.second;
+    reasons[unit.first] = reason;
+    propagation_lits.push_back (unit.first);
+    stats.xor_units_count++;
+  }
+}
+
 int Propagator::cb_add_reason_clause_lit (int propagated_lit) {
   // Timer time (&stats.total_cb_time);
 
@@ -338,6 +420,11 @@ int Propagator::cb_add_reason_clause_lit (int propagated_lit) {
     Reason reason = reasons_it->second;
     reasons.erase (reasons_it); // Consume the reason
     stats.reasons_count++;
+#if ADAPTIVE_PROP
+    if (reason.op_id >= 0)
+      prop_strength.record_reason ((OperationId) reason.op_id,
+                                   reason.step_i);
+#endif
     assert (reason.antecedent.size () > 0);
 
     // Populate the reason clause
@@ -367,6 +454,32 @@ int Propagator::cb_add_reason_clause_lit (int propagated_lit) {
   return lit;
 }
 
+bool Propagator::cb_check_found_model (const std::vector<int> &model) {
+  printf ("Final state:\n");
+  state.soft_refresh ();
+  state.print ();
+
+#if IS_1BIT || IS_4BIT
+  // Evaluate the compression function on both blocks
+  auto verification = verify_model (state, model);
+  if (verification.is_undetermined) {
+    printf ("Model not verified since it allows several values of the "
+            "blocks\n");
+    return true;
+  }
+  if (verification.error) {
+    printf ("Model rejected: %s\n", verification.error);
+    external_clauses.push_back (verification.blocking_clause);
+    return false;
+  }
+  printf ("Model verified%s\n",
+          verification.is_collision ? " (collision)" : "");
+#else
+  (void) model;
+#endif
+  return true;
+}
+
 bool Propagator::cb_has_external_clause () {
   Timer timer (&stats.total_cb_time);
 
@@ -390,10 +503,33 @@ bool Propagator::cb_has_external_clause () {
 
 #if CUSTOM_BLOCKING
   // Check for 2-bit inconsistencies here
-  return custom_block ();
-#else
-  return false;
+  if (custom_block ())
+    return true;
 #endif
+
+  blocked_epoch = epoch;
+  return false;
+}
+
+void Propagator::notify_checkpoint () {
+  if (!cache_file)
+    return;
+  const char *err = cache_file->save ();
+  if (err)
+    printf ("c WARNING: %s (saving the rule caches)\n", err);
+}
+
+bool Propagator::cb_is_dirty () {
+  if (!propagation_lits.empty () || !external_clauses.empty ())
+    return true;
+
+  // Only auxiliary variables were assigned since the last round
+  if (propagated_epoch == epoch && blocked_epoch == epoch) {
+    stats.clean_rounds_count++;
+    return false;
+  }
+
+  return true;
 }
 
 int Propagator::cb_add_external_clause_lit () {
@@ -401,22 +537,20 @@ int Propagator::cb_add_external_clause_lit () {
   if (external_clauses.empty ())
     return 0;
 
+  // Terminate the clause and remove it once all literals are added
   auto &clause = external_clauses.back ();
-  assert (!clause.empty ());
-  int lit = clause.back ();
-  auto value = state.partial_assignment.get (abs (lit));
-
-  // Pop clause and remove if empty
-  clause.pop_back ();
   if (clause.empty ()) {
     external_clauses.pop_back ();
     stats.clauses_count++;
+    return 0;
   }
 
-  // Sanity check for blocking clauses
-  assert (lit < 0   ? value == LIT_TRUE
-          : lit > 0 ? value == LIT_FALSE
-                    : value != LIT_UNDEF);
+  int lit = clause.back ();
+  clause.pop_back ();
+
+  // Blocking clauses are falsified when they are found, but the ones
+  // queued behind a conflicting clause are only added after backtracking
+  assert (lit != 0);
 
   return lit;
 }
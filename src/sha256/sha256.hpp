@@ -2,6 +2,7 @@
 #define _sha256_hpp_INCLUDED
 
 #include "../cadical.hpp"
+#include "../random.hpp"
 #include "state.hpp"
 #include "types.hpp"
 #include <algorithm>
@@ -13,42 +14,60 @@
 #include <sstream>
 #include <stack>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace std;
 
 namespace SHA256 {
-class Propagator : CaDiCaL::ExternalPropagator {
+class CacheFile;
+
+// Random decisions of the branching, seeded with the 'seed' option of the
+// solver such that runs and their callback traces can be reproduced
+extern CaDiCaL::Random branch_random;
+
+class Propagator : public CaDiCaL::ExternalPropagator {
   CaDiCaL::Solver *solver;
   list<int> propagation_lits;
   vector<int> reason_clause;
   map<int, Reason> reasons;
+  // Antecedents of the assigned literals we propagated (by variable)
+  unordered_map<int, vector<int>> implications;
   // Assume that the external clauses are blocking clauses
   vector<vector<int>> external_clauses;
   list<int> decision_lits;
   TwoBit two_bit;
+  // All the blocking clauses added so far. They are kept for the whole run
+  // as the solver adds external clauses as irredundant clauses, which are
+  // never deleted by 'reduce' (only if satisfied at the root level or
+  // subsumed), so a clause derived again would only be a duplicate.
+  set<vector<int>> blocking_clauses;
+  // Bumped on every observed change and recorded by 'cb_propagate' and
+  // 'cb_has_external_clause' once they have nothing left to do
+  uint64_t epoch = 1, propagated_epoch = 0, blocked_epoch = 0;
 
 public:
   static State state;
   static Stats stats;
+  // Rule caches saved along with each checkpoint of the solver
+  CacheFile *cache_file = 0;
 
   Propagator (CaDiCaL::Solver *solver);
   ~Propagator () { this->solver->disconnect_external_propagator (); }
   void notify_assignment (int lit, bool is_fixed);
   void notify_new_decision_level ();
   void notify_backtrack (size_t new_level);
-  bool cb_check_found_model (const std::vector<int> &model) {
-    printf ("Final state:\n");
-    state.soft_refresh ();
-    state.print ();
-    return true;
-  }
+  bool cb_check_found_model (const std::vector<int> &model);
   bool cb_has_external_clause ();
   int cb_add_external_clause_lit ();
   int cb_decide ();
   int cb_propagate ();
+  bool cb_is_dirty ();
   int cb_add_reason_clause_lit (int propagated_lit);
+  void notify_checkpoint ();
   static void parse_comment_line (string line, CaDiCaL::Solver *&solver);
   bool custom_block ();
+  void xor_propagate ();
 };
 } // namespace SHA256
 
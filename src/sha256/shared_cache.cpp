@@ -0,0 +1,176 @@
+#include "shared_cache.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace SHA256 {
+SharedCache *shared_cache = NULL;
+
+static_assert (sizeof (SharedCacheSlot) == 128,
+               "the slots span two cache lines");
+
+// FNV-1a (unlike 'std::hash' it's the same in all the builds)
+static uint64_t string_hash (const string &key) {
+  uint64_t hash = 14695981039346656037ull;
+  for (auto &c : key) {
+    hash ^= uint8_t (c);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+// Finalizer of SplitMix64
+static uint64_t integer_hash (uint64_t key) {
+  key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ull;
+  key = (key ^ (key >> 27)) * 0x94d049bb133111ebull;
+  return key ^ (key >> 31);
+}
+
+SharedCache *SharedCache::attach (string name, uint32_t slots,
+                                  const char *&err) {
+  if (name.empty () || name[0] != '/')
+    name = '/' + name;
+  size_t size =
+      sizeof (SharedCacheHeader) + slots * sizeof (SharedCacheSlot);
+  int fd = shm_open (name.c_str (), O_RDWR | O_CREAT, 0600);
+  if (fd < 0) {
+    err = "can not open shared memory";
+    return NULL;
+  }
+
+  // Reserve the memory now rather than failing on a page fault later
+  struct stat st;
+  if (fstat (fd, &st) || (st.st_size && size_t (st.st_size) != size) ||
+      posix_fallocate (fd, 0, size)) {
+    close (fd);
+    err = "can not allocate shared memory of the expected size";
+    return NULL;
+  }
+  void *memory =
+      mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close (fd);
+  if (memory == MAP_FAILED) {
+    err = "can not map shared memory";
+    return NULL;
+  }
+
+  // The memory is zeroed, so the first process only fills the header
+  auto header = (SharedCacheHeader *) memory;
+  uint32_t state = 0;
+  if (header->state.compare_exchange_strong (state, 1)) {
+    header->version = SHARED_CACHE_VERSION;
+    header->slots = slots;
+    header->data_size = SHARED_CACHE_DATA_SIZE;
+    header->state.store (2, memory_order_release);
+  } else {
+    for (int i = 0; i < 1000 && header->state.load () != 2; i++)
+      sched_yield ();
+  }
+  if (header->state.load (memory_order_acquire) != 2 ||
+      header->version != SHARED_CACHE_VERSION || header->slots != slots ||
+      header->data_size != SHARED_CACHE_DATA_SIZE) {
+    munmap (memory, size);
+    err = "shared memory is used by another version";
+    return NULL;
+  }
+
+  return new SharedCache (header, size);
+}
+
+SharedCache::~SharedCache () { munmap (header, size); }
+
+bool SharedCache::get (uint8_t kind, uint64_t hash, const string &key,
+                       string &value, int &split, int expected_size) {
+  auto &slot = slots[hash % header->slots];
+  uint64_t version = slot.version.load (memory_order_acquire);
+  if (!version || version & 1) {
+    misses++;
+    return false;
+  }
+
+  // Copy the rule and make sure it wasn't changed in the meantime
+  char data[SHARED_CACHE_DATA_SIZE];
+  uint64_t slot_hash = slot.hash;
+  uint8_t slot_kind = slot.kind, key_size = slot.key_size,
+          value_size = slot.value_size;
+  split = slot.split;
+  memcpy (data, slot.data, sizeof (data));
+  atomic_thread_fence (memory_order_acquire);
+  if (slot.version.load (memory_order_relaxed) != version ||
+      slot_hash != hash || slot_kind != kind || key_size != key.size () ||
+      key_size + value_size > SHARED_CACHE_DATA_SIZE ||
+      (expected_size >= 0 && value_size != expected_size) ||
+      split > value_size ||
+      memcmp (data, key.data (), key_size)) {
+    misses++;
+    return false;
+  }
+
+  value.assign (data + key_size, value_size);
+  hits++;
+  return true;
+}
+
+bool SharedCache::put (uint8_t kind, uint64_t hash, const string &key,
+                       const string &value, int split) {
+  if (key.size () + value.size () > SHARED_CACHE_DATA_SIZE)
+    return false;
+
+  auto &slot = slots[hash % header->slots];
+  uint64_t version = slot.version.load (memory_order_relaxed);
+  if (version & 1 ||
+      !slot.version.compare_exchange_strong (version, version + 1,
+                                             memory_order_acquire)) {
+    drops++;
+    return true;
+  }
+
+  slot.hash = hash;
+  slot.kind = kind;
+  slot.key_size = key.size ();
+  slot.value_size = value.size ();
+  slot.split = split;
+  memcpy (slot.data, key.data (), key.size ());
+  memcpy (slot.data + key.size (), value.data (), value.size ());
+  slot.version.store (version + 2, memory_order_release);
+  stores++;
+  return true;
+}
+
+bool SharedCache::get (const string &key, pair<string, string> &value) {
+  string bytes;
+  int split;
+  if (!get (shared_prop_rule, string_hash (key), key, bytes, split))
+    return false;
+  value.first = bytes.substr (0, split);
+  value.second = bytes.substr (split);
+  return true;
+}
+
+bool SharedCache::put (const string &key,
+                       const pair<string, string> &value) {
+  return put (shared_prop_rule, string_hash (key), key,
+              value.first + value.second, value.first.size ());
+}
+
+bool SharedCache::get (uint64_t key, void *value, size_t value_size) {
+  string key_bytes ((const char *) &key, sizeof (key)), bytes;
+  int split;
+  if (!get (shared_two_bit_rule, integer_hash (key), key_bytes, bytes,
+            split, value_size))
+    return false;
+  memcpy (value, bytes.data (), value_size);
+  return true;
+}
+
+bool SharedCache::put (uint64_t key, const void *value,
+                       size_t value_size) {
+  string key_bytes ((const char *) &key, sizeof (key));
+  return put (shared_two_bit_rule, integer_hash (key), key_bytes,
+              string ((const char *) value, value_size), 0);
+}
+} // namespace SHA256
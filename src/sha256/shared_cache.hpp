@@ -0,0 +1,84 @@
+#ifndef _sha256_shared_cache_hpp_INCLUDED
+#define _sha256_shared_cache_hpp_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Bump whenever the layout or the cached values change their meaning
+#define SHARED_CACHE_VERSION 1
+// Default number of slots of the shared cache (128 bytes each)
+#define SHARED_CACHE_SLOTS (1 << 20)
+// Bytes of a slot for the key and the value of a rule
+#define SHARED_CACHE_DATA_SIZE 104
+
+using namespace std;
+
+namespace SHA256 {
+static_assert (ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+              "the shared cache needs address-free atomics");
+
+enum SharedRuleKind : uint8_t { shared_prop_rule = 1, shared_two_bit_rule };
+
+struct SharedCacheHeader {
+  // 0 before, 1 during and 2 after the initialization
+  atomic<uint32_t> state;
+  uint32_t version, slots, data_size;
+};
+
+struct SharedCacheSlot {
+  // Odd while the slot is written, 0 if it was never written
+  atomic<uint64_t> version;
+  uint64_t hash;
+  uint8_t kind, key_size, value_size, split;
+  uint32_t reserved;
+  char data[SHARED_CACHE_DATA_SIZE];
+};
+
+// A table of rules in POSIX shared memory which the solver processes on a
+// node attach to. Each rule has one slot picked by its hash, replacing the
+// rule that was there. Writers never wait: a rule is dropped if its slot
+// is being written by another process, and a reader misses if the slot
+// changes while it is read. Rules which don't fit in a slot are left to
+// the private caches.
+class SharedCache {
+  SharedCacheHeader *header;
+  SharedCacheSlot *slots;
+  size_t size;
+
+  SharedCache (SharedCacheHeader *header, size_t size)
+      : header (header),
+        slots ((SharedCacheSlot *) (header + 1)), size (size) {}
+
+  // Values of another size than 'expected_size' (if not negative) miss
+  bool get (uint8_t kind, uint64_t hash, const string &key, string &value,
+            int &split, int expected_size = -1);
+  bool put (uint8_t kind, uint64_t hash, const string &key,
+            const string &value, int split);
+
+public:
+  // Lookups and insertions of this process
+  uint64_t hits = 0, misses = 0, stores = 0, drops = 0;
+
+  ~SharedCache ();
+
+  // Attach to the table with the name (created if needed). Returns 0 and
+  // sets 'err' on failure.
+  static SharedCache *attach (string name, uint32_t slots,
+                              const char *&err);
+
+  // Propagation rules
+  bool get (const string &key, pair<string, string> &value);
+  bool put (const string &key, const pair<string, string> &value);
+
+  // Rules with a fixed size (such as the 2-bit relations)
+  bool get (uint64_t key, void *value, size_t value_size);
+  bool put (uint64_t key, const void *value, size_t value_size);
+};
+
+// Null unless a shared cache was attached
+extern SharedCache *shared_cache;
+} // namespace SHA256
+
+#endif
@@ -0,0 +1,104 @@
+#include "strength.hpp"
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstdio>
+
+namespace SHA256 {
+#if ADAPTIVE_PROP
+// Unknowns are '?' characteristics for propagation and placeholders ('x'
+// and '-') for the 2-bit derivation
+Strength prop_strength (1, 3, INT_MAX);
+Strength two_bit_strength (2, 4, INT_MAX);
+#endif
+
+Strength::Strength (int low, int medium, int full) {
+  for (int i = 0; i < NUM_OPS; i++)
+    for (int j = 0; j < STRENGTH_RANGES; j++) {
+      levels[i][j] = strength_full;
+      counters[i][j] = {0, 0, 0, 0};
+      skipped[i][j] = 0;
+    }
+  max_unknowns[strength_off] = 0;
+  max_unknowns[strength_low] = low;
+  max_unknowns[strength_medium] = medium;
+  max_unknowns[strength_full] = full;
+  inc.calls = 1e4;
+  lim.calls = inc.calls;
+}
+
+bool Strength::allows (OperationId op_id, int step_i, int unknowns) {
+  assert (step_i >= 0 && step_i < 64);
+  int range = step_i / STRENGTH_STEP_RANGE;
+  auto level = levels[op_id][range];
+
+  // Keep measuring operations which are turned off
+  if (level == strength_off) {
+    if (++skipped[op_id][range] % STRENGTH_OFF_SAMPLING)
+      return false;
+    level = strength_low;
+  }
+
+  return unknowns <= max_unknowns[level];
+}
+
+void Strength::record (OperationId op_id, int step_i, uint64_t cost,
+                       int props) {
+  auto &counter = counters[op_id][step_i / STRENGTH_STEP_RANGE];
+  counter.calls++;
+  counter.props += props;
+  counter.cost += cost;
+
+  if (++calls >= lim.calls)
+    update ();
+}
+
+// Compare the usefulness (propagations per enumerated value pair) of each
+// operation family and step range against the overall usefulness. Much
+// more useful ones get a higher strength and much less useful ones a lower
+// strength.
+void Strength::update () {
+  double total_useful = 0, total_cost = 0;
+  for (int i = 0; i < NUM_OPS; i++)
+    for (int j = 0; j < STRENGTH_RANGES; j++) {
+      auto &counter = counters[i][j];
+      total_useful +=
+          counter.props + STRENGTH_REASON_WEIGHT * counter.reasons;
+      total_cost += counter.cost;
+    }
+
+  double mean = total_useful / (1 + total_cost);
+  for (int i = 0; i < NUM_OPS; i++)
+    for (int j = 0; j < STRENGTH_RANGES; j++) {
+      auto &counter = counters[i][j];
+      if (!counter.calls)
+        continue;
+
+      double useful =
+          counter.props + STRENGTH_REASON_WEIGHT * counter.reasons;
+      double usefulness = useful / (1 + counter.cost);
+      auto &level = levels[i][j];
+      if (usefulness > 2 * mean && level < strength_full)
+        level++;
+      else if ((usefulness < mean / 2 || useful == 0) &&
+               level > strength_off)
+        level--;
+
+      counter = {0, 0, 0, 0};
+    }
+
+  updates++;
+  inc.calls = min (2 * inc.calls, (int64_t) 1e6);
+  lim.calls = calls + inc.calls;
+}
+
+void Strength::print (const char *name) {
+  printf ("c %s strength levels (%ld updates):\n", name, updates);
+  for (int i = 0; i < NUM_OPS; i++) {
+    printf ("c   op %d:", i);
+    for (int j = 0; j < STRENGTH_RANGES; j++)
+      printf (" %d", levels[i][j]);
+    printf ("\n");
+  }
+}
+} // namespace SHA256
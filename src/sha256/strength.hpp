@@ -0,0 +1,103 @@
+#ifndef _sha256_strength_hpp_INCLUDED
+#define _sha256_strength_hpp_INCLUDED
+
+#include "types.hpp"
+#include "util.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+// Steps sharing one strength level per operation family
+#define STRENGTH_STEP_RANGE 8
+#define STRENGTH_RANGES (64 / STRENGTH_STEP_RANGE)
+
+// Operations turned off are still tried once in this many calls
+#define STRENGTH_OFF_SAMPLING 32
+// A reason asked for by the solver counts as this many propagations
+#define STRENGTH_REASON_WEIGHT 8
+
+using namespace std;
+
+namespace SHA256 {
+// Propagation strength levels from the cheapest to the complete one. The
+// levels bound the number of '?' (propagation) or placeholders (2-bit
+// derivation) in the differentials that are still processed.
+enum StrengthLevel {
+  strength_off,
+  strength_low,
+  strength_medium,
+  strength_full
+};
+
+// Usefulness counters of one operation family in one step range,
+// accumulated since the last update of the levels
+struct StrengthCounters {
+  uint64_t calls;
+  uint64_t props;   // propagated literals or derived equations
+  uint64_t reasons; // reasons of propagations used in conflict analysis
+  uint64_t cost;    // enumerated value pairs (see 'strength_cost')
+};
+
+// Similar to 'Limit' and 'Inc' in CaDiCaL: the levels are updated after
+// 'lim.calls' differentials were processed and the interval then grows
+// by 'inc.calls' up to a maximum.
+struct StrengthLimit {
+  int64_t calls; // calls until the next update
+};
+
+struct StrengthInc {
+  int64_t calls; // current update interval
+};
+
+// The cost of processing a differential is measured by the number of value
+// pairs of its inputs the enumeration goes through rather than by timing
+// it, such that the levels and thus the search are the same on every run.
+inline uint64_t strength_cost (const string &inputs) {
+  uint64_t cost = 1;
+  for (auto &c : inputs)
+    cost *= max (1, __builtin_popcount (gc_pairs (c)));
+  return cost;
+}
+
+class Strength {
+  uint8_t levels[NUM_OPS][STRENGTH_RANGES];
+  StrengthCounters counters[NUM_OPS][STRENGTH_RANGES];
+  uint64_t skipped[NUM_OPS][STRENGTH_RANGES];
+  StrengthLimit lim;
+  StrengthInc inc;
+  int64_t calls = 0;
+  uint64_t updates = 0;
+
+  void update ();
+
+public:
+  // Maximum number of unknowns allowed by each strength level
+  int max_unknowns[strength_full + 1];
+
+  Strength (int low, int medium, int full);
+
+  int level (OperationId op_id, int step_i) const {
+    return levels[op_id][step_i / STRENGTH_STEP_RANGE];
+  }
+
+  // Decide whether a differential with 'unknowns' unknowns is processed
+  bool allows (OperationId op_id, int step_i, int unknowns);
+
+  // Account a processed differential and the propagations it led to
+  void record (OperationId op_id, int step_i, uint64_t cost, int props);
+
+  // Account a propagation that was used for conflict analysis
+  void record_reason (OperationId op_id, int step_i) {
+    counters[op_id][step_i / STRENGTH_STEP_RANGE].reasons++;
+  }
+
+  uint64_t updates_count () const { return updates; }
+  void print (const char *name);
+};
+
+#if ADAPTIVE_PROP
+extern Strength prop_strength, two_bit_strength;
+#endif
+} // namespace SHA256
+
+#endif
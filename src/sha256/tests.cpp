@@ -1,11 +1,16 @@
 #include "tests.hpp"
 #include "2_bit.hpp"
 #include "2_bit_graph.hpp"
+#include "4_bit/state.hpp"
+#include "blocking.hpp"
 #include "propagate.hpp"
 #include "sha256.hpp"
 #include "state.hpp"
+#include "strength.hpp"
 #include "util.hpp"
+#include "verify.hpp"
 #include "wordwise_propagate.hpp"
+#include "xor_engine.hpp"
 #include <cassert>
 #include <cstdio>
 #include <cstring>
@@ -377,6 +382,38 @@ void test_otf_2bit_eqs () {
     assert (equations[1].ids[1] == 4);
     assert (equations[1].diff == 1);
   }
+  {
+    // More than four placeholders
+    pair<vector<uint32_t>, vector<uint32_t>> ids;
+    for (uint32_t i = 0; i < 10; i++) {
+      ids.first.push_back (i + 1);
+      ids.second.push_back (i + 101);
+    }
+    auto equations =
+        otf_2bit_eqs (add_, "-01-ux-", "-x-", ids, "++++++++++");
+    assert (equations.size () == 22);
+    assert (equations[0].ids[0] == 1 && equations[0].ids[1] == 4);
+    assert (equations[0].diff == 0);
+    assert (equations[3].ids[0] == 1 && equations[3].ids[1] == 10);
+    assert (equations[3].diff == 1);
+    assert (equations[7].ids[0] == 6 && equations[7].ids[1] == 9);
+    assert (equations[7].diff == 0);
+    assert (equations[14].ids[0] == 101 && equations[14].ids[1] == 110);
+    assert (equations[14].diff == 1);
+    assert (equations[18].ids[0] == 106 && equations[18].ids[1] == 109);
+    assert (equations[18].diff == 0);
+  }
+  {
+    // Relation over all the four placeholders
+    auto equations =
+        otf_2bit_xors (xor_, "x--", "x", {{1, 2, 3, 4}, {11, 12, 13, 14}},
+                       "++++");
+    assert (equations.size () == 2);
+    assert (equations[0].ids == vector<uint32_t> ({1, 2, 3, 4}));
+    assert (equations[0].rhs == 0);
+    assert (equations[1].ids == vector<uint32_t> ({11, 12, 13, 14}));
+    assert (equations[1].rhs == 0);
+  }
 #endif
 }
 
@@ -551,6 +588,209 @@ void test_2_bit_graph () {
   }
 }
 
+void test_strength () {
+  Strength strength (1, 3, 4);
+  assert (strength.allows (op_maj, 0, 4));
+  assert (!strength.allows (op_maj, 0, 5));
+
+  // Useless operations get weaker and useful ones stay at full strength
+  for (int i = 0; i < 10000; i++) {
+    strength.record (op_maj, 0, 10, 0);
+    strength.record (op_ch, 40, 10, 2);
+  }
+  assert (strength.updates_count () == 1);
+  assert (strength.level (op_maj, 0) == strength_medium);
+  assert (strength.level (op_maj, 8) == strength_full);
+  assert (strength.level (op_ch, 40) == strength_full);
+  assert (!strength.allows (op_maj, 0, 4));
+  assert (strength.allows (op_maj, 0, 3));
+}
+
+void test_xor_engine () {
+  XorEngine engine;
+  vector<int> conflict;
+  auto value = [] (uint32_t id) { return id == 1 ? 1 : id == 2 ? -1 : 0; };
+  (void) value;
+
+  // x1 + x2 + x3 = 1 and x3 + x4 = 0 imply x4 = 0 under x1 = 1, x2 = 0
+  assert (engine.add ({1, 2, 3}, 1, {-10}, conflict));
+  assert (engine.add ({3, 4}, 0, {-11}, conflict));
+  assert (engine.add ({4, 3}, 0, {-12}, conflict));
+  assert (engine.size () == 2);
+  {
+    vector<pair<int, vector<int>>> units;
+    assert (engine.propagate (value, units, conflict));
+    assert (units.size () == 1);
+    assert (units[0].first == -4);
+    assert (units[0].second == vector<int> ({-11, -10, -1, 2}));
+  }
+
+  engine.new_level ();
+  // x1 + x2 + x4 = 0 contradicts the first two equations
+  assert (!engine.add ({1, 2, 4}, 0, {-13}, conflict));
+  assert (conflict == vector<int> ({-13, -11, -10}));
+  // x4 = 1 is eliminated from the older rows
+  assert (engine.add ({4}, 1, {-14}, conflict));
+  {
+    vector<pair<int, vector<int>>> units;
+    assert (!engine.propagate (value, units, conflict));
+  }
+
+  // Backtracking restores the older rows
+  engine.pop_level ();
+  assert (engine.size () == 2);
+  {
+    vector<pair<int, vector<int>>> units;
+    assert (engine.propagate (value, units, conflict));
+    assert (units.size () == 1 && units[0].first == -4);
+  }
+
+  // Only the rows of touched variables are revisited
+  XorEngine touched;
+  unordered_map<uint32_t, int> values;
+  auto assigned = [&] (uint32_t id) {
+    auto it = values.find (id);
+    return it == values.end () ? 0 : it->second;
+  };
+  assert (touched.add ({1, 2, 3}, 1, {-10}, conflict));
+  assert (touched.add ({4, 5}, 0, {-11}, conflict));
+  {
+    vector<pair<int, vector<int>>> units;
+    assert (touched.propagate (assigned, units, conflict));
+    assert (units.empty ());
+    values[1] = 1, values[2] = -1, values[4] = 1;
+    assert (touched.propagate (assigned, units, conflict));
+    assert (units.empty ());
+    touched.touch (1);
+    assert (touched.propagate (assigned, units, conflict));
+    assert (units.size () == 1 && units[0].first == -3);
+    // The unit row is revisited until the unit is assigned
+    touched.touch (4);
+    units.clear ();
+    assert (touched.propagate (assigned, units, conflict));
+    assert (units.size () == 2);
+    values[3] = -1, values[5] = 1;
+    touched.touch (3), touched.touch (5);
+    units.clear ();
+    assert (touched.propagate (assigned, units, conflict));
+    assert (units.empty ());
+    // Unassigning a variable turns the row into a unit again
+    values.erase (2);
+    touched.touch (2);
+    assert (touched.propagate (assigned, units, conflict));
+    assert (units.size () == 1 && units[0].first == -2);
+  }
+
+  // The columns of the rows of a popped level are dropped
+  touched.new_level ();
+  for (uint32_t id = 100; id < 300; id += 2)
+    assert (touched.add ({id, id + 1}, 0, {-12}, conflict));
+  assert (touched.width () == 205);
+  touched.pop_level ();
+  assert (touched.size () == 2 && touched.width () == 5);
+  // x3 + x6 = 1 is eliminated from the first row (x1 + x2 + x6 = 0)
+  assert (touched.add ({3, 6}, 1, {-13}, conflict));
+  {
+    values.erase (3), values[6] = 1;
+    touched.touch (3), touched.touch (6);
+    vector<pair<int, vector<int>>> units;
+    assert (touched.propagate (assigned, units, conflict));
+    set<int> lits;
+    for (auto &unit : units)
+      lits.insert (unit.first);
+    assert (lits == set<int> ({-3, -2}));
+  }
+}
+
+void test_blocking () {
+  // 3 was propagated from -1 and -4 and 5 from -3 and -6 (fixed)
+  unordered_map<int, vector<int>> implications = {{3, {-1, -4}},
+                                                  {5, {-3, -6}}};
+  auto is_fixed = [] (int var) { return var == 6; };
+  (void) is_fixed;
+  {
+    vector<int> clause = {-1, -3, -4, -5, 7};
+    assert (minimize_blocking_clause (clause, implications, is_fixed) ==
+            2);
+    sort (clause.begin (), clause.end ());
+    assert (clause == vector<int> ({-4, -1, 7}));
+  }
+  {
+    // -1 isn't implied, so -5 can't be removed through -3
+    vector<int> clause = {-2, -5};
+    implications[5] = {-2, -3};
+    assert (minimize_blocking_clause (clause, implications, is_fixed) ==
+            0);
+  }
+
+  set<vector<int>> added;
+  uint64_t duplicates = 0;
+  auto clauses = select_blocking_clauses (
+      {{3, 1, 2}, {2, 1}, {4, 5}, {1, 2}, {6, 7, 8}}, added, 3,
+      duplicates);
+  assert (clauses.size () == 3);
+  assert (clauses[0] == vector<int> ({1, 2}));
+  assert (clauses[1] == vector<int> ({4, 5}));
+  assert (clauses[2] == vector<int> ({6, 7, 8}));
+  assert (duplicates == 1);
+  // The clauses added before (also on other decision levels) are
+  // suppressed, since the solver keeps them as irredundant clauses
+  clauses = select_blocking_clauses ({{5, 4}, {6, 7, 8}, {9}}, added, 3,
+                                     duplicates);
+  assert (clauses.size () == 1 && clauses[0][0] == 9);
+  assert (duplicates == 3);
+}
+
+void test_4bit_chars () {
+#if IS_4BIT
+  PartialAssignment partial_assignment (16, NULL, NULL);
+  VarInfo vars_info[16];
+  partial_assignment.vars_info = vars_info;
+  // Pairs 10 and 01 of the characteristic at 4 are excluded ('-')
+  partial_assignment.set (-5);
+  partial_assignment.set (-6);
+
+  vector<int> antecedent;
+  add_4bit_antecedent (partial_assignment, 4, '-', antecedent);
+  assert (antecedent == vector<int> ({5, 6}));
+
+  // Narrowing '-' down to '1' excludes 00, but not the excluded pairs
+  assert (get_4bit_lits (partial_assignment, 4, '1') == vector<int> ({-4}));
+  assert (get_4bit_lits (partial_assignment, 4, '-').empty ());
+
+  Word word;
+  word.char_ids[3] = 4;
+  VarInfo info (&word, 0, 3, DA);
+  assert (phase_4bit_lit (info, 4) == 4);
+  assert (phase_4bit_lit (info, 5) == -5);
+  assert (phase_4bit_lit (info, 6) == -6);
+  assert (phase_4bit_lit (info, 7) == 7);
+#endif
+}
+
+void test_compute_block () {
+  // The compression of the padded message "abc" from the initial values
+  uint32_t iv[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+  BlockWords block = {};
+  for (int i = 0; i < 4; i++) {
+    block.a[3 - i] = iv[i];
+    block.e[3 - i] = iv[4 + i];
+  }
+  block.w[0] = 0x61626380;
+  block.w[15] = 24;
+  compute_block (block, 64);
+  assert (block.w[16] == 0x61626380 && block.w[63] == 0x12b1edeb);
+  // The digest adds the initial values to the last four states
+  uint32_t digest[8] = {0xba7816bf, 0x8f01cfea, 0x414140de, 0x5dae2223,
+                        0xb00361a3, 0x96177a9c, 0xb410ff61, 0xf20015ad};
+  (void) digest;
+  for (int i = 0; i < 4; i++) {
+    assert (uint32_t (block.a[67 - i] + iv[i]) == digest[i]);
+    assert (uint32_t (block.e[67 - i] + iv[4 + i]) == digest[4 + i]);
+  }
+}
+
 void run_tests () {
   printf ("Running tests\n");
   test_group_wordwise_prop ();
@@ -560,6 +800,11 @@ void run_tests () {
   test_consistency_checker ();
   test_bit_manipulator ();
   test_2_bit_graph ();
+  test_strength ();
+  test_xor_engine ();
+  test_blocking ();
+  test_4bit_chars ();
+  test_compute_block ();
   printf ("All tests passed!\n");
 }
 } // namespace SHA256
@@ -2,6 +2,7 @@
 #define _sha256_types_hpp_INCLUDED
 
 #include "2_bit_graph.hpp"
+#include "xor_engine.hpp"
 #include <cinttypes>
 #include <cstdint>
 #include <list>
@@ -25,6 +26,8 @@
 #define TWO_BIT_ADD_DIFFS false   // Inconsistency blocking with addition
 #define MENDEL_BRANCHING false    // Mendel et al.'s branching
 #define MENDEL_BRANCHING_STAGES 3 // Stages in Mendel et al.'s branching
+#define ADAPTIVE_PROP false       // Adaptive propagation strength
+#define XOR_ENGINE false          // Gauss-Jordan elimination of 2-bit XORs
 
 #define SET_PHASE false          // Set phase to false for primary variables
 #define SHOW_DECISION_DIST false // Show the decision distribution
@@ -205,9 +208,15 @@ struct Stats {
   clock_t total_mendel_branch_time = 0;
 
   uint64_t clauses_count = 0;
+  // Literals removed from blocking clauses by minimization
+  uint64_t blocking_minimized_lits_count = 0;
+  // Blocking clauses skipped since they were added before
+  uint64_t blocking_duplicates_count = 0;
   uint64_t reasons_count = 0;
   uint64_t decisions_count = 0;
   uint64_t wordwise_prop_decisions_count = 0;
+  // Callback rounds skipped since no observed word changed
+  uint64_t clean_rounds_count = 0;
   // Decisions made with mendel's branching technique
   uint64_t mendel_branching_decisions_count = 0;
   uint64_t mendel_branching_stage3_count = 0;
@@ -232,6 +241,11 @@ struct Stats {
   uint64_t prop_cached_calls = 0;
   uint64_t two_bit_total_calls = 0;
   uint64_t two_bit_cached_calls = 0;
+
+  // Gauss-Jordan elimination stats
+  uint64_t xor_equations_count = 0;
+  uint64_t xor_units_count = 0;
+  uint64_t xor_conflicts_count = 0;
 };
 
 struct Operations {
@@ -342,6 +356,8 @@ struct Operations {
 struct Reason {
   vector<int> antecedent;
   pair<string, string> differentials;
+  // Operation that led to the propagation (-1 if not bitsliced)
+  int op_id = -1, step_i = -1;
 };
 
 struct Equation {
@@ -362,8 +378,16 @@ struct Equation {
   }
 };
 
+// Linear relation 'XOR of the IDs = rhs' over any number of variables
+struct XorEquation {
+  vector<uint32_t> ids;
+  uint8_t rhs;
+};
+
 struct TwoBit {
   list<list<Equation>> equations_trail;
+  // Relations of the derived differentials (levels follow the trail)
+  XorEngine xor_engine;
 
   // * Graph approach
   TwoBitGraph graph;
@@ -127,6 +127,76 @@ inline vector<int> xor_ (vector<int> inputs) {
   return {value};
 }
 
+// Name of a function for the cache keys (unlike its address, it's the same
+// across runs)
+inline char function_tag (vector<int> (*func) (vector<int> inputs)) {
+  if (func == xor_)
+    return 'x';
+  if (func == maj_)
+    return 'm';
+  if (func == ch_)
+    return 'c';
+  assert (func == add_);
+  return 'a';
+}
+
+typedef vector<int> (*BitFunction) (vector<int> inputs);
+
+// Inverse of 'function_tag' (null for unknown tags)
+inline BitFunction tag_function (char tag) {
+  switch (tag) {
+  case 'x':
+    return xor_;
+  case 'm':
+    return maj_;
+  case 'c':
+    return ch_;
+  case 'a':
+    return add_;
+  default:
+    return NULL;
+  }
+}
+
+// Possible (first block, second block) value pairs of a characteristic as
+// a mask with bits for 00, 10, 01 and 11 (in that order)
+inline uint8_t gc_pairs (char c) {
+  switch (c) {
+  case '?':
+    return 15;
+  case '-':
+    return 9;
+  case 'x':
+    return 6;
+  case '0':
+    return 1;
+  case 'u':
+    return 2;
+  case 'n':
+    return 4;
+  case '1':
+    return 8;
+  case '3':
+    return 3;
+  case '5':
+    return 5;
+  case '7':
+    return 7;
+  case 'A':
+    return 10;
+  case 'B':
+    return 11;
+  case 'C':
+    return 12;
+  case 'D':
+    return 13;
+  case 'E':
+    return 14;
+  default:
+    return 0;
+  }
+}
+
 #if IS_4BIT
 inline uint8_t gc_values_4bit (char c) {
   uint8_t values = 0;
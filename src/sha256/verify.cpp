@@ -0,0 +1,212 @@
+#include "verify.hpp"
+#include "sha256.hpp"
+#include <cstdio>
+#include <string>
+
+namespace SHA256 {
+const uint32_t k_constants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+static inline uint32_t rotr (uint32_t x, int n) {
+  return (x >> n) | (x << (32 - n));
+}
+
+void compute_block (BlockWords &block, int order) {
+  uint32_t *a = block.a + 4, *e = block.e + 4, *w = block.w;
+  for (int i = 16; i < order; i++) {
+    uint32_t s0 = rotr (w[i - 15], 7) ^ rotr (w[i - 15], 18) ^
+                  (w[i - 15] >> 3);
+    uint32_t s1 = rotr (w[i - 2], 17) ^ rotr (w[i - 2], 19) ^
+                  (w[i - 2] >> 10);
+    w[i] = s1 + w[i - 7] + s0 + w[i - 16];
+  }
+  for (int i = 0; i < order; i++) {
+    uint32_t sigma0 =
+        rotr (a[i - 1], 2) ^ rotr (a[i - 1], 13) ^ rotr (a[i - 1], 22);
+    uint32_t sigma1 =
+        rotr (e[i - 1], 6) ^ rotr (e[i - 1], 11) ^ rotr (e[i - 1], 25);
+    uint32_t maj = (a[i - 1] & a[i - 2]) ^ (a[i - 1] & a[i - 3]) ^
+                   (a[i - 2] & a[i - 3]);
+    uint32_t ch = (e[i - 1] & e[i - 2]) ^ (~e[i - 1] & e[i - 3]);
+    uint32_t t = e[i - 4] + sigma1 + ch + k_constants[i] + w[i];
+    e[i] = a[i - 4] + t;
+    a[i] = t + sigma0 + maj;
+  }
+}
+
+#if IS_1BIT || IS_4BIT
+// Error message of the last failed verification
+static string verify_error;
+
+// The values of the blocks in the model by variable
+class ModelValues {
+  vector<int8_t> values;
+
+public:
+  ModelValues (const vector<int> &model) : values (MAX_VAR_ID) {
+    for (auto &lit : model)
+      if (abs (lit) < MAX_VAR_ID)
+        values[abs (lit)] = lit > 0 ? 1 : -1;
+  }
+
+  int8_t operator[] (int var) const { return values[var]; }
+
+  // Pairs of values of both blocks the model allows for a bit (one bit
+  // per pair 00, 10, 01 and 11)
+  uint8_t pairs (const Word &word, int i) const {
+#if IS_4BIT
+    // Only the values of the words the blocks are computed from are known
+    int f = values[word.ids_f[i]], g = values[word.ids_g[i]];
+    if (f && g)
+      return 1 << ((f > 0) | (g > 0) << 1);
+    uint8_t pairs = 0;
+    for (int k = 0; k < 4; k++)
+      if (values[word.char_ids[i] + k] > 0)
+        pairs |= 1 << k;
+    return pairs;
+#else
+    int f = values[word.ids_f[i]] > 0, g = values[word.ids_g[i]] > 0;
+    return 1 << (f | g << 1);
+#endif
+  }
+
+  // Whether the difference of the bit is the one of its values
+  bool is_consistent (const Word &word, int i) const {
+#if IS_4BIT
+    int f = values[word.ids_f[i]], g = values[word.ids_g[i]];
+    if (!f || !g)
+      return true;
+    return values[word.char_ids[i] + ((f > 0) | (g > 0) << 1)] > 0;
+#else
+    bool f = values[word.ids_f[i]] > 0, g = values[word.ids_g[i]] > 0;
+    return (values[word.char_ids[i]] > 0) == (f != g);
+#endif
+  }
+};
+
+// Read the values of both blocks from a word, or return false if the
+// model allows more than one pair of values for some bit
+static bool read_word (const ModelValues &values, const Word &word,
+                       uint32_t &f, uint32_t &g) {
+  f = g = 0;
+  for (int i = 0; i < 32; i++) {
+    uint8_t pairs = values.pairs (word, i);
+    if (pairs & (pairs - 1) || !pairs)
+      return false;
+    f |= uint32_t (pairs & 0xa ? 1 : 0) << i;
+    g |= uint32_t (pairs & 0xc ? 1 : 0) << i;
+  }
+  return true;
+}
+
+// Check the computed values of a word against the model
+static const char *check_word (const ModelValues &values, const Word &word,
+                               uint32_t f, uint32_t g, const char *name,
+                               int step) {
+  for (int i = 0; i < 32; i++) {
+    int pair = (f >> i & 1) | (g >> i & 1) << 1;
+    const char *what = 0;
+    if (!(values.pairs (word, i) >> pair & 1))
+      what = "value";
+    else if (!values.is_consistent (word, i))
+      what = "difference";
+    if (!what)
+      continue;
+    verify_error = string ("wrong ") + what + " of bit " + to_string (i) +
+                   " of " + name + "_" + to_string (step);
+    return verify_error.c_str ();
+  }
+  return 0;
+}
+
+// Check the computed values of all the words against the model
+static const char *check_words (const ModelValues &values, Step *steps,
+                                BlockWords *blocks, int order) {
+  for (int i = -4; i < order; i++) {
+    const char *err;
+    int j = ABS_STEP (i);
+    if ((err = check_word (values, steps[j].a, blocks[0].a[j],
+                           blocks[1].a[j], "A", i)) ||
+        (err = check_word (values, steps[j].e, blocks[0].e[j],
+                           blocks[1].e[j], "E", i)))
+      return err;
+    if (i >= 0 && (err = check_word (values, steps[i].w, blocks[0].w[i],
+                                     blocks[1].w[i], "W", i)))
+      return err;
+  }
+  return 0;
+}
+
+Verification verify_model (State &state, const vector<int> &model) {
+  Verification result;
+  ModelValues values (model);
+  int order = state.order;
+  auto &steps = state.steps;
+
+  BlockWords blocks[2];
+  for (int i = -4; i < 0; i++) {
+    int j = ABS_STEP (i);
+    if (!read_word (values, steps[j].a, blocks[0].a[j], blocks[1].a[j]) ||
+        !read_word (values, steps[j].e, blocks[0].e[j], blocks[1].e[j])) {
+      result.is_undetermined = true;
+      return result;
+    }
+  }
+  for (int i = 0; i < min (order, 16); i++)
+    if (!read_word (values, steps[i].w, blocks[0].w[i], blocks[1].w[i])) {
+      result.is_undetermined = true;
+      return result;
+    }
+  compute_block (blocks[0], order);
+  compute_block (blocks[1], order);
+
+  result.error = check_words (values, steps, blocks, order);
+
+  // No differences in the first and last four states but in the message
+  result.is_collision = false;
+  for (int i = 0; i < min (order, 16); i++)
+    result.is_collision |= blocks[0].w[i] != blocks[1].w[i];
+  for (int i = 0; i < 4; i++)
+    for (int j : {i, order + i})
+      if (blocks[0].a[j] != blocks[1].a[j] ||
+          blocks[0].e[j] != blocks[1].e[j])
+        result.is_collision = false;
+  if (!result.error)
+    return result;
+
+  // Block the values of the words the blocks are computed from
+  vector<Word *> free_words;
+  for (int i = -4; i < 0; i++) {
+    free_words.push_back (&steps[ABS_STEP (i)].a);
+    free_words.push_back (&steps[ABS_STEP (i)].e);
+  }
+  for (int i = 0; i < min (order, 16); i++)
+    free_words.push_back (&steps[i].w);
+
+  for (auto &word : free_words)
+    for (int i = 0; i < 32; i++) {
+#if IS_4BIT
+      for (int k = 0; k < 4; k++) {
+        int var = word->char_ids[i] + k;
+        result.blocking_clause.push_back (values[var] > 0 ? -var : var);
+      }
+#else
+      for (int var : {int (word->ids_f[i]), int (word->ids_g[i])})
+        result.blocking_clause.push_back (values[var] > 0 ? -var : var);
+#endif
+    }
+
+  return result;
+}
+#endif
+} // namespace SHA256
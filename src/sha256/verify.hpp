@@ -0,0 +1,45 @@
+#ifndef _sha256_verify_hpp_INCLUDED
+#define _sha256_verify_hpp_INCLUDED
+
+#include "state.hpp"
+#include "types.hpp"
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+namespace SHA256 {
+extern const uint32_t k_constants[64];
+
+// Words of one block of the step-reduced compression function. As in the
+// state, A and E are indexed from step -4 on (see 'ABS_STEP') and W from
+// step 0 on.
+struct BlockWords {
+  uint32_t a[64 + 4], e[64 + 4], w[64];
+};
+
+// Compute the message expansion from step 16 on and the steps 0 to
+// 'order - 1' from the first four A and E words and the message words
+void compute_block (BlockWords &block, int order);
+
+#if IS_1BIT || IS_4BIT
+struct Verification {
+  // Why the model is not a solution (or 0 if it is one)
+  const char *error = 0;
+  // The model allows several values of the blocks (4-bit encoding)
+  bool is_undetermined = false;
+  // Equal first and last four states from different messages
+  bool is_collision = false;
+  // Excludes the values of the words the blocks are computed from
+  vector<int> blocking_clause;
+};
+
+// Check a model of the encoding by evaluating the compression function
+// on both blocks: the words of each block have to be those computed from
+// its first four A and E words and its message words, and the differences
+// have to be the ones of the blocks (and thus follow the characteristic).
+Verification verify_model (State &state, const vector<int> &model);
+#endif
+} // namespace SHA256
+
+#endif
@@ -1,4 +1,5 @@
 #include "wordwise_propagate.hpp"
+#include "kernel_trace.hpp"
 #include "sha256.hpp"
 #include "types.hpp"
 #include "util.hpp"
@@ -17,6 +18,9 @@
 using namespace std;
 
 namespace SHA256 {
+cache::lru_cache<string, pair<string, string>>
+    wordwise_propagate_cache (100e3);
+
 // * Important: The wordwise propagation engine uses big-endian ordering
 struct ValueWithOrder {
   char value;
@@ -292,6 +296,8 @@ vector<string> apply_grounding (vector<string> words,
 }
 
 vector<string> wordwise_propagate (vector<string> words, int64_t constant) {
+  if (kernel_trace != NULL)
+    kernel_trace->wordwise (words, constant);
   auto count_vars = [] (vector<string> cols) {
     int vars_count = 0;
     for (auto &col : cols) {
@@ -1,6 +1,7 @@
 #ifndef _sha256_wordwise_propagate_hpp_INCLUDED
 #define _sha256_wordwise_propagate_hpp_INCLUDED
 
+#include "lru_cache.hpp"
 #include "types.hpp"
 #include <cstdint>
 #include <string>
@@ -9,6 +10,10 @@
 using namespace std;
 
 namespace SHA256 {
+// Wordwise propagations by the operation and the input and output words
+extern cache::lru_cache<string, pair<string, string>>
+    wordwise_propagate_cache;
+
 int64_t _word_diff (string chars);
 int64_t adjust_constant (string word, int64_t constant,
                          vector<char> adjustable_gcs = {});
@@ -0,0 +1,267 @@
+#include "xor_engine.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+namespace SHA256 {
+int XorEngine::column (uint32_t var) {
+  auto it = columns.find (var);
+  if (it != columns.end ())
+    return it->second;
+
+  int column = vars.size ();
+  vars.push_back (var);
+  columns[var] = column;
+  occurrences.push_back ({});
+
+  // Grow the rows when a new word is needed
+  if (vars.size () > words * 64) {
+    words++;
+    for (auto &row : rows)
+      row.bits.resize (words, 0);
+  }
+
+  return column;
+}
+
+// The word loop is kept simple so that it is vectorized by the compiler
+void XorEngine::eliminate (XorRow &row, const XorRow &pivot_row) {
+  assert (row.bits.size () == pivot_row.bits.size ());
+  uint64_t *bits = row.bits.data ();
+  const uint64_t *pivot_bits = pivot_row.bits.data ();
+  for (size_t i = 0; i < words; i++)
+    bits[i] ^= pivot_bits[i];
+  row.rhs ^= pivot_row.rhs;
+
+  vector<int> antecedent;
+  set_union (row.antecedent.begin (), row.antecedent.end (),
+             pivot_row.antecedent.begin (), pivot_row.antecedent.end (),
+             back_inserter (antecedent));
+  row.antecedent = move (antecedent);
+}
+
+void XorEngine::mark (int row) {
+  if (is_dirty[row])
+    return;
+  is_dirty[row] = true;
+  dirty.push_back (row);
+}
+
+void XorEngine::connect (int row) {
+  const uint64_t *bits = rows[row].bits.data ();
+  for (size_t i = 0; i < words; i++)
+    for (uint64_t word = bits[i]; word; word &= word - 1) {
+      occurrences[i * 64 + __builtin_ctzll (word)].push_back (row);
+      occurrences_count++;
+    }
+}
+
+// Columns only stay in the table once used, so they are dropped when most
+// of them are in none of the rows (including the rows still to be
+// restored), and the occurrence lists are rebuilt when most of their
+// entries are stale
+void XorEngine::compact () {
+  vector<uint64_t> live (words, 0);
+  size_t bits = 0;
+  for (auto &row : rows)
+    for (size_t i = 0; i < words; i++) {
+      live[i] |= row.bits[i];
+      bits += __builtin_popcountll (row.bits[i]);
+    }
+  for (auto &entry : undo)
+    for (size_t i = 0; i < entry.second.bits.size (); i++)
+      live[i] |= entry.second.bits[i];
+  size_t live_columns = 0;
+  for (auto &word : live)
+    live_columns += __builtin_popcountll (word);
+
+  if (2 * live_columns < vars.size ()) {
+    vector<int> map (vars.size (), -1);
+    vector<uint32_t> live_vars;
+    unordered_map<uint32_t, int> live_columns_map;
+    for (size_t i = 0; i < words; i++)
+      for (uint64_t word = live[i]; word; word &= word - 1) {
+        int col = i * 64 + __builtin_ctzll (word);
+        map[col] = live_vars.size ();
+        live_columns_map[vars[col]] = live_vars.size ();
+        live_vars.push_back (vars[col]);
+      }
+    size_t live_words = (live_vars.size () + 63) / 64;
+    auto remap = [&] (XorRow &row) {
+      vector<uint64_t> bits (live_words, 0);
+      for (size_t i = 0; i < row.bits.size (); i++)
+        for (uint64_t word = row.bits[i]; word; word &= word - 1) {
+          int col = map[i * 64 + __builtin_ctzll (word)];
+          assert (col >= 0);
+          bits[col / 64] |= 1ull << (col % 64);
+        }
+      row.bits = move (bits);
+    };
+    for (auto &row : rows)
+      remap (row);
+    for (auto &entry : undo)
+      remap (entry.second);
+    for (auto &pivot : pivots)
+      pivot = map[pivot];
+    vars = move (live_vars);
+    columns = move (live_columns_map);
+    words = live_words;
+    occurrences.resize (vars.size ());
+  } else if (occurrences_count <= 2 * bits)
+    return;
+
+  for (auto &list : occurrences)
+    list.clear ();
+  occurrences_count = 0;
+  for (size_t i = 0; i < rows.size (); i++)
+    connect (i);
+}
+
+void XorEngine::pop_level () {
+  assert (levels.size () > 1);
+  auto &level = levels.back ();
+  rows.resize (level.first);
+  pivots.resize (level.first);
+  is_dirty.resize (level.first);
+  dirty.erase (remove_if (dirty.begin (), dirty.end (),
+                          [&] (int row) { return row >= (int) rows.size (); }),
+               dirty.end ());
+
+  while (undo.size () > level.second) {
+    auto &entry = undo.back ();
+    rows[entry.first] = move (entry.second);
+    rows[entry.first].bits.resize (words, 0);
+    connect (entry.first);
+    mark (entry.first);
+    undo.pop_back ();
+  }
+
+  levels.pop_back ();
+  compact ();
+}
+
+bool XorEngine::add (const vector<uint32_t> &ids, uint8_t rhs,
+                     const vector<int> &antecedent,
+                     vector<int> &conflict) {
+  vector<int> row_columns;
+  for (auto &id : ids)
+    row_columns.push_back (column (id));
+
+  XorRow row;
+  row.bits.assign (words, 0);
+  for (auto &col : row_columns)
+    row.bits[col / 64] ^= 1ull << (col % 64);
+  row.rhs = rhs;
+  row.antecedent = antecedent;
+  sort (row.antecedent.begin (), row.antecedent.end ());
+  row.antecedent.erase (
+      unique (row.antecedent.begin (), row.antecedent.end ()),
+      row.antecedent.end ());
+
+  // Reduce the row with the pivots of the existing rows
+  for (size_t i = 0; i < rows.size (); i++)
+    if (row.bits[pivots[i] / 64] >> (pivots[i] % 64) & 1)
+      eliminate (row, rows[i]);
+
+  int pivot = -1;
+  for (size_t i = 0; i < words && pivot < 0; i++)
+    if (row.bits[i])
+      pivot = i * 64 + __builtin_ctzll (row.bits[i]);
+
+  // Linear combination of the existing rows
+  if (pivot < 0) {
+    if (row.rhs) {
+      conflict = row.antecedent;
+      return false;
+    }
+    return true;
+  }
+
+  // Eliminate the pivot from the other rows
+  size_t level_start = levels.back ().first;
+  for (size_t i = 0; i < rows.size (); i++) {
+    if (!(rows[i].bits[pivot / 64] >> (pivot % 64) & 1))
+      continue;
+    if (i < level_start)
+      undo.push_back ({i, rows[i]});
+    // Columns the row gains
+    for (size_t j = 0; j < words; j++)
+      for (uint64_t word = row.bits[j] & ~rows[i].bits[j]; word;
+           word &= word - 1) {
+        occurrences[j * 64 + __builtin_ctzll (word)].push_back (i);
+        occurrences_count++;
+      }
+    eliminate (rows[i], row);
+    mark (i);
+  }
+
+  rows.push_back (move (row));
+  pivots.push_back (pivot);
+  is_dirty.push_back (false);
+  connect (rows.size () - 1);
+  mark (rows.size () - 1);
+  return true;
+}
+
+void XorEngine::touch (uint32_t var) {
+  auto it = columns.find (var);
+  if (it == columns.end ())
+    return;
+  int col = it->second;
+  for (auto &row : occurrences[col])
+    if (row < (int) rows.size () &&
+        rows[row].bits[col / 64] >> (col % 64) & 1)
+      mark (row);
+}
+
+bool XorEngine::propagate (const function<int (uint32_t)> &value,
+                           vector<pair<int, vector<int>>> &units,
+                           vector<int> &conflict) {
+  vector<int> visit;
+  visit.swap (dirty);
+  for (size_t k = 0; k < visit.size (); k++) {
+    int row_index = visit[k];
+    is_dirty[row_index] = false;
+    auto &row = rows[row_index];
+    int unassigned = 0;
+    uint32_t unit = 0;
+    uint8_t parity = row.rhs;
+    for (size_t i = 0; i < words && unassigned < 2; i++)
+      for (uint64_t word = row.bits[i]; word && unassigned < 2;
+           word &= word - 1) {
+        uint32_t var = vars[i * 64 + __builtin_ctzll (word)];
+        int var_value = value (var);
+        if (var_value == 0) {
+          unassigned++;
+          unit = var;
+        } else if (var_value > 0)
+          parity ^= 1;
+      }
+    if (unassigned >= 2)
+      continue;
+    if (unassigned == 0 && parity == 0)
+      continue;
+
+    // The clause consists of the antecedent and the assigned variables
+    vector<int> clause = row.antecedent;
+    for (size_t i = 0; i < words; i++)
+      for (uint64_t word = row.bits[i]; word; word &= word - 1) {
+        uint32_t var = vars[i * 64 + __builtin_ctzll (word)];
+        int var_value = value (var);
+        if (var_value != 0)
+          clause.push_back (var_value > 0 ? -int (var) : int (var));
+      }
+
+    mark (row_index);
+    if (unassigned == 0) {
+      // The rows not visited yet are still dirty
+      dirty.insert (dirty.end (), visit.begin () + k + 1, visit.end ());
+      conflict = move (clause);
+      return false;
+    }
+    units.push_back ({parity ? int (unit) : -int (unit), move (clause)});
+  }
+
+  return true;
+}
+} // namespace SHA256
@@ -0,0 +1,82 @@
+#ifndef _sha256_xor_engine_hpp_INCLUDED
+#define _sha256_xor_engine_hpp_INCLUDED
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace SHA256 {
+// Row of the XOR matrix with one bit per column, packed in 64-bit words
+struct XorRow {
+  vector<uint64_t> bits;
+  uint8_t rhs;
+  // Falsified literals implying the row (sorted)
+  vector<int> antecedent;
+};
+
+// Incremental and backtrackable Gauss-Jordan elimination of XOR equations
+// over any number of variables. The matrix is kept in reduced row echelon
+// form, i.e. the pivot column of a row is zero in all the other rows. The
+// rows added in a level are removed when it's popped and the older rows
+// they were eliminated from are restored. Propagation only revisits the
+// rows which changed or have a variable that was assigned or unassigned
+// since (see 'touch').
+class XorEngine {
+  vector<uint32_t> vars;                // Variable of each column
+  unordered_map<uint32_t, int> columns; // Column of each variable
+  // Rows with a bit in each column, with stale entries of rows which lost
+  // the bit or were removed
+  vector<vector<int>> occurrences;
+  size_t occurrences_count = 0;
+  vector<XorRow> rows;
+  vector<int> pivots;
+  // Rows to revisit in the next propagation
+  vector<int> dirty;
+  vector<bool> is_dirty;
+  // Old versions of the rows from earlier levels changed by elimination
+  vector<pair<int, XorRow>> undo;
+  // Number of rows and undo entries at the start of each level
+  vector<pair<size_t, size_t>> levels;
+  size_t words = 0;
+
+  int column (uint32_t var);
+  void eliminate (XorRow &row, const XorRow &pivot_row);
+  void mark (int row);
+  void connect (int row);
+  void compact ();
+
+public:
+  XorEngine () { levels.push_back ({0, 0}); }
+
+  void new_level () { levels.push_back ({rows.size (), undo.size ()}); }
+  void pop_level ();
+  size_t size () const { return rows.size (); }
+  // Number of columns (variables of the current and restorable rows)
+  size_t width () const { return vars.size (); }
+
+  // Add the equation 'XOR of ids = rhs' implied by the antecedent.
+  // Returns false if it contradicts the matrix, with the blocking clause
+  // stored in 'conflict'.
+  bool add (const vector<uint32_t> &ids, uint8_t rhs,
+            const vector<int> &antecedent, vector<int> &conflict);
+
+  // Revisit the rows of the variable in the next propagation, which has to
+  // be called whenever it's assigned or unassigned
+  void touch (uint32_t var);
+
+  // Look for rows with a single unassigned variable (units along with the
+  // rest of their reason clause) or with all the variables assigned and
+  // the wrong parity (conflict). The value of a variable is positive if
+  // it's true, negative if it's false and zero if it's unassigned. Rows
+  // with units or conflicts are revisited until they no longer are.
+  bool propagate (const function<int (uint32_t)> &value,
+                  vector<pair<int, vector<int>>> &units,
+                  vector<int> &conflict);
+};
+} // namespace SHA256
+
+#endif
@@ -1042,6 +1042,52 @@ void Solver::close_proof_trace (bool print_statistics_unless_quiet) {
 
 /*------------------------------------------------------------------------*/
 
+void Solver::checkpoint (const char *path) {
+  LOG_API_CALL_BEGIN ("checkpoint", path);
+  REQUIRE_VALID_STATE ();
+  REQUIRE (path && *path, "invalid checkpoint path");
+  internal->checkpoint_path = path;
+  internal->lim.checkpoint =
+      internal->stats.conflicts + internal->opts.checkpointint;
+  LOG_API_CALL_END ("checkpoint", path);
+}
+
+const char *Solver::resume (const char *path) {
+  LOG_API_CALL_BEGIN ("resume", path);
+  REQUIRE_READY_STATE ();
+  transition_to_unknown_state ();
+  const char *err = internal->resume (path);
+  LOG_API_CALL_RETURNS ("resume", path, err);
+  return err;
+}
+
+void Solver::report_json (FILE *file) {
+  LOG_API_CALL_BEGIN ("report_json");
+  REQUIRE_VALID_STATE ();
+  REQUIRE (file, "zero file argument");
+  REQUIRE (!internal->json_file, "already writing JSON reports");
+  internal->json_file = file;
+  internal->json_reported.time = internal->time ();
+  LOG_API_CALL_END ("report_json");
+}
+
+bool Solver::report_json (const char *path) {
+  LOG_API_CALL_BEGIN ("report_json", path);
+  REQUIRE_VALID_STATE ();
+  REQUIRE (!internal->json_file, "already writing JSON reports");
+  FILE *file = fopen (path, "w");
+  const bool res = (file != 0);
+  if (res) {
+    internal->json_file = file;
+    internal->close_json_file = true;
+    internal->json_reported.time = internal->time ();
+  }
+  LOG_API_CALL_RETURNS ("report_json", path, res);
+  return res;
+}
+
+/*------------------------------------------------------------------------*/
+
 void Solver::build (FILE *file, const char *prefix) {
 
   assert (file == stdout || file == stderr);
@@ -1531,4 +1577,14 @@ void Solver::error (const char *fmt, ...) {
   va_end (ap);
 }
 
+void Solver::warning (const char *fmt, ...) {
+  if (state () == DELETING)
+    return;
+  REQUIRE_INITIALIZED ();
+  va_list ap;
+  va_start (ap, fmt);
+  internal->vwarning (fmt, ap);
+  va_end (ap);
+}
+
 } // namespace CaDiCaL
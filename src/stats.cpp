@@ -2,6 +2,8 @@
 
 #include "internal.hpp"
 #include "sha256/sha256.hpp"
+#include "sha256/shared_cache.hpp"
+#include "sha256/strength.hpp"
 #include <ctime>
 
 namespace CaDiCaL {
@@ -75,6 +77,9 @@ void Stats::print (Internal *internal) {
     PRT ("  pureclauses:   %15" PRId64 "   %10.2f    per pure literal",
          stats.blockpured, relative (stats.blockpured, stats.all.pure));
   }
+  if (all || stats.checkpoints)
+    PRT ("checkpoints:     %15" PRId64 "   %10.2f    interval",
+         stats.checkpoints, relative (stats.conflicts, stats.checkpoints));
   if (all || stats.chrono)
     PRT ("chronological:   %15" PRId64 "   %10.2f %%  of conflicts",
          stats.chrono, percent (stats.chrono, stats.conflicts));
@@ -177,6 +182,9 @@ void Stats::print (Internal *internal) {
     PRT ("  falsified:     %15" PRId64 "   %10.2f %%  per eprop-call",
          stats.ext_prop.eprop_conf,
          percent (stats.ext_prop.eprop_conf, stats.ext_prop.eprop_call));
+    PRT ("  skipped:       %15" PRId64 "   %10.2f %%  of queries",
+         stats.ext_prop.eprop_skip,
+         percent (stats.ext_prop.eprop_skip, stats.ext_prop.ext_cb));
     PRT ("ext.clause calls:%15" PRId64 "   %10.2f %%  of queries",
          stats.ext_prop.elearn_call,
          percent (stats.ext_prop.elearn_call, stats.ext_prop.ext_cb));
@@ -550,12 +558,36 @@ void Stats::print (Internal *internal) {
   PRT ("2-bit cache score:%14.4f",
        (float) sha256_stats.two_bit_cached_calls /
            sha256_stats.two_bit_total_calls);
+  if (SHA256::shared_cache) {
+    auto &shared_cache = *SHA256::shared_cache;
+    PRT ("shared hits:     %15ld", shared_cache.hits);
+    PRT ("shared misses:   %15ld", shared_cache.misses);
+    PRT ("shared stores:   %15ld", shared_cache.stores);
+    PRT ("shared drops:    %15ld", shared_cache.drops);
+  }
   PRT ("ext. reasons:    %15ld", reasons_count);
   PRT ("ext. clauses:    %15ld", programmatic_claues);
+  PRT ("ext. min. lits:  %15ld",
+       sha256_stats.blocking_minimized_lits_count);
+  PRT ("ext. dup. clauses:%14ld", sha256_stats.blocking_duplicates_count);
   PRT ("ext. decisions:  %15ld", decisions_count);
   PRT ("ext. m. branch:  %15ld", mendel_branching_decisions_count);
   PRT ("ext. m. brnch s3:%15ld", mendel_branching_stage3_count);
   PRT ("ext. ww prop.:   %15ld", wordwise_prop_decisions_count);
+  PRT ("ext. clean rounds:%14ld", sha256_stats.clean_rounds_count);
+#if ADAPTIVE_PROP
+  PRT ("prop. strength updates:%9ld",
+       SHA256::prop_strength.updates_count ());
+  PRT ("2-bit strength updates:%9ld",
+       SHA256::two_bit_strength.updates_count ());
+  SHA256::prop_strength.print ("prop.");
+  SHA256::two_bit_strength.print ("2-bit");
+#endif
+#if XOR_ENGINE
+  PRT ("xor equations:   %15ld", sha256_stats.xor_equations_count);
+  PRT ("xor units:       %15ld", sha256_stats.xor_units_count);
+  PRT ("xor conflicts:   %15ld", sha256_stats.xor_conflicts_count);
+#endif
   PRT ("DW branching ratio:  %11.4f",
        sha256_stats.dw_count.first /
            (float) (sha256_stats.dw_count.first +
@@ -645,6 +677,27 @@ void Internal::print_resource_usage () {
 
 /*------------------------------------------------------------------------*/
 
+void Deriver::print_stats () {
+
+  if (!stats.derived && !stats.failed)
+    return;
+
+  SECTION ("deriver statistics");
+
+  const int64_t derivations = stats.derived + stats.failed;
+  MSG ("derived:         %15" PRId64 "   %10.2f %%  of external clauses",
+       stats.derived, percent (stats.derived, derivations));
+  MSG ("failed:          %15" PRId64 "   %10.2f %%  of external clauses",
+       stats.failed, percent (stats.failed, derivations));
+  MSG ("steps:           %15" PRId64 "   %10.2f    per derivation",
+       stats.steps, relative (stats.steps, derivations));
+  MSG ("original:        %15" PRId64 "", stats.original);
+  MSG ("copied:          %15" PRId64 "   %10.2f %%  of original",
+       stats.copied, percent (stats.copied, stats.original));
+}
+
+/*------------------------------------------------------------------------*/
+
 void Checker::print_stats () {
 
   if (!stats.added && !stats.deleted)
@@ -33,6 +33,7 @@ struct Stats {
     int64_t
         eprop_conf; // number of times ex-propagate was already falsified
     int64_t eprop_expl; // number of times external propagate was explained
+    int64_t eprop_skip; // number of rounds skipped with a clean propagator
     int64_t
         elearn_call;  // number of times external clause learning was tried
     int64_t elearned; // learned external clauses (incl. eprop explanations)
@@ -135,6 +136,7 @@ struct Stats {
   int64_t recomputed;     // recomputed glues 'recompute_glue'
   int64_t searched;       // searched decisions in 'decide'
   int64_t reductions;     // 'reduce' counter
+  int64_t checkpoints;    // 'checkpoint' counter
   int64_t reduced;        // number of reduced clauses
   int64_t collected;      // number of collected bytes
   int64_t collections;    // number of garbage collections
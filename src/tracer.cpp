@@ -7,18 +7,80 @@ namespace CaDiCaL {
 Tracer::Tracer (Internal *i, File *f, bool b, bool lrat, bool frat,
                 bool veripb)
     : internal (i), file (f), binary (b), lrat (lrat), _flushed (false),
-      frat (frat), veripb (veripb), added (0), deleted (0), latest_id (0) {
+      frat (frat), veripb (veripb), added (0), deleted (0), latest_id (0),
+      ring (0), writer (0), stop (false), written (0), queued (0) {
   (void) internal;
   LOG ("TRACER new");
+  if (internal->opts.proofqueue && !frat && !veripb && file->owned ()) {
+    LOG ("TRACER writing proof in background");
+    ring = new Ring ((size_t) internal->opts.proofqueuesize << 20);
+    writer = new std::thread (&Tracer::write, this);
+  }
 }
 
 Tracer::~Tracer () {
   LOG ("TRACER delete");
+  if (writer) {
+    stop = true;
+    writer->join ();
+    delete writer;
+  }
+  delete ring;
   delete file;
 }
 
 /*------------------------------------------------------------------------*/
 
+// The solver thread only copies the clauses into the ring buffer, from
+// which 'write' in the writer thread takes them to encode and write them
+// (possibly compressed, see 'File::write').  Thus all other accesses of
+// 'file' have to wait until the writer caught up.
+
+void Tracer::enqueue (char type, uint64_t id, const vector<int> &clause,
+                      const vector<uint64_t> *chain) {
+  Record record;
+  record.type = type;
+  record.size = clause.size ();
+  record.chain = chain ? chain->size () : 0;
+  record.id = id;
+  ring->push (&record, sizeof record);
+  ring->push (clause.data (), record.size * sizeof (int));
+  if (record.chain)
+    ring->push (chain->data (), record.chain * sizeof (uint64_t));
+  queued++;
+}
+
+void Tracer::write () {
+  Record record;
+  vector<int> clause;
+  vector<uint64_t> chain;
+  while (ring->pop (&record, sizeof record, stop)) {
+    clause.resize (record.size);
+    chain.resize (record.chain);
+    ring->pop (clause.data (), record.size * sizeof (int), stop);
+    ring->pop (chain.data (), record.chain * sizeof (uint64_t), stop);
+    if (record.type == 'i')
+      latest_id = record.id;
+    else if (record.type == 'a' && lrat)
+      lrat_add_clause (record.id, clause, chain);
+    else if (record.type == 'a')
+      drat_add_clause (clause);
+    else if (lrat)
+      lrat_delete_clause (record.id);
+    else
+      drat_delete_clause (clause);
+    written.store (written.load (std::memory_order_relaxed) + 1,
+                   std::memory_order_release);
+  }
+}
+
+void Tracer::synchronize () {
+  while (written.load (std::memory_order_acquire) != queued)
+    std::this_thread::yield ();
+}
+
+/*------------------------------------------------------------------------*/
+
 // Support for binary DRAT format.
 
 inline void Tracer::put_binary_zero () {
@@ -336,7 +398,9 @@ void Tracer::add_original_clause (uint64_t id, const vector<int> &clause) {
 void Tracer::add_derived_clause (uint64_t id, const vector<int> &clause) {
   if (file->closed ())
     return;
-  if (frat)
+  if (ring)
+    enqueue ('a', id, clause);
+  else if (frat)
     frat_add_derived_clause (id, clause);
   else {
     assert (!lrat && !veripb);
@@ -350,7 +414,9 @@ void Tracer::add_derived_clause (uint64_t id, const vector<int> &clause,
                                  const vector<uint64_t> &chain) {
   if (file->closed ())
     return;
-  if (veripb)
+  if (ring)
+    enqueue ('a', id, clause, &chain);
+  else if (veripb)
     veripb_add_derived_clause (clause, chain);
   else if (frat)
     frat_add_derived_clause (id, clause, chain);
@@ -365,7 +431,11 @@ void Tracer::add_derived_clause (uint64_t id, const vector<int> &clause,
 void Tracer::delete_clause (uint64_t id, const vector<int> &clause) {
   if (file->closed ())
     return;
-  if (veripb)
+  if (ring && lrat)
+    enqueue ('d', id, {});
+  else if (ring)
+    enqueue ('d', id, clause);
+  else if (veripb)
     veripb_delete_clause (id);
   else if (frat)
     frat_delete_clause (id, clause);
@@ -385,6 +455,11 @@ void Tracer::finalize_clause (uint64_t id, const vector<int> &clause) {
 }
 
 void Tracer::set_first_id (uint64_t id) {
+  if (ring) {
+    if (!file->closed ())
+      enqueue ('i', id, vector<int> ());
+    return;
+  }
   latest_id = id;
   if (file->closed ())
     return;
@@ -400,6 +475,12 @@ void Tracer::close (bool print) {
   assert (!closed ());
   if (!flushed ())
     flush (print);
+  if (writer) {
+    stop = true;
+    writer->join ();
+    delete writer;
+    writer = 0;
+  }
   file->close (print);
 }
 
@@ -407,6 +488,8 @@ void Tracer::flush (bool print) {
   if (flushed ())
     return;
   assert (!closed ());
+  if (ring)
+    synchronize ();
   file->flush ();
 #ifndef QUIET
   if (!internal->opts.quiet)
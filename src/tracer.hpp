@@ -1,7 +1,9 @@
 #ifndef _tracer_h_INCLUDED
 #define _tracer_h_INCLUDED
 
-// Proof tracing to a file (actually 'File') in DRAT/FRAT format.
+// Proof tracing to a file (actually 'File') in DRAT/FRAT format.  DRAT
+// and LRAT proofs can also be written by a background thread, to which the
+// clauses are passed through a ring buffer (option 'proofqueue').
 
 namespace CaDiCaL {
 
@@ -20,6 +22,24 @@ class Tracer {
   uint64_t latest_id;
   vector<uint64_t> delete_ids;
 
+  // Asynchronous writing of DRAT and LRAT proofs.
+  //
+  struct Record {
+    char type; // 'a'dded, 'd'eleted or 'i'd of the first clause
+    unsigned size, chain;
+    uint64_t id;
+  };
+  Ring *ring;
+  std::thread *writer;
+  std::atomic<bool> stop;
+  std::atomic<uint64_t> written; // records by 'writer'
+  uint64_t queued;               // records in 'ring'
+
+  void enqueue (char type, uint64_t id, const vector<int> &,
+                const vector<uint64_t> *chain = 0);
+  void write ();       // in 'writer'
+  void synchronize (); // wait until all records are written
+
   void put_binary_zero ();
   void put_binary_lit (int external_lit);
   void put_binary_id (uint64_t id);
@@ -13,10 +13,13 @@ namespace CaDiCaL {
 // one could use a 32-bit reference instead of the pointer which would
 // however limit the number of clauses to '2^32 - 1'.  One would also need
 // to use at least one more bit (either taken away from the variable space
-// or the clauses) to denote whether the watch is binary.
+// or the clauses) to denote whether the watch is binary.  This is what
+// compiling with '-DCOMPACT' does (see below).
 
 struct Clause;
 
+#ifndef COMPACT
+
 struct Watch {
 
   Clause *clause;
@@ -27,8 +30,58 @@ struct Watch {
   Watch () {}
 
   bool binary () const { return size == 2; }
+  void update_size (int s) { size = s; }
 };
 
+#else
+
+// With '-DCOMPACT' watches only take 8 bytes.  The clause is referenced by
+// its offset in the clause heap (see 'arena.hpp') and the size is replaced
+// by the binary flag in the most significant bit of the reference, which
+// is all 'propagate' needs to know without accessing the clause.  The
+// reference converts to and from clause pointers, thus code using 'clause'
+// of a watch as pointer works unchanged.
+
+class ClauseRef {
+
+  static const uint32_t binary_bit = 1u << 31;
+  uint32_t ref;
+
+public:
+  ClauseRef () {}
+  ClauseRef (Clause *c, bool binary)
+      : ref (Arena::reference (c) | (binary ? binary_bit : 0)) {}
+
+  ClauseRef &operator= (Clause *c) {
+    ref = Arena::reference (c) | (ref & binary_bit);
+    return *this;
+  }
+
+  operator Clause * () const {
+    return (Clause *) Arena::dereference (ref & ~binary_bit);
+  }
+  Clause *operator->() const { return *this; }
+
+  bool binary () const { return ref & binary_bit; }
+  void set_binary (bool binary) {
+    ref = (ref & ~binary_bit) | (binary ? binary_bit : 0);
+  }
+};
+
+struct Watch {
+
+  ClauseRef clause;
+  int blit;
+
+  Watch (int b, Clause *c) : clause (c, c->size == 2), blit (b) {}
+  Watch () {}
+
+  bool binary () const { return clause.binary (); }
+  void update_size (int s) { clause.set_binary (s == 2); }
+};
+
+#endif
+
 typedef vector<Watch> Watches; // of one literal
 
 typedef Watches::iterator watch_iterator;
@@ -52,8 +105,8 @@ inline void update_watch_size (Watches &ws, int blit, Clause *conflict) {
   const int size = conflict->size;
   for (Watch &w : ws) {
     if (w.clause == conflict)
-      w.size = size, w.blit = blit, found = true;
-    assert (w.clause->garbage || w.size == 2 || w.clause->size != 2);
+      w.update_size (size), w.blit = blit, found = true;
+    assert (w.clause->garbage || w.binary () || w.clause->size != 2);
   }
   assert (found), (void) found;
 }
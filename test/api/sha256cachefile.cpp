@@ -0,0 +1,132 @@
+#include "../../src/sha256/2_bit.hpp"
+#include "../../src/sha256/cache_file.hpp"
+#include "../../src/sha256/propagate.hpp"
+#include "../../src/sha256/wordwise_propagate.hpp"
+
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace SHA256;
+
+static string path () {
+  const char *prefix = getenv ("CADICALBUILD");
+  string res = prefix ? prefix : ".";
+  res += "/test-api-sha256cachefile.rules";
+  return res;
+}
+
+// The rules of the global caches from the least to the most recently used
+// one, which are put back in that order after the test
+struct Caches {
+  vector<pair<string, pair<string, string>>> prop, wordwise;
+  vector<pair<uint64_t, TwoBitRelations>> two_bit;
+
+  void save () {
+    otf_prop_cache.for_each (
+        [&] (const string &key, const pair<string, string> &value) {
+          prop.push_back ({key, value});
+        });
+    otf_2bit_cache.for_each (
+        [&] (const uint64_t &key, const TwoBitRelations &relations) {
+          two_bit.push_back ({key, relations});
+        });
+    wordwise_propagate_cache.for_each (
+        [&] (const string &key, const pair<string, string> &value) {
+          wordwise.push_back ({key, value});
+        });
+  }
+
+  void restore () {
+    clear ();
+    for (auto &rule : prop)
+      otf_prop_cache.put (rule.first, rule.second);
+    for (auto &rule : two_bit)
+      otf_2bit_cache.put (rule.first, rule.second);
+    for (auto &rule : wordwise)
+      wordwise_propagate_cache.put (rule.first, rule.second);
+  }
+
+  static void clear () {
+    otf_prop_cache.clear ();
+    otf_2bit_cache.clear ();
+    wordwise_propagate_cache.clear ();
+  }
+};
+
+static void put_rules () {
+  otf_prop_cache.put ("x -x? -", {"-xx", "-"});
+  otf_prop_cache.put ("u n? 1", {"un", "1"});
+  TwoBitRelations relations;
+  memset (&relations, 0, sizeof (relations));
+  relations.classes[0] = 1;
+  relations.xors_size = 1;
+  otf_2bit_cache.put (42, relations);
+  wordwise_propagate_cache.put ("+ u-n 0", {"u-n", "0"});
+}
+
+static bool has_rules () {
+  return otf_prop_cache.exists ("x -x? -") &&
+         otf_prop_cache.get ("x -x? -").first == "-xx" &&
+         otf_prop_cache.exists ("u n? 1") && otf_2bit_cache.exists (42) &&
+         otf_2bit_cache.get (42).classes[0] == 1 &&
+         wordwise_propagate_cache.exists ("+ u-n 0") &&
+         wordwise_propagate_cache.get ("+ u-n 0").first == "u-n";
+}
+
+int main () {
+  Caches caches;
+  caches.save ();
+  Caches::clear ();
+  put_rules ();
+  const uint64_t rules = 4;
+
+  remove (path ().c_str ());
+  {
+    CacheFile file (path ());
+    assert (!file.load () && file.loaded == 0);
+    assert (!file.save () && file.saved == rules);
+  }
+  {
+    // All the rules are in the file already
+    CacheFile file (path ());
+    assert (!file.load () && file.loaded == rules);
+    assert (!file.save () && file.saved == 0);
+  }
+  {
+    // The rules are read back into empty caches
+    Caches::clear ();
+    CacheFile file (path ());
+    assert (!file.load () && file.loaded == rules);
+    assert (has_rules ());
+  }
+  {
+    // A torn record is dropped through rewriting the file
+    FILE *torn = fopen (path ().c_str (), "ab");
+    assert (torn);
+    fputs ("\1\2", torn);
+    fclose (torn);
+    CacheFile file (path ());
+    assert (!file.load () && file.loaded == rules);
+    assert (!file.save () && file.saved == rules);
+  }
+  {
+    Caches::clear ();
+    CacheFile file (path ());
+    assert (!file.load () && file.loaded == rules);
+    assert (has_rules ());
+  }
+  remove (path ().c_str ());
+
+  caches.restore ();
+  return 0;
+}
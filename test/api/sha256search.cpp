@@ -0,0 +1,75 @@
+#include "../../src/cadical.hpp"
+#include "../../src/sha256/search.hpp"
+
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace std;
+using namespace CaDiCaL;
+using namespace SHA256;
+
+static string path () {
+  const char *prefix = getenv ("CADICALBUILD");
+  string res = prefix ? prefix : ".";
+  res += "/test-api-sha256search.char";
+  return res;
+}
+
+int main () {
+  // A characteristic without any conditions
+  FILE *file = fopen (path ().c_str (), "w");
+  assert (file);
+  fputs ("# free\n", file);
+  fclose (file);
+
+  Solver *solver = new Solver;
+  solver->set ("quiet", 1);
+  CharacteristicSearch *search = new CharacteristicSearch (solver);
+  const char *err = "";
+  for (string encoding : {"1bit", "4bit"})
+    if (err)
+      err = search->generate (("2," + encoding + "," + path ()).c_str ());
+  remove (path ().c_str ());
+  if (err) {
+    // Only the 1-bit and 4-bit encodings can be generated
+    delete search;
+    delete solver;
+    return 0;
+  }
+
+  int one = search->add_condition (0, 'W', 0, '1');
+  int equal = search->add_condition (-1, 'A', 31, '-');
+  assert (one && equal && one != equal);
+  assert (search->condition (0, 'W', 0, '1') == one);
+  assert (!search->condition (-5, 'A', 0, 'x'));
+  assert (!search->condition (-1, 'W', 0, 'x'));
+  assert (!search->condition (0, 'W', 32, 'x'));
+  assert (!search->condition (0, 'W', 0, 'y'));
+  assert (search->solve () == 10);
+
+  // Contradicting the first condition
+  int zero = search->add_condition (0, 'W', 0, '0');
+  assert (search->solve () == 20);
+  assert (search->failed (one) && search->failed (zero));
+  assert (!search->failed (equal));
+  auto failed = search->failed_conditions ();
+  assert (failed.size () == 2);
+  for (auto &condition : failed)
+    assert (condition.step == 0 && condition.word == 'W' &&
+            condition.bit == 0);
+
+  // Still satisfiable without it
+  search->remove_condition (one);
+  assert (search->solve () == 10);
+  assert (search->describe (one).symbol == '1');
+
+  delete search;
+  delete solver;
+  return 0;
+}
@@ -0,0 +1,59 @@
+#include "../../src/sha256/shared_cache.hpp"
+
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <utility>
+
+using namespace std;
+using namespace SHA256;
+
+int main () {
+  string name = "/test-api-sha256sharedcache-" + to_string (getpid ());
+  const char *err = 0;
+  auto cache = SharedCache::attach (name, 64, err);
+  if (!cache) {
+    // POSIX shared memory is not available everywhere (e.g. in containers
+    // without '/dev/shm')
+    printf ("skipping shared cache test (%s)\n", err);
+    return 0;
+  }
+  {
+    pair<string, string> value;
+    assert (!cache->get ("x -x? -", value));
+    assert (cache->put ("x -x? -", {"-xx", "-"}));
+    assert (cache->get ("x -x? -", value));
+    assert (value == make_pair (string ("-xx"), string ("-")));
+  }
+  {
+    uint64_t value = 0;
+    uint32_t short_value;
+    assert (cache->put (42, &value, sizeof (value)));
+    assert (cache->get (42, &value, sizeof (value)));
+    // The sizes of the values are checked too
+    assert (!cache->get (42, &short_value, sizeof (short_value)));
+    assert (!cache->get (43, &value, sizeof (value)));
+  }
+  // Rules which don't fit are left to the private caches
+  assert (!cache->put (string (SHARED_CACHE_DATA_SIZE, '?'), {"?", ""}));
+
+  // Another process attaching sees the rules, but not the statistics
+  auto other = SharedCache::attach (name, 64, err);
+  assert (other != NULL);
+  pair<string, string> value;
+  assert (other->get ("x -x? -", value) && value.first == "-xx");
+  assert (other->hits == 1 && cache->hits == 2 && cache->stores == 2);
+  // A table of another size can't be attached to
+  assert (SharedCache::attach (name, 32, err) == NULL);
+  delete other;
+  delete cache;
+  shm_unlink (name.c_str ());
+  return 0;
+}
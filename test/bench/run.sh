@@ -0,0 +1,250 @@
+#!/bin/sh
+
+#--------------------------------------------------------------------------#
+
+die () {
+  cecho "${HIDE}test/bench/run.sh:${NORMAL} ${BAD}error:${NORMAL} $*"
+  exit 1
+}
+
+msg () {
+  cecho "${HIDE}test/bench/run.sh:${NORMAL} $*"
+}
+
+for dir in . .. ../..
+do
+  [ -f $dir/scripts/colors.sh ] || continue
+  . $dir/scripts/colors.sh || exit 1
+  break
+done
+
+#--------------------------------------------------------------------------#
+
+[ -d ../test -a -d ../test/bench ] || \
+die "needs to be called from a top-level sub-directory of CaDiCaL"
+
+corpus=../test/bench/sha256
+seeds="1 2 3"
+conflicts=5000
+results=""
+baseline=$corpus/baseline.tsv
+tolerance=10
+update=no
+builds=""
+extra=""
+
+usage () {
+cat <<EOF
+usage: run.sh [ <option> ... ] [ <build> ... ]
+
+where '<option>' is one of the following
+
+  -h             print this command line option summary
+  -s "<seeds>"   seeds of the runs of each instance (default '$seeds')
+  -c <limit>     conflict limit of the runs (default $conflicts)
+  -o <results>   results file (default 'sha256-bench.tsv' in the first build)
+  -b <baseline>  baseline the results are compared to
+                 (default '$baseline')
+  -t <percent>   tolerated increase of the wall clock time
+                 (default $tolerance)
+  -u             store the results as the new baseline
+  -x "<options>" pass these options to every run (e.g., to compare the
+                 propagation loops with '-x "--propbinfirst=1"')
+
+and each '<build>' directory holds a 'cadical' binary compiled with one set
+of techniques (default '\$CADICALBUILD' or '../build').
+EOF
+}
+
+while [ $# -gt 0 ]
+do
+  case "$1" in
+    -h) usage; exit 0;;
+    -s) shift; seeds="$1";;
+    -c) shift; conflicts="$1";;
+    -o) shift; results="$1";;
+    -b) shift; baseline="$1";;
+    -t) shift; tolerance="$1";;
+    -u) update=yes;;
+    -x) shift; extra="$extra $1";;
+    -*) die "invalid option '$1' (try '-h')";;
+    *) builds="$builds $1";;
+  esac
+  shift
+done
+
+if [ x"$builds" = x ]
+then
+  [ x"$CADICALBUILD" = x ] && CADICALBUILD="../build"
+  builds="$CADICALBUILD"
+fi
+
+for build in $builds
+do
+  [ -x "$build/cadical" ] || \
+    die "can not find '$build/cadical' (run 'make' first)"
+  [ x"$results" = x ] && results="$build/sha256-bench.tsv"
+done
+
+cecho -n "$HILITE"
+cecho "---------------------------------------------------------"
+cecho "SHA-256 benchmarking of '`echo $builds $extra`'"
+cecho "---------------------------------------------------------"
+cecho -n "$NORMAL"
+
+#--------------------------------------------------------------------------#
+
+# The encoding and the techniques of a build are found out from the
+# messages of the propagator when generating a single step.
+
+probe () {
+  output="`$1/cadical -q -c 0 --sha256-generate=1,1bit 2>&1`"
+  case "$output" in
+    *"expected '4bit'"*) encoding=4bit;;
+    *"only the 1-bit and 4-bit"*) encoding=li2024;;
+    *) encoding=1bit;;
+  esac
+  techniques=$(echo "$output" | sed -n \
+    -e 's/^Bitsliced propagation turned on.*/bitsliced/p' \
+    -e 's/^Custom blocking turned on.*/blocking/p' \
+    -e 's/^Wordwise propagation.*turned on.*/wordwise/p' \
+    -e 's/^2-bit addition differentials turned on.*/addition/p' \
+    -e 's/^Mendel.s branching turned on.*/mendel/p' \
+    -e 's/^Adaptive propagation strength turned on.*/adaptive/p' \
+    -e 's/^Gauss-Jordan elimination.*turned on.*/xor/p' \
+    -e 's/^Phase set to false.*/phase/p' | tr '\n' '+' | sed -e 's/+$//')
+  [ x"$techniques" = x ] && techniques=none
+  technique="$encoding:$techniques"
+}
+
+# Extract the results of a run from its log as a tab separated line
+
+extract () {
+  awk -v technique="$technique" -v instance="$name" -v seed="$seed" '
+BEGIN { status = "error" }
+/^s SATISFIABLE/ { status = "sat" }
+/^s UNSATISFIABLE/ { status = "unsat" }
+/^c UNKNOWN/ { status = "unknown" }
+/^c conflicts:/ { conflicts = $3; rate = $4 }
+/^c propagations:/ { props = $4 * 1e6 }
+/^c total real time since/ { wall = $(NF-1) }
+/^c total process time since/ { process = $(NF-1) }
+/^c maximum resident set size/ { rss = $(NF-1) }
+/^c total refresh time:/ { refresh = $(NF-1) }
+/^c total prop. time:/ { prop = $(NF-1) }
+/^c total wordwise prop. time:/ { wordwise = $(NF-1) }
+/^c total 2-bit derive time:/ { two_bit = $(NF-1) }
+/^c total mendel branch time:/ { mendel = $(NF-1) }
+/^c total callback time:/ { callback = $(NF-1) }
+END {
+  printf "%s\t%s\t%s\t%s\t%s\t%s\t%d\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t" \
+    "%.0f\n", technique, instance, seed, status, wall + 0, process + 0,
+    conflicts, rate + 0, callback + 0, prop + 0, wordwise + 0, two_bit + 0,
+    mendel + 0, refresh + 0, rss + 0, props + 0
+}' "$1"
+}
+
+#--------------------------------------------------------------------------#
+
+printf "technique\tinstance\tseed\tstatus\twall\tprocess\tconflicts\t" \
+  > $results
+printf "conflicts_per_second\tcallback\tprop\twordwise\ttwo_bit\tmendel\t" \
+  >> $results
+printf "refresh\trss_mb\tpropagations_per_second\n" >> $results
+
+failed=0
+
+for build in $builds
+do
+  probe $build
+  msg "build '$build' uses '$technique'"
+  grep -v '^#' $corpus/corpus | \
+  while read name instance_encoding source characteristic
+  do
+    [ x"$name" = x ] && continue
+    [ $instance_encoding = $encoding ] || continue
+    case "$source" in
+      *[!0-9]*) input="$corpus/$source";;
+      *)
+        input="--sha256-generate=$source,$encoding"
+        [ x"$characteristic" = x ] || \
+          input="$input,$corpus/$characteristic"
+        ;;
+    esac
+    for seed in $seeds
+    do
+      log=$build/sha256-bench-$name-$seed.log
+      printf "%s seed %s ... " $name $seed
+      $build/cadical --seed=$seed -c $conflicts -n $extra $input \
+        > $log 2>&1
+      line="`extract $log`"
+      echo "$line" >> $results
+      echo "$line" | awk -F '\t' '
+{ printf "%s %.2f seconds %d conflicts %.1f MB\n", $4, $5, $7, $15 }'
+    done
+  done
+done
+
+errors="`awk -F '\t' 'NR > 1 && $4 == "error"' $results | wc -l`"
+[ $errors = 0 ] || die "$errors runs failed (see the logs in the builds)"
+msg "results written to '$results'"
+
+#--------------------------------------------------------------------------#
+
+# Compare the mean wall clock time over the seeds of each instance and
+# technique to the baseline.
+
+if [ -f "$baseline" ]
+then
+  msg "comparing to '$baseline' (tolerating $tolerance% slow down)"
+  awk -F '\t' -v tolerance=$tolerance '
+FNR == 1 { next }
+{ key = $1 " " $2 }
+NR == FNR {
+  base_wall[key] += $5; base_rate[key] += $8; base_props[key] += $16
+  base[key]++; next
+}
+{
+  if (!(key in runs)) {
+    keys[++count] = key; technique[key] = $1; instance[key] = $2
+  }
+  wall[key] += $5; rate[key] += $8; props[key] += $16; runs[key]++
+}
+END {
+  regressions = 0
+  for (i = 1; i <= count; i++) {
+    key = keys[i]
+    if (technique[key] != last) print (last = technique[key])
+    if (!(key in base)) {
+      printf "  %-16s no baseline\n", instance[key]
+      continue
+    }
+    old = base_wall[key] / base[key]; new = wall[key] / runs[key]
+    change = old > 0 ? 100 * (new - old) / old : 0
+    rate_change = base_rate[key] > 0 ? \
+      100 * (rate[key] / runs[key] - base_rate[key] / base[key]) / \
+        (base_rate[key] / base[key]) : 0
+    props_change = base_props[key] > 0 ? \
+      100 * (props[key] / runs[key] - base_props[key] / base[key]) / \
+        (base_props[key] / base[key]) : 0
+    verdict = change > tolerance ? "REGRESSION" : "ok"
+    if (change > tolerance) regressions++
+    printf "  %-16s %8.2f -> %8.2f seconds %+7.1f%% " \
+      "(conflicts/second %+7.1f%%, propagations/second %+7.1f%%) %s\n",
+      instance[key], old, new, change, rate_change, props_change, verdict
+  }
+  exit (regressions > 0)
+}' "$baseline" "$results"
+  failed=$?
+else
+  msg "no baseline '$baseline' to compare to (use '-u' to store one)"
+fi
+
+if [ $update = yes ]
+then
+  cp "$results" "$baseline" || die "can not write '$baseline'"
+  msg "stored results as new baseline '$baseline'"
+fi
+
+[ $failed = 0 ] || die "slower than the baseline"
+exit 0
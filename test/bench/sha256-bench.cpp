@@ -0,0 +1,404 @@
+// Microbenchmarks of the SHA-256 propagation kernels.  The kernels are fed
+// with the calls recorded by 'cadical --sha256-record-kernels=<path>' or,
+// without a recording, with the calls made while solving a generated
+// instance for a few conflicts.  See 'README.md' for the usage.
+
+#include "../../src/cadical.hpp"
+#include "../../src/sha256/2_bit.hpp"
+#include "../../src/sha256/2_bit_graph.hpp"
+#include "../../src/sha256/generate.hpp"
+#include "../../src/sha256/kernel_trace.hpp"
+#include "../../src/sha256/lru_cache.hpp"
+#include "../../src/sha256/propagate.hpp"
+#include "../../src/sha256/sha256.hpp"
+#include "../../src/sha256/util.hpp"
+#include "../../src/sha256/wordwise_propagate.hpp"
+
+#include <cfloat>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+using namespace SHA256;
+
+/*------------------------------------------------------------------------*/
+
+// Count the allocations of the whole program (there is a single thread)
+
+static uint64_t allocations = 0;
+
+void *operator new (size_t size) {
+  allocations++;
+  if (void *res = malloc (size ? size : 1))
+    return res;
+  throw bad_alloc ();
+}
+
+// Not inlined, as GCC mistakes 'free' for a mismatch with 'new' otherwise
+__attribute__ ((noinline)) void operator delete (void *ptr) noexcept {
+  free (ptr);
+}
+__attribute__ ((noinline)) void operator delete (void *ptr,
+                                                 size_t) noexcept {
+  free (ptr);
+}
+
+/*------------------------------------------------------------------------*/
+
+struct PropCall {
+  BitFunction function;
+  string inputs, outputs;
+};
+
+struct TwoBitCall {
+  BitFunction function;
+  string inputs, outputs, mask;
+  pair<vector<uint32_t>, vector<uint32_t>> ids;
+};
+
+struct WordwiseCall {
+  vector<string> words;
+  int64_t constant;
+};
+
+struct Workload {
+  vector<PropCall> prop;
+  vector<TwoBitCall> two_bit;
+  vector<WordwiseCall> wordwise;
+  // Variables with a word (only known for generated instances)
+  vector<int> word_vars;
+};
+
+static void die (const char *fmt, const char *arg = "") {
+  fprintf (stderr, "sha256-bench: error: ");
+  fprintf (stderr, fmt, arg);
+  fputc ('\n', stderr);
+  exit (1);
+}
+
+static bool parse_ids (const string &str,
+                       pair<vector<uint32_t>, vector<uint32_t>> &ids) {
+  vector<uint32_t> all;
+  istringstream iss (str);
+  string id;
+  while (getline (iss, id, ','))
+    all.push_back (strtoul (id.c_str (), 0, 10));
+  if (all.size () % 2)
+    return false;
+  ids.first.assign (all.begin (), all.begin () + all.size () / 2);
+  ids.second.assign (all.begin () + all.size () / 2, all.end ());
+  return true;
+}
+
+// Read the calls in the format written by 'KernelTrace'
+static void read_workload (FILE *file, const char *name,
+                           Workload &workload) {
+  char *line = 0;
+  size_t capacity = 0;
+  ssize_t length;
+  while ((length = getline (&line, &capacity, file)) > 0) {
+    istringstream iss (line);
+    string kind, function, ids;
+    iss >> kind;
+    bool ok = true;
+    if (kind == "p") {
+      PropCall call;
+      ok = bool (iss >> function >> call.inputs >> call.outputs);
+      call.function = ok ? tag_function (function[0]) : NULL;
+      if (call.function)
+        workload.prop.push_back (call);
+    } else if (kind == "2") {
+      TwoBitCall call;
+      ok = bool (iss >> function >> call.inputs >> call.outputs >>
+                 call.mask >> ids) &&
+           parse_ids (ids, call.ids);
+      call.function = ok ? tag_function (function[0]) : NULL;
+      if (call.function)
+        workload.two_bit.push_back (call);
+    } else if (kind == "w") {
+      WordwiseCall call;
+      ok = bool (iss >> call.constant);
+      string word;
+      while (iss >> word)
+        call.words.push_back (word);
+      if (ok)
+        workload.wordwise.push_back (call);
+    } else
+      ok = false;
+    if (!ok)
+      die ("invalid line in '%s'", name);
+  }
+  free (line);
+}
+
+// Solve the generated instance for a few conflicts and record the calls
+static void record_workload (const char *spec, int conflicts,
+                             FILE *file, Workload &workload) {
+  CaDiCaL::Solver *solver = new CaDiCaL::Solver;
+  Propagator *propagator = new Propagator (solver);
+  if (const char *err = generate_encoding (solver, spec))
+    die ("%s", err);
+  solver->limit ("conflicts", conflicts);
+  kernel_trace = new KernelTrace (file);
+  solver->solve ();
+  delete kernel_trace;
+  kernel_trace = NULL;
+
+  for (int id = 1; id <= solver->vars (); id++)
+    if (id < MAX_VAR_ID && Propagator::state.vars_info[id].word != NULL)
+      workload.word_vars.push_back (id);
+  delete propagator;
+  delete solver;
+}
+
+/*------------------------------------------------------------------------*/
+
+static int rounds = 3;
+
+// Run the benchmark 'rounds' times and report the fastest round
+template <typename run_t>
+static void measure (const char *name, size_t ops, run_t run) {
+  if (!ops) {
+    printf ("%-34s %10s\n", name, "no calls");
+    return;
+  }
+  double best = DBL_MAX;
+  uint64_t round_allocations = 0;
+  for (int round = 0; round < rounds; round++) {
+    uint64_t allocations_before = allocations;
+    auto start = chrono::steady_clock::now ();
+    run ();
+    chrono::duration<double, nano> elapsed =
+        chrono::steady_clock::now () - start;
+    best = min (best, elapsed.count ());
+    round_allocations = allocations - allocations_before;
+  }
+  printf ("%-34s %10zu ops %12.1f ns/op %10.2f allocs/op\n", name, ops,
+          best / ops, round_allocations / (double) ops);
+  fflush (stdout);
+}
+
+static void bench_propagate (Workload &workload) {
+  auto &calls = workload.prop;
+  measure ("otf_propagate (cold)", calls.size (), [&] () {
+    for (auto &call : calls) {
+      otf_prop_cache.clear ();
+      otf_propagate (call.function, call.inputs, call.outputs);
+    }
+  });
+  otf_prop_cache.clear ();
+  for (auto &call : calls)
+    otf_propagate (call.function, call.inputs, call.outputs);
+  measure ("otf_propagate (cached)", calls.size (), [&] () {
+    for (auto &call : calls)
+      otf_propagate (call.function, call.inputs, call.outputs);
+  });
+}
+
+static void bench_two_bit (Workload &workload) {
+  auto &calls = workload.two_bit;
+  measure ("otf_2bit_eqs (cold)", calls.size (), [&] () {
+    for (auto &call : calls) {
+      otf_2bit_cache.clear ();
+      otf_2bit_eqs (call.function, call.inputs, call.outputs, call.ids,
+                    call.mask);
+    }
+  });
+  otf_2bit_cache.clear ();
+  for (auto &call : calls)
+    otf_2bit_eqs (call.function, call.inputs, call.outputs, call.ids,
+                  call.mask);
+  measure ("otf_2bit_eqs (cached)", calls.size (), [&] () {
+    for (auto &call : calls)
+      otf_2bit_eqs (call.function, call.inputs, call.outputs, call.ids,
+                    call.mask);
+  });
+}
+
+static void bench_wordwise (Workload &workload) {
+  auto &calls = workload.wordwise;
+  measure ("wordwise_propagate", calls.size (), [&] () {
+    for (auto &call : calls)
+      wordwise_propagate (call.words, call.constant);
+  });
+}
+
+// Add the derived equations to a graph (a new one every 'graph_size'
+// equations, as the solver backtracks) and look for inconsistent cycles
+static void bench_graph (Workload &workload) {
+  const size_t graph_size = 4096;
+  vector<Equation> equations;
+  for (auto &call : workload.two_bit)
+    for (auto &equation : otf_2bit_eqs (call.function, call.inputs,
+                                        call.outputs, call.ids, call.mask))
+      equations.push_back (equation);
+
+  vector<int> antecedent = {1};
+  measure ("shortest_inconsistent_cycle", equations.size (), [&] () {
+    TwoBitGraph *graph = NULL;
+    for (size_t i = 0; i < equations.size (); i++) {
+      if (i % graph_size == 0) {
+        delete graph;
+        graph = new TwoBitGraph;
+      }
+      auto &equation = equations[i];
+      vector<vector<int> *> blocking_antecedents;
+      if (!graph->add_edge (equation.ids[0], equation.ids[1],
+                            equation.diff, &antecedent,
+                            &blocking_antecedents))
+        graph->shortest_inconsistent_cycle (
+            equation.ids[0], equation.ids[1], &blocking_antecedents);
+    }
+    delete graph;
+  });
+}
+
+// Refresh the characteristics after assigning and unassigning a few
+// random variables with words, as between two callbacks
+static void bench_soft_refresh (Workload &workload, unsigned seed) {
+  const size_t refreshes = 100000, changes = 8;
+  auto &vars = workload.word_vars;
+  auto &state = Propagator::state;
+  if (vars.empty ()) {
+    measure ("State::soft_refresh", 0, [] () {});
+    return;
+  }
+
+  vector<int> lits;
+  mt19937 random (seed);
+  for (size_t i = 0; i < refreshes * changes; i++) {
+    int lit = vars[random () % vars.size ()];
+    lits.push_back (random () & 1 ? lit : -lit);
+  }
+
+  measure ("State::soft_refresh", refreshes, [&] () {
+    for (size_t i = 0; i < refreshes; i++) {
+      for (size_t j = i * changes; j < (i + 1) * changes; j++)
+        if (state.partial_assignment.get (abs (lits[j])) == LIT_UNDEF)
+          state.partial_assignment.set (lits[j]);
+        else
+          state.partial_assignment.unset (lits[j]);
+      state.soft_refresh ();
+      state.prop_markings_trail.back ().clear ();
+      state.two_bit_markings_trail.back ().clear ();
+    }
+  });
+}
+
+// Replay the propagation cache lookups with the solver's policy of
+// putting the rule after a miss
+static void bench_lru_cache (Workload &workload) {
+  vector<string> keys;
+  unordered_set<string> distinct_keys;
+  for (auto &call : workload.prop) {
+    keys.push_back (string (1, function_tag (call.function)) + " " +
+                    call.inputs + " " + call.outputs);
+    distinct_keys.insert (keys.back ());
+  }
+
+  pair<string, string> value = {"", ""};
+  auto replay = [&] (size_t capacity) {
+    cache::lru_cache<string, pair<string, string>> cache (capacity);
+    for (auto &key : keys)
+      if (cache.exists (key))
+        cache.get (key);
+      else
+        cache.put (key, value);
+  };
+  size_t all = distinct_keys.size (), eighth = max<size_t> (all / 8, 1);
+  measure ("lru_cache (all keys)", keys.size (),
+           [&] () { replay (all); });
+  measure ("lru_cache (1/8 of the keys)", keys.size (),
+           [&] () { replay (eighth); });
+}
+
+/*------------------------------------------------------------------------*/
+
+static const char *usage =
+    "usage: sha256-bench [ <option> ... ] [ <recording> ]\n"
+    "\n"
+    "where '<option>' is one of the following\n"
+    "\n"
+    "  -h             print this command line option summary\n"
+    "  -s <spec>      instance generated without a recording "
+    "(default '%s')\n"
+    "  -c <conflicts> conflicts solved to record the calls (default %d)\n"
+    "  -w <path>      also write the recorded calls to the file\n"
+    "  -r <rounds>    rounds of each benchmark (default %d)\n"
+    "  --seed=<seed>  seed of the random assignments (default %u)\n"
+    "\n"
+    "and '<recording>' is a file written by "
+    "'cadical --sha256-record-kernels=<path>'.\n";
+
+int main (int argc, char **argv) {
+  const char *spec = IS_4BIT ? "16,4bit" : "16,1bit";
+  const char *recording = 0, *write_path = 0;
+  int conflicts = 5000;
+  unsigned seed = 0;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp (argv[i], "-h")) {
+      printf (usage, spec, conflicts, rounds, seed);
+      return 0;
+    } else if (!strcmp (argv[i], "-s") && i + 1 < argc)
+      spec = argv[++i];
+    else if (!strcmp (argv[i], "-c") && i + 1 < argc)
+      conflicts = atoi (argv[++i]);
+    else if (!strcmp (argv[i], "-w") && i + 1 < argc)
+      write_path = argv[++i];
+    else if (!strcmp (argv[i], "-r") && i + 1 < argc) {
+      if ((rounds = atoi (argv[++i])) < 1)
+        die ("invalid number of rounds '%s'", argv[i]);
+    } else if (!strncmp (argv[i], "--seed=", 7))
+      seed = strtoul (argv[i] + 7, 0, 10);
+    else if (argv[i][0] == '-')
+      die ("invalid option '%s' (try '-h')", argv[i]);
+    else if (recording)
+      die ("too many arguments");
+    else
+      recording = argv[i];
+  }
+
+  Workload workload;
+  if (recording) {
+    FILE *file = fopen (recording, "r");
+    if (!file)
+      die ("can not read '%s'", recording);
+    read_workload (file, recording, workload);
+    fclose (file);
+  } else {
+    if (IS_LI2024)
+      die ("instances can't be generated for this encoding%s",
+           " (replay a recording)");
+    FILE *file = write_path ? fopen (write_path, "w+") : tmpfile ();
+    if (!file)
+      die ("can not write '%s'", write_path ? write_path : "<tmp>");
+    record_workload (spec, conflicts, file, workload);
+    rewind (file);
+    read_workload (file, write_path ? write_path : "<tmp>", workload);
+    fclose (file);
+    // The recorded rules would make the cold runs warm
+    otf_prop_cache.clear ();
+    otf_2bit_cache.clear ();
+  }
+
+  printf ("replaying %zu propagation, %zu 2-bit and %zu wordwise calls\n",
+          workload.prop.size (), workload.two_bit.size (),
+          workload.wordwise.size ());
+  bench_propagate (workload);
+  bench_two_bit (workload);
+  bench_wordwise (workload);
+  bench_graph (workload);
+  bench_soft_refresh (workload, seed);
+  bench_lru_cache (workload);
+  return 0;
+}
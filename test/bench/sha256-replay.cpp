@@ -0,0 +1,95 @@
+// Replays the callbacks recorded by 'cadical --sha256-record-callbacks'
+// to the SHA-256 propagator alone, checking that it returns the same
+// results and timing it by callback.  See 'README.md' for the usage.
+
+#include "../../src/cadical.hpp"
+#include "../../src/sha256/callback_trace.hpp"
+#include "../../src/sha256/generate.hpp"
+#include "../../src/sha256/sha256.hpp"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+using namespace SHA256;
+
+static const char *usage =
+    "usage: sha256-replay [ -s <spec> | <input> ] <trace>\n"
+    "\n"
+    "where '<input>' is the DIMACS file and '-s <spec>' the\n"
+    "'--sha256-generate' specification of the instance the callbacks in\n"
+    "'<trace>' were recorded with.\n";
+
+static void die (const char *fmt, const char *arg = "") {
+  fprintf (stderr, "sha256-replay: error: ");
+  fprintf (stderr, fmt, arg);
+  fputc ('\n', stderr);
+  exit (1);
+}
+
+int main (int argc, char **argv) {
+  const char *spec = 0, *paths[2] = {0, 0};
+  int paths_count = 0;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp (argv[i], "-h")) {
+      fputs (usage, stdout);
+      return 0;
+    } else if (!strcmp (argv[i], "-s") && i + 1 < argc)
+      spec = argv[++i];
+    else if (argv[i][0] == '-')
+      die ("invalid option '%s' (try '-h')", argv[i]);
+    else if (paths_count == 2)
+      die ("too many arguments");
+    else
+      paths[paths_count++] = argv[i];
+  }
+  if (paths_count != (spec ? 1 : 2))
+    die ("expected an instance and a trace (try '-h')");
+  const char *input = spec ? 0 : paths[0];
+  const char *trace = paths[paths_count - 1];
+
+  // Set up the propagator as the solver did, but never solve
+  CaDiCaL::Solver *solver = new CaDiCaL::Solver;
+  Propagator *propagator = new Propagator (solver);
+  const char *err;
+  if (spec)
+    err = generate_encoding (solver, spec);
+  else {
+    int vars;
+    err = solver->read_dimacs (input, vars);
+  }
+  if (err)
+    die ("%s", err);
+
+  FILE *file = fopen (trace, "rb");
+  if (!file)
+    die ("can not read '%s'", trace);
+  CallbackReplay replay;
+  err = replay.read (file);
+  fclose (file);
+  if (err)
+    die ("%s", err);
+
+  err = replay.replay (propagator);
+  double total = 0;
+  printf ("%-28s %12s %12s %10s\n", "callback", "calls", "seconds",
+          "ns/call");
+  for (int event = 1; event < event_kinds; event++) {
+    uint64_t count = replay.counts[event];
+    double seconds = replay.seconds[event];
+    total += seconds;
+    printf ("%-28s %12" PRIu64 " %12.3f %10.1f\n",
+            callback_event_names[event], count, seconds,
+            count ? seconds * 1e9 / count : 0);
+  }
+  printf ("%-28s %12" PRIu64 " %12.3f\n", "total", replay.events, total);
+  if (err)
+    die ("%s", err);
+  printf ("all %" PRIu64 " results match the trace\n", replay.events);
+
+  delete propagator;
+  delete solver;
+  return 0;
+}
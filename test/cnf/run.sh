@@ -306,6 +306,341 @@ run prime65537 20
 
 #--------------------------------------------------------------------------#
 
+# Run the command given after the expected exit code with its output going
+# to '$log' and '$err' and count it as passed test if the exit code matches.
+
+check () {
+  expected=$1
+  shift
+  cecho "$*"
+  cecho -n "# $expected ..."
+  "$@" 1>$log 2>$err
+  res=$?
+  if [ $res = $expected ]
+  then
+    cecho " ${GOOD}ok${NORMAL} (exit code as expected)"
+    ok=`expr $ok + 1`
+    return 0
+  fi
+  cecho " ${BAD}FAILED${NORMAL} (actual exit code $res)"
+  failed=`expr $failed + 1`
+  return 1
+}
+
+#--------------------------------------------------------------------------#
+
+# Binary LRAT proofs are checked with the stand alone checker 'lratcheck',
+# which also has to reject the proof after overwriting a byte at the given
+# offset and after cutting it off there (the empty clause is missing).
+
+lratchecker=$CADICALBUILD/lratcheck
+
+lrat () {
+  msg "running LRAT test ${HILITE}'$1'${NORMAL}"
+  prefix=$CADICALBUILD/test-cnf-lrat-$1
+  cnf=../test/cnf/$1.cnf
+  prf=$prefix.lrat
+  log=$prefix.log
+  err=$prefix.err
+  check 20 $coresolver -q --lrat --binary=1 $cnf $prf || return
+  log=$prefix.chk
+  check 0 $lratchecker -q $cnf $prf || return
+  [ x"$2" = x ] && return
+  cp $prf $prefix-tampered.lrat
+  printf '\377' | \
+  dd of=$prefix-tampered.lrat bs=1 seek=$2 conv=notrunc 2>/dev/null
+  log=$prefix-tampered.chk
+  check 1 $lratchecker -q $cnf $prefix-tampered.lrat
+  head -c $2 $prf > $prefix-truncated.lrat
+  log=$prefix-truncated.chk
+  check 1 $lratchecker -q $cnf $prefix-truncated.lrat
+}
+
+if [ -x $lratchecker ]
+then
+  lrat false
+  lrat unit7
+  lrat ph5 100
+  lrat add16 1000
+  lrat prime65537
+else
+  msg "no LRAT proof checking (can not find '$lratchecker')"
+fi
+
+#--------------------------------------------------------------------------#
+
+# Proofs written in the background ('--proofqueue') have to be the same as
+# the ones written directly, in all formats and also if the solver stops
+# early at a conflict limit after filling the queue several times.
+
+queue () {
+  name=$1
+  cnf=../test/cnf/$1.cnf
+  result=$2
+  shift
+  shift
+  for format in drat binary-drat lrat binary-lrat
+  do
+    case $format in
+      drat) opts="--binary=0"; checker=$proofchecker;;
+      binary-drat) opts="--binary=1"; checker=$proofchecker;;
+      lrat) opts="--lrat --binary=0"; checker=none;;
+      binary-lrat) opts="--lrat --binary=1"; checker=$lratchecker;;
+    esac
+    msg "running proof queue test ${HILITE}'$name-$format'${NORMAL}"
+    prefix=$CADICALBUILD/test-cnf-queue-$name-$format
+    log=$prefix.log
+    err=$prefix.err
+    check $result $coresolver -q $opts $* $cnf $prefix.prf || continue
+    log=$prefix-queue.log
+    err=$prefix-queue.err
+    check $result $coresolver -q $opts --proofqueue $* \
+      $cnf $prefix-queue.prf || continue
+    cecho "cmp $prefix.prf $prefix-queue.prf"
+    cecho -n "# 0 ..."
+    if cmp $prefix.prf $prefix-queue.prf 1>&2
+    then
+      cecho " ${GOOD}ok${NORMAL} (same proof)"
+      ok=`expr $ok + 1`
+    else
+      cecho " ${BAD}FAILED${NORMAL} (proofs differ)"
+      failed=`expr $failed + 1`
+      continue
+    fi
+    [ $result = 20 -a -x "$checker" ] || continue
+    log=$prefix-queue.chk
+    check 0 $checker $cnf $prefix-queue.prf
+  done
+}
+
+queue ph6 20
+queue add128 20
+queue prime4294967297 0 -c 10000 --proofqueuesize=1
+
+#--------------------------------------------------------------------------#
+
+# Parsing the clauses of mapped files in parallel ('--parsemap') is forced
+# with tiny chunks.  It has to produce the same output as sequential
+# parsing, including the error messages with the line of the error.
+
+parsemap () {
+  msg "running parse test ${HILITE}'$1'${NORMAL}"
+  prefix=$CADICALBUILD/test-cnf-parsemap-$1
+  cnf=../test/cnf/$1.cnf
+  log=$prefix-sequential.log
+  err=$prefix-sequential.err
+  check $2 $coresolver -q --parsemap=0 $cnf || return
+  log=$prefix.log
+  err=$prefix.err
+  check $2 $coresolver -q --parsemapchunk=1 --parsemapthreads=8 $cnf || \
+    return
+  cecho "cmp $prefix-sequential.log $log"
+  cecho "cmp $prefix-sequential.err $err"
+  cecho -n "# 0 ..."
+  if cmp $prefix-sequential.log $log 1>&2 && \
+     cmp $prefix-sequential.err $err 1>&2
+  then
+    cecho " ${GOOD}ok${NORMAL} (same output)"
+    ok=`expr $ok + 1`
+  else
+    cecho " ${BAD}FAILED${NORMAL} (different output)"
+    failed=`expr $failed + 1`
+    return
+  fi
+  [ x"$3" = x ] && return
+  cecho "grep '$cnf:$3' $err"
+  cecho -n "# 0 ..."
+  if grep -q "$cnf:$3" $err
+  then
+    cecho " ${GOOD}ok${NORMAL} (error at expected line)"
+    ok=`expr $ok + 1`
+  else
+    cecho " ${BAD}FAILED${NORMAL} (error not at expected line)"
+    failed=`expr $failed + 1`
+  fi
+}
+
+parsemap sat10 10
+parsemap prime2209 10
+parsemap ph5 20
+parsemap add32 20
+parsemap parsemap-error 1 "14: parse error: expected digit or '-'"
+parsemap parsemap-clauses 1 "16: parse error: too many clauses"
+
+#--------------------------------------------------------------------------#
+
+# Compressed inputs are decompressed in the process (if compiled with the
+# library) or by an external decompressor and have to produce the same
+# output as the uncompressed formula.  The truncated files miss the last
+# four bytes of the compressed stream (the decompressed formula is still
+# complete) and have to be rejected instead of being read partially.
+
+compressed () {
+  msg "running compressed input test ${HILITE}'$1.cnf.$2'${NORMAL}"
+  if [ x"`$coresolver --build 2>/dev/null|grep HAVE_$3`" = x -a \
+       x"`command -v $4`" = x ]
+  then
+    msg "skipping test (neither compiled with '$3' nor found '$4')"
+    return
+  fi
+  prefix=$CADICALBUILD/test-cnf-compressed-$1-$2
+  log=$prefix-uncompressed.log
+  err=$prefix-uncompressed.err
+  check $5 $coresolver -q ../test/cnf/$1.cnf || return
+  log=$prefix.log
+  err=$prefix.err
+  check $5 $coresolver -q ../test/cnf/$1.cnf.$2 || return
+  cecho "cmp $prefix-uncompressed.log $log"
+  cecho -n "# 0 ..."
+  if cmp $prefix-uncompressed.log $log 1>&2
+  then
+    cecho " ${GOOD}ok${NORMAL} (same output)"
+    ok=`expr $ok + 1`
+  else
+    cecho " ${BAD}FAILED${NORMAL} (different output)"
+    failed=`expr $failed + 1`
+  fi
+  log=$prefix-truncated.log
+  err=$prefix-truncated.err
+  check 1 $coresolver -q ../test/cnf/$1-truncated.cnf.$2 || return
+  cecho "grep 'truncated or corrupted' $err"
+  cecho -n "# 0 ..."
+  if grep -q "truncated or corrupted" $err
+  then
+    cecho " ${GOOD}ok${NORMAL} (read error)"
+    ok=`expr $ok + 1`
+  else
+    cecho " ${BAD}FAILED${NORMAL} (no read error)"
+    failed=`expr $failed + 1`
+  fi
+}
+
+compressed add16 gz ZLIB gzip 20
+compressed prime121 xz LZMA xz 10
+compressed ph5 zst ZSTD zstd 20
+
+#--------------------------------------------------------------------------#
+
+# The clauses of the SHA-256 propagator derived from the original clauses
+# ('--proofexternal') are added to the LRAT proof with their proof chains,
+# which are checked by the internal LRAT checker ('--check').  The encoding
+# is generated, unless the build does not support generating it.  Note that
+# the propagator only adds clauses with the propagation and blocking
+# features enabled in '../src/sha256/types.hpp'.
+
+msg "running SHA-256 LRAT test ${HILITE}'sha256-4-1bit'${NORMAL}"
+prefix=$CADICALBUILD/test-cnf-sha256-4-1bit
+log=$prefix.log
+err=$prefix.err
+if $coresolver -q -c 0 --sha256-generate=1,1bit 2>/dev/null | \
+   grep -q '^Generated'
+then
+  check 20 $coresolver -q --sha256-generate=4,1bit \
+    --lrat --proofexternal --check $prefix.lrat
+else
+  msg "skipping test (can not generate 1-bit encoding)"
+fi
+
+#--------------------------------------------------------------------------#
+
+# A run interrupted by the conflict limit leaves a checkpoint, which
+# includes the rule caches ('.rules') also for DIMACS input, and resuming
+# from it reaches the same result as an uninterrupted run.  Resuming a
+# checkpoint on another formula with the same number of variables (here
+# one literal flipped) is rejected.
+
+msg "running checkpoint test ${HILITE}'prime65537'${NORMAL}"
+prefix=$CADICALBUILD/test-cnf-checkpoint-prime65537
+log=$prefix.log
+err=$prefix.err
+cnf=../test/cnf/prime65537.cnf
+checkpoint=$prefix.ckp
+rm -f $checkpoint $checkpoint.rules
+check 0 $coresolver -q -c 1000 \
+  --checkpoint=$checkpoint --checkpoint-interval=200 $cnf
+cecho "ls $checkpoint $checkpoint.rules"
+cecho -n "# 0 ..."
+if [ -f $checkpoint -a -f $checkpoint.rules ]
+then
+  cecho " ${GOOD}ok${NORMAL} (checkpoint with rules written)"
+  ok=`expr $ok + 1`
+  check 20 $coresolver -q --checkpoint=$checkpoint --resume $cnf
+  other=$prefix-other.cnf
+  awk '/^-1950 0$/ { $1 = 1950 } { print }' $cnf > $other
+  if check 1 $coresolver -q --checkpoint=$checkpoint --resume $other
+  then
+    cecho "grep 'written for another formula' $err"
+    cecho -n "# 0 ..."
+    if grep -q "written for another formula" $err
+    then
+      cecho " ${GOOD}ok${NORMAL} (other formula rejected)"
+      ok=`expr $ok + 1`
+    else
+      cecho " ${BAD}FAILED${NORMAL} (unexpected error)"
+      failed=`expr $failed + 1`
+    fi
+  fi
+else
+  cecho " ${BAD}FAILED${NORMAL} (checkpoint or rules missing)"
+  failed=`expr $failed + 1`
+fi
+
+#--------------------------------------------------------------------------#
+
+# Every report line is also written as a JSON object ('--report-json' and
+# '--report-json-fd').  Each line is checked to be valid JSON with the
+# search and SHA-256 statistics fields, which needs 'python3'.
+
+jsonchecker='
+import json, sys
+search = ["type", "seconds", "conflicts", "decisions", "propagations",
+          "MB", "max_MB", "level", "restarts", "redundant", "irredundant",
+          "variables", "stable", "sha256"]
+sha256 = ["reasons", "clauses", "decisions", "prop_cache_hit_rate",
+          "two_bit_cache_hit_rate", "callback_seconds"]
+lines = 0
+for line in open (sys.argv[1]):
+  report = json.loads (line)
+  assert all (field in report for field in search), line
+  assert all (field in report["sha256"] for field in sha256), line
+  lines += 1
+assert lines > 0
+'
+
+report () {
+  msg "running JSON report test ${HILITE}'$1'${NORMAL}"
+  prefix=$CADICALBUILD/test-cnf-report-$1
+  log=$prefix.log
+  err=$prefix.err
+  cnf=../test/cnf/$1.cnf
+  rm -f $prefix.json $prefix-fd.json
+  check $2 $coresolver -q --report-json=$prefix.json $cnf || return
+  check $2 $coresolver -q --report-json-fd=3 $cnf 3>$prefix-fd.json || return
+  for json in $prefix.json $prefix-fd.json
+  do
+    cecho "python3 -c '...' $json"
+    cecho -n "# 0 ..."
+    if python3 -c "$jsonchecker" $json 1>&2
+    then
+      cecho " ${GOOD}ok${NORMAL} (valid JSON report lines)"
+      ok=`expr $ok + 1`
+    else
+      cecho " ${BAD}FAILED${NORMAL} (invalid JSON report lines)"
+      failed=`expr $failed + 1`
+    fi
+  done
+}
+
+if python3 -c '' 2>/dev/null
+then
+  report ph5 20
+  report prime2209 10
+else
+  msg "skipping JSON report tests ('python3' not found)"
+fi
+
+#--------------------------------------------------------------------------#
+
 [ $ok -gt 0 ] && OK="$GOOD"
 [ $failed -gt 0 ] && FAILED="$BAD"
 
@@ -0,0 +1,84 @@
+#!/bin/sh
+
+#--------------------------------------------------------------------------#
+
+die () {
+  cecho "${HIDE}test/compact/run.sh:${NORMAL} ${BAD}error:${NORMAL} $*"
+  exit 1
+}
+
+msg () {
+  cecho "${HIDE}test/compact/run.sh:${NORMAL} $*"
+}
+
+for dir in . .. ../..
+do
+  [ -f $dir/scripts/colors.sh ] || continue
+  . $dir/scripts/colors.sh || exit 1
+  break
+done
+
+#--------------------------------------------------------------------------#
+
+[ -d ../test -a -d ../test/compact ] || \
+die "needs to be called from a top-level sub-directory of CaDiCaL"
+
+[ x"$CADICALBUILD" = x ] && CADICALBUILD="../build"
+
+[ -f "$CADICALBUILD/makefile" ] || \
+  die "can not find '$CADICALBUILD/makefile' (run 'configure' first)"
+
+# The compact build uses the configuration of the given build with
+# '-DCOMPACT' added (as 'configure --compact' does) and resides next to it
+# in the '-compact' sub-directory, without touching the '../makefile' proxy
+# of the given build.
+
+case x"$CADICALBUILD" in
+  x*-compact) compact="$CADICALBUILD";;
+  *) compact="$CADICALBUILD-compact";;
+esac
+
+cecho -n "$HILITE"
+cecho "---------------------------------------------------------"
+cecho "Compact testing in '$compact'"
+cecho "---------------------------------------------------------"
+cecho -n "$NORMAL"
+
+mkdir -p $compact/sha256/1_bit $compact/sha256/4_bit $compact/sha256/li2024 || \
+  die "failed to generate '$compact'"
+
+sed -e '/^CXXFLAGS=/{/-DCOMPACT/!s,$, -DCOMPACT,}' \
+  "$CADICALBUILD/makefile" > "$compact/makefile.tmp" || \
+  die "failed to generate '$compact/makefile'"
+
+# Only replace the 'makefile' if it changed to avoid rebuilding everything.
+
+if cmp -s "$compact/makefile.tmp" "$compact/makefile"
+then
+  rm -f "$compact/makefile.tmp"
+else
+  mv "$compact/makefile.tmp" "$compact/makefile"
+  msg "generated '$compact/makefile' from '$CADICALBUILD/makefile'"
+fi
+
+make -C $compact
+res=$?
+[ $res = 0 ] || exit $res
+
+#--------------------------------------------------------------------------#
+
+# Run the API and CNF regression suites with the compact build.
+
+failed=0
+
+CADICALBUILD=$compact api/run.sh || failed=`expr $failed + 1`
+CADICALBUILD=$compact cnf/run.sh || failed=`expr $failed + 1`
+
+if [ $failed = 0 ]
+then
+  msg "${GOOD}all compact test suites succeeded${NORMAL}"
+else
+  msg "${BAD}$failed compact test suites failed${NORMAL}"
+fi
+
+exit $failed
@@ -0,0 +1,699 @@
+// Model based differential testing of the SHA-256 propagator.  Reduced-step
+// instances with random partial characteristics are solved with random
+// options and random decisions, while every propagation, reason and
+// blocking clause of the propagator is checked against a slow reference:
+// the uncached 'enumerate_propagate' on the operations of the propagated
+// variable, and a second solver with the plain encoding for what that
+// can't show.  See 'README.md' for the usage.
+
+#include "../../src/cadical.hpp"
+#include "../../src/sha256/generate.hpp"
+#include "../../src/sha256/1_bit/state.hpp"
+#include "../../src/sha256/4_bit/state.hpp"
+#include "../../src/sha256/propagate.hpp"
+#include "../../src/sha256/sha256.hpp"
+#include "../../src/sha256/util.hpp"
+
+#include <cinttypes>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+using namespace SHA256;
+
+static const char *usage =
+    "usage: sha256-mbt [ <option> ... ] [ <seed> ]\n"
+    "\n"
+    "where '<option>' is one of the following\n"
+    "\n"
+    "  -h            print this command line option summary\n"
+    "  -v            show the output of the solver and the propagator\n"
+    "  -n <cases>    number of test cases (default 100)\n"
+    "  -m <steps>    maximum number of steps of an instance (default 3)\n"
+    "  -c <limit>    conflict limit of a test case (default 300)\n"
+    "  -k <limit>    conflict limit of checking a clause with the\n"
+    "                encoding (default 1000)\n"
+    "  --complete    count the propagations missed before decisions\n"
+    "                (slow and only without adaptive propagation)\n"
+    "\n"
+    "The test cases use the seeds from '<seed>' on (random by default).\n"
+    "With a '<seed>' but without '-n' only that test case is run.\n";
+
+static void die (const char *fmt, ...) {
+  va_list ap;
+  va_start (ap, fmt);
+  fprintf (stderr, "sha256-mbt: error: ");
+  vfprintf (stderr, fmt, ap);
+  fputc ('\n', stderr);
+  va_end (ap);
+  exit (1);
+}
+
+static struct {
+  int cases = 100;
+  int steps = 3;
+  int conflicts = 300;
+  int encoding_conflicts = 1000;
+  bool complete = false;
+  bool verbose = false;
+} opts;
+
+// Shared with the forked test cases, which each run with a fresh
+// propagator (its state is static)
+struct Counters {
+  uint64_t propagations;
+  uint64_t reasons_by_enumeration;
+  uint64_t clauses_by_encoding;
+  uint64_t clauses_inconclusive;
+  uint64_t blocking_clauses;
+  uint64_t decisions;
+  uint64_t random_decisions;
+  uint64_t missed_propagations;
+};
+
+static Counters *counters;
+
+/*------------------------------------------------------------------------*/
+
+#if IS_1BIT || IS_4BIT
+// Operations as the bitsliced propagation sees them
+static const pair<int, int> op_sizes[NUM_OPS] = {
+    {3, 1}, {3, 1}, {3, 1}, {3, 1}, {3, 1},
+    {3, 1}, {6, 3}, {5, 3}, {3, 3}, {7, 3}};
+static const BitFunction op_functions[NUM_OPS] = {
+    xor_, xor_, xor_, xor_, maj_, ch_, add_, add_, add_, add_};
+
+typedef tuple<OperationId, int, int> Operation;
+typedef function<int (int)> Values;
+
+// A bit of a word in an operation
+struct Bit {
+  vector<int> vars;
+  // Shifted in or out of the word
+  bool zero;
+};
+
+template <class word_t> static Bit get_bit (const word_t &word, int pos) {
+  Bit bit;
+#if IS_4BIT
+  int base = word.char_ids[pos];
+  bit.vars = {base, base + 1, base + 2, base + 3};
+#else
+  bit.vars = {int (word.ids_f[pos]), int (word.ids_g[pos]),
+              int (word.char_ids[pos])};
+#endif
+  bit.zero = word.ids_f[pos] == Propagator::state.zero_var_id;
+  return bit;
+}
+
+// Value of the k-th variable of a bit with the value pair of 'symbol'
+static bool symbol_value (char symbol, int k) {
+#if IS_4BIT
+  // One variable for each of the pairs 00, 10, 01 and 11
+  return symbol == "0un1"[k];
+#else
+  // The values of both blocks and their difference
+  if (k == 0)
+    return symbol == 'u' || symbol == '1';
+  if (k == 1)
+    return symbol == 'n' || symbol == '1';
+  return symbol == 'u' || symbol == 'n';
+#endif
+}
+
+// Characteristic of a bit with the value pairs the assigned variables
+// allow, which is '#' if there are none
+static char bit_char (const vector<int> &vars, const Values &value) {
+  set<char> symbols;
+  for (char symbol : {'u', 'n', '1', '0'}) {
+    bool allowed = true;
+    for (size_t k = 0; allowed && k < vars.size (); k++)
+      if (int v = value (vars[k]))
+        allowed = symbol_value (symbol, k) == (v > 0);
+    if (allowed)
+      symbols.insert (symbol);
+  }
+  return get_symbol (symbols);
+}
+
+// Symbol of a bit as the propagator sees it, which in the 1-bit encoding
+// is unknown until the difference is assigned
+static char propagator_char (const vector<int> &vars, const Values &value) {
+  uint8_t values[4];
+  for (size_t k = 0; k < vars.size (); k++) {
+    int v = value (vars[k]);
+    values[k] = v > 0 ? LIT_TRUE : v < 0 ? LIT_FALSE : LIT_UNDEF;
+  }
+  char c;
+#if IS_4BIT
+  refresh_4bit_char (values, c);
+#else
+  refresh_1bit_char (values[0], values[1], values[2], c);
+#endif
+  return c;
+}
+
+// The slow reference propagation, which enumerates the values allowed by
+// the characteristics of an operation at a bit without any of the caches
+class Reference {
+  map<string, pair<string, string>> results;
+
+public:
+  // The input and then the output bits of the operation
+  static vector<Bit> bits (const Operation &operation) {
+    OperationId op_id = get<0> (operation);
+    int step = get<1> (operation), pos = get<2> (operation);
+    auto &operations = Propagator::state.operations[step];
+    auto &inputs = operations.inputs_by_op_id[op_id];
+    auto &outputs = operations.outputs_by_op_id[op_id];
+    vector<Bit> bits;
+    for (int i = 0; i < op_sizes[op_id].first; i++)
+      bits.push_back (get_bit (inputs[i], pos));
+    for (int i = 0; i < op_sizes[op_id].second; i++)
+      bits.push_back (get_bit (*outputs[i], pos));
+    return bits;
+  }
+
+  // Literals of unassigned variables the operation implies under the
+  // values. Returns true on a conflict instead. With 'filtered' set, only
+  // what the bitsliced propagation is meant to derive is derived, which
+  // skips unlikely differentials, unknown inputs, shifted in zeros and the
+  // high carry of less than four addends.
+  bool derive (const Operation &operation, const Values &value,
+               vector<int> &lits, bool filtered) {
+    OperationId op_id = get<0> (operation);
+    int inputs_size = op_sizes[op_id].first;
+    int outputs_size = op_sizes[op_id].second;
+    BitFunction function = op_functions[op_id];
+
+    auto bits = this->bits (operation);
+    string inputs, outputs;
+    for (int i = 0; i < inputs_size + outputs_size; i++)
+      (i < inputs_size ? inputs : outputs) +=
+          filtered ? propagator_char (bits[i].vars, value)
+                   : bit_char (bits[i].vars, value);
+    if ((inputs + outputs).find ('#') != string::npos)
+      return true;
+
+    vector<bool> skipped (bits.size ());
+    if (filtered) {
+      int q_count = 0;
+      for (auto &c : inputs + outputs)
+        q_count += c == '?';
+      if ((function != add_ && q_count == 0) ||
+          q_count == inputs_size + outputs_size)
+        return false;
+
+      int zeros = 0;
+      bool known_input = false;
+      for (int i = 0; i < inputs_size; i++) {
+        zeros += bits[i].zero;
+        known_input |= !bits[i].zero && inputs[i] != '?';
+        skipped[i] = bits[i].zero || inputs[i] == '?';
+      }
+      if (!known_input)
+        return false;
+      for (int i = inputs_size; i < inputs_size + outputs_size; i++)
+        skipped[i] = bits[i].zero;
+      if (function == add_ && inputs_size - zeros < 4)
+        skipped[inputs_size] = true;
+    }
+
+    string key = function_tag (function) + inputs + " " + outputs;
+    auto it = results.find (key);
+    if (it == results.end ()) {
+      auto result = enumerate_propagate (function, inputs, outputs);
+      it = results.emplace (key, result).first;
+    }
+    string derived = it->second.first + it->second.second;
+    if (derived.find ('#') != string::npos)
+      return true;
+
+    for (size_t i = 0; i < derived.size (); i++) {
+      if (skipped[i])
+        continue;
+      auto symbols = get_symbols (derived[i]);
+      for (size_t k = 0; k < bits[i].vars.size (); k++) {
+        int var = bits[i].vars[k];
+        if (value (var))
+          continue;
+        int votes = 0;
+        for (auto &symbol : symbols)
+          votes += symbol_value (symbol, k) ? 1 : -1;
+        if (abs (votes) == int (symbols.size ()))
+          lits.push_back (votes > 0 ? var : -var);
+      }
+    }
+    return false;
+  }
+};
+
+/*------------------------------------------------------------------------*/
+
+// Connected to the solver instead of the propagator, forwarding the
+// callbacks to it and checking its results, and making random decisions
+class Checker : public CaDiCaL::ExternalPropagator {
+  CaDiCaL::ExternalPropagator *propagator;
+  mt19937_64 &random;
+  double decide_probability;
+  // The solver with only the encoding to check clauses with
+  CaDiCaL::Solver *encoding = 0;
+  Reference reference;
+
+  // The assignment of the observed variables (by level)
+  vector<int8_t> values;
+  vector<bool> fixed;
+  vector<vector<int>> trail = {{}};
+
+  vector<int> word_vars;
+  // Indexed here, as the state only lists the operations a variable is
+  // an input of
+  vector<Operation> operations;
+  unordered_map<int, vector<Operation>> operations_by_var;
+  // Reasons are taken from the propagator as soon as it propagates, to
+  // check them even if the solver never asks for them
+  unordered_map<int, pair<vector<int>, size_t>> reasons;
+  vector<int> clause;
+
+  int value (int lit) const {
+    int v = values[abs (lit)];
+    return lit < 0 ? -v : v;
+  }
+
+  void fail (const char *fmt, ...) {
+    fflush (stdout);
+    va_list ap;
+    va_start (ap, fmt);
+    fprintf (stderr, "sha256-mbt: error: ");
+    vfprintf (stderr, fmt, ap);
+    fprintf (stderr, " (at decision level %zu)\n", trail.size () - 1);
+    va_end (ap);
+    _exit (1);
+  }
+
+  static string to_string (const vector<int> &lits) {
+    string res;
+    for (auto &lit : lits)
+      res += std::to_string (lit) + " ";
+    return res + "0";
+  }
+
+  // Check that the clause is implied by the encoding alone
+  void check_by_encoding (const vector<int> &lits, const char *what) {
+    for (auto &lit : lits)
+      encoding->assume (-lit);
+    encoding->limit ("conflicts", opts.encoding_conflicts);
+    int res = encoding->solve ();
+    if (res == 10)
+      fail ("%s '%s' is not implied by the encoding", what,
+            to_string (lits).c_str ());
+    if (res == 20)
+      counters->clauses_by_encoding++;
+    else
+      counters->clauses_inconclusive++;
+  }
+
+  void check_clause (const vector<int> &lits, const char *what) {
+    set<int> vars;
+    for (auto &lit : lits)
+      if (!vars.insert (abs (lit)).second)
+        fail ("%s '%s' has variable %d twice", what,
+              to_string (lits).c_str (), abs (lit));
+  }
+
+  void check_reason (int lit, const vector<int> &lits) {
+    if (lits.empty ())
+      fail ("propagation of %d without a reason", lit);
+    check_clause (lits, "reason");
+    if (find (lits.begin (), lits.end (), lit) == lits.end ())
+      fail ("reason '%s' misses the propagated %d",
+            to_string (lits).c_str (), lit);
+    if (value (lit))
+      fail ("propagated %d is assigned", lit);
+
+    // The reference must derive the literal from the reason alone (and
+    // the root-level units)
+    unordered_map<int, int> antecedent;
+    for (auto &other : lits) {
+      if (other == lit)
+        continue;
+      if (value (other) >= 0)
+        fail ("literal %d of the reason '%s' of %d is not falsified", other,
+              to_string (lits).c_str (), lit);
+      antecedent[abs (other)] = other < 0 ? 1 : -1;
+    }
+    Values antecedent_value = [&] (int var) {
+      if (fixed[var])
+        return int (values[var]);
+      auto it = antecedent.find (var);
+      return it == antecedent.end () ? 0 : it->second;
+    };
+    for (auto &operation : operations_by_var[abs (lit)]) {
+      vector<int> derived;
+      if (reference.derive (operation, antecedent_value, derived, false) ||
+          find (derived.begin (), derived.end (), lit) != derived.end ()) {
+        counters->reasons_by_enumeration++;
+        return;
+      }
+    }
+
+    // Not from a single operation (such as the units of the XOR matrix)
+    check_by_encoding (lits, "reason");
+  }
+
+  // Count what the reference derives from the current assignment but was
+  // not propagated before deciding.  This is not an error, since the
+  // propagator only revisits an operation if one of its inputs or its
+  // main output changed and thus misses some carry propagations.
+  void count_missed () {
+#if !ADAPTIVE_PROP
+    if (!opts.complete)
+      return;
+    Values current = [&] (int var) { return int (values[var]); };
+    for (auto &operation : operations) {
+      vector<int> derived;
+      if (!reference.derive (operation, current, derived, true))
+        counters->missed_propagations += derived.size ();
+    }
+#endif
+  }
+
+public:
+  Checker (CaDiCaL::ExternalPropagator *propagator, mt19937_64 &random,
+           double decide_probability)
+      : propagator (propagator), random (random),
+        decide_probability (decide_probability), values (MAX_VAR_ID),
+        fixed (MAX_VAR_ID) {
+    is_lazy = propagator->is_lazy;
+  }
+
+  // Copy the encoding generated in the solver and index its variables and
+  // operations (before solving)
+  void start (CaDiCaL::Solver *solver) {
+    struct : CaDiCaL::ClauseIterator {
+      CaDiCaL::Solver *encoding;
+      bool clause (const vector<int> &lits) {
+        for (auto &lit : lits)
+          encoding->add (lit);
+        encoding->add (0);
+        return true;
+      }
+    } copy;
+    encoding = copy.encoding = new CaDiCaL::Solver;
+    solver->traverse_clauses (copy);
+
+    for (int var = 1; var <= solver->vars (); var++) {
+      // Units aren't traversed
+      if (int unit = solver->fixed (var)) {
+        encoding->add (unit > 0 ? var : -var);
+        encoding->add (0);
+        values[var] = unit;
+        fixed[var] = true;
+      }
+      if (Propagator::state.vars_info[var].word != NULL)
+        word_vars.push_back (var);
+    }
+
+    auto &state = Propagator::state;
+    for (int step = 0; step < state.order; step++)
+      for (int op_id = 0; op_id < NUM_OPS; op_id++) {
+        if (!state.operations[step].inputs_by_op_id[op_id])
+          continue;
+        for (int pos = 0; pos < 32; pos++) {
+          Operation operation = {OperationId (op_id), step, pos};
+          operations.push_back (operation);
+          for (auto &bit : Reference::bits (operation))
+            for (auto &var : bit.vars)
+              if (!fixed[var])
+                operations_by_var[var].push_back (operation);
+        }
+      }
+  }
+
+  ~Checker () { delete encoding; }
+
+  void notify_assignment (int lit, bool is_fixed) {
+    values[abs (lit)] = lit > 0 ? 1 : -1;
+    if (is_fixed)
+      fixed[abs (lit)] = true;
+    else
+      trail.back ().push_back (lit);
+    propagator->notify_assignment (lit, is_fixed);
+  }
+
+  void notify_new_decision_level () {
+    trail.push_back ({});
+    propagator->notify_new_decision_level ();
+  }
+
+  void notify_backtrack (size_t new_level) {
+    while (trail.size () > new_level + 1) {
+      for (auto &lit : trail.back ()) {
+        if (!fixed[abs (lit)])
+          values[abs (lit)] = 0;
+        reasons.erase (lit);
+      }
+      trail.pop_back ();
+    }
+    propagator->notify_backtrack (new_level);
+  }
+
+  bool cb_check_found_model (const vector<int> &model) {
+    return propagator->cb_check_found_model (model);
+  }
+
+  bool cb_has_external_clause () {
+    return propagator->cb_has_external_clause ();
+  }
+
+  int cb_add_external_clause_lit () {
+    int lit = propagator->cb_add_external_clause_lit ();
+    if (lit) {
+      clause.push_back (lit);
+      return lit;
+    }
+    counters->blocking_clauses++;
+    check_clause (clause, "blocking clause");
+    check_by_encoding (clause, "blocking clause");
+    clause.clear ();
+    return 0;
+  }
+
+  int cb_decide () {
+    counters->decisions++;
+    count_missed ();
+    uniform_real_distribution<double> coin (0, 1);
+    if (coin (random) < decide_probability)
+      for (int tries = 0; tries < 32 && !word_vars.empty (); tries++) {
+        int var = word_vars[random () % word_vars.size ()];
+        if (values[var])
+          continue;
+        counters->random_decisions++;
+        return random () & 1 ? var : -var;
+      }
+    return propagator->cb_decide ();
+  }
+
+  int cb_propagate () {
+    int lit = propagator->cb_propagate ();
+    if (!lit)
+      return 0;
+    counters->propagations++;
+    vector<int> lits;
+    while (int other = propagator->cb_add_reason_clause_lit (lit))
+      lits.push_back (other);
+    check_reason (lit, lits);
+    reasons[lit] = {lits, 0};
+    return lit;
+  }
+
+  bool cb_is_dirty () { return propagator->cb_is_dirty (); }
+
+  int cb_add_reason_clause_lit (int propagated_lit) {
+    auto it = reasons.find (propagated_lit);
+    if (it == reasons.end ())
+      return 0;
+    auto &lits = it->second.first;
+    auto &pos = it->second.second;
+    if (pos < lits.size ())
+      return lits[pos++];
+    reasons.erase (it);
+    return 0;
+  }
+};
+
+/*------------------------------------------------------------------------*/
+
+// A random partial characteristic, without a difference before the first
+// step like a collision
+static void write_characteristic (FILE *file, int steps,
+                                  mt19937_64 &random) {
+  static const char symbols[] = "------x01un??????????";
+  auto word = [&] (bool no_difference) {
+    string chars;
+    for (int i = 0; i < 32; i++)
+      chars += no_difference ? '-'
+                             : symbols[random () % (sizeof symbols - 1)];
+    return chars;
+  };
+  for (int i = -4; i < steps; i++) {
+    fprintf (file, "%d %s %s", i, word (i < 0).c_str (),
+             word (i < 0).c_str ());
+    if (i >= 0)
+      fprintf (file, " %s", word (false).c_str ());
+    fputc ('\n', file);
+  }
+}
+
+// Runs in a child process and exits with a non-zero status on failure
+static void run_case (uint64_t seed) {
+  mt19937_64 random (seed);
+  int steps = 1 + random () % opts.steps;
+  char path[] = "/tmp/sha256-mbt-XXXXXX";
+  int fd = mkstemp (path);
+  FILE *file = fd < 0 ? 0 : fdopen (fd, "w");
+  if (!file)
+    die ("can not write characteristic '%s'", path);
+  write_characteristic (file, steps, random);
+  fclose (file);
+  string spec = std::to_string (steps) + (IS_4BIT ? ",4bit," : ",1bit,") +
+                path;
+
+  CaDiCaL::Solver *solver = new CaDiCaL::Solver;
+  solver->set ("seed", random () % 1000);
+  solver->set ("phase", random () & 1);
+  solver->set ("chrono", random () % 3);
+  solver->set ("restartint", 1 + random () % 50);
+  static const double decide_probabilities[] = {0, 0.1, 0.5, 1};
+  Propagator *propagator = new Propagator (solver);
+  Checker *checker =
+      new Checker (propagator, random, decide_probabilities[random () % 4]);
+  solver->connect_external_propagator (checker);
+  const char *err = generate_encoding (solver, spec.c_str ());
+  unlink (path);
+  if (err)
+    die ("%s", err);
+  checker->start (solver);
+  solver->limit ("conflicts", opts.conflicts);
+  solver->solve ();
+
+  delete propagator;
+  delete checker;
+  delete solver;
+  exit (0);
+}
+
+/*------------------------------------------------------------------------*/
+
+int main (int argc, char **argv) {
+  bool has_seed = false, has_cases = false;
+  uint64_t first_seed = 0;
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    auto number = [&] () {
+      if (i + 1 == argc || atoi (argv[i + 1]) <= 0)
+        die ("expected a positive number after '%s'", arg);
+      return atoi (argv[++i]);
+    };
+    if (!strcmp (arg, "-h")) {
+      fputs (usage, stdout);
+      return 0;
+    } else if (!strcmp (arg, "-v"))
+      opts.verbose = true;
+    else if (!strcmp (arg, "-n"))
+      opts.cases = number (), has_cases = true;
+    else if (!strcmp (arg, "-m"))
+      opts.steps = number ();
+    else if (!strcmp (arg, "-c"))
+      opts.conflicts = number ();
+    else if (!strcmp (arg, "-k"))
+      opts.encoding_conflicts = number ();
+    else if (!strcmp (arg, "--complete"))
+      opts.complete = true;
+    else if (arg[0] == '-' || has_seed)
+      die ("invalid argument '%s' (try '-h')", arg);
+    else {
+      char *end;
+      first_seed = strtoull (arg, &end, 10);
+      if (!*arg || *end)
+        die ("invalid seed '%s'", arg);
+      has_seed = true;
+    }
+  }
+  if (has_seed && !has_cases)
+    opts.cases = 1;
+  if (!has_seed)
+    first_seed = uint64_t (time (0)) * 1000 + getpid () % 1000;
+  if (opts.steps > 64)
+    die ("at most 64 steps");
+
+  counters = (Counters *) mmap (0, sizeof (Counters),
+                                PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (counters == MAP_FAILED)
+    die ("can not map the counters");
+  memset (counters, 0, sizeof (Counters));
+
+  int failed = 0;
+  for (int i = 0; i < opts.cases; i++) {
+    uint64_t seed = first_seed + i;
+    fflush (stdout);
+    pid_t child = fork ();
+    if (child < 0)
+      die ("can not fork");
+    if (!child) {
+      if (opts.verbose)
+        setvbuf (stdout, 0, _IOLBF, 0);
+      else if (!freopen ("/dev/null", "w", stdout))
+        die ("can not redirect the output");
+      run_case (seed);
+    }
+    int status;
+    waitpid (child, &status, 0);
+    if (WIFEXITED (status) && !WEXITSTATUS (status))
+      continue;
+    failed++;
+    if (WIFSIGNALED (status))
+      printf ("case %d with seed %" PRIu64 " failed with signal %d\n", i,
+              seed, WTERMSIG (status));
+    else
+      printf ("case %d with seed %" PRIu64 " failed\n", i, seed);
+  }
+
+  printf ("%d of %d cases failed (seeds %" PRIu64 " to %" PRIu64 ")\n",
+          failed, opts.cases, first_seed, first_seed + opts.cases - 1);
+  printf ("%" PRIu64 " propagations and %" PRIu64
+          " blocking clauses checked\n",
+          counters->propagations, counters->blocking_clauses);
+  printf ("%" PRIu64 " reasons derived by the reference, %" PRIu64
+          " clauses implied by the encoding, %" PRIu64 " inconclusive\n",
+          counters->reasons_by_enumeration, counters->clauses_by_encoding,
+          counters->clauses_inconclusive);
+  printf ("%" PRIu64 " decisions (%" PRIu64 " random)\n",
+          counters->decisions, counters->random_decisions);
+  if (opts.complete)
+    printf ("%" PRIu64 " propagations missed before decisions\n",
+            counters->missed_propagations);
+  return failed != 0;
+}
+#else
+int main () {
+  fputs ("sha256-mbt: error: only the 1-bit and 4-bit encodings can be "
+         "generated\n",
+         stderr);
+  return 1;
+}
+#endif